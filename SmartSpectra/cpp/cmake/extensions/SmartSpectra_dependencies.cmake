@@ -25,6 +25,16 @@ if (LINUX)
     find_package(V4L REQUIRED)
 endif ()
 
+if (ENABLE_TURBOJPEG)
+    find_package(PkgConfig)
+    if (PkgConfig_FOUND)
+        pkg_check_modules(TurboJpeg IMPORTED_TARGET libturbojpeg)
+    endif ()
+    if (NOT TurboJpeg_FOUND)
+        message(STATUS "Unable to find libjpeg-turbo, MJPEG camera frames will be decoded with OpenCV instead.")
+    endif ()
+endif ()
+
 # PhysiologyEdge does not support GPU on Apple machines yet
 if (NOT APPLE AND ENABLE_GPU)
     find_package(OpenGL REQUIRED OpenGL GLES3)
@@ -40,6 +40,10 @@ set(CPACK_DEBIAN_PACKAGE_SHLIBDEPS TRUE)
 string(CONCAT PHYSIOLOGY_EDGE_DEB_PACKAGE "libphysiologyedge-dev (>= " ${CPACK_PACKAGE_VERSION} ")")
 
 set(CPACK_DEBIAN_PACKAGE_DEPENDS ${PHYSIOLOGY_EDGE_DEB_PACKAGE})
+if (TurboJpeg_FOUND)
+    # headers & pkg-config file are needed to consume the static camera library
+    string(APPEND CPACK_DEBIAN_PACKAGE_DEPENDS ", libturbojpeg0, libturbojpeg0-dev")
+endif ()
 
 set(CPACK_DEBIAN_PACKAGE_CONFLICTS "${CPACK_PACKAGE_NAME}")
 set(CPACK_DEBIAN_PACKAGE_REPLACES "${CPACK_PACKAGE_NAME}")
@@ -0,0 +1,49 @@
+// stdlib includes
+#include <string>
+
+// third-party includes
+#include <absl/flags/flag.h>
+#include <absl/flags/parse.h>
+#include <absl/flags/usage.h>
+#include <glog/logging.h>
+#include <smartspectra/video_source/camera/frame_timestamp_file.hpp>
+
+namespace capture = presage::smartspectra::video_source::capture;
+
+ABSL_FLAG(std::string, input_path, "",
+          "Full path of the frame timestamp file to convert: text with one timestamp (in milliseconds) per line, "
+          "or a binary frame timestamp sidecar.");
+ABSL_FLAG(std::string, output_path, "",
+          "Full path of the binary frame timestamp sidecar to write, which can then be passed to the example apps "
+          "via --input_video_time_path.");
+
+int main(int argc, char** argv) {
+    google::InitGoogleLogging(argv[0]);
+    FLAGS_alsologtostderr = true;
+
+    absl::SetProgramUsageMessage(
+        "Convert per-frame timestamps of a prerecorded video into a compact binary frame timestamp sidecar, which "
+        "loads much faster than text for long recordings."
+    );
+    absl::ParseCommandLine(argc, argv);
+
+    const std::string input_path = absl::GetFlag(FLAGS_input_path);
+    const std::string output_path = absl::GetFlag(FLAGS_output_path);
+    if (input_path.empty() || output_path.empty()) {
+        LOG(ERROR) << "Both --input_path and --output_path are required.";
+        return EXIT_FAILURE;
+    }
+
+    auto timestamps = capture::ReadFrameTimestampFile(input_path);
+    if (!timestamps.ok()) {
+        LOG(ERROR) << "Reading failed. " << timestamps.status().message();
+        return EXIT_FAILURE;
+    }
+    auto status = capture::WriteFrameTimestampSidecar(output_path, *timestamps);
+    if (!status.ok()) {
+        LOG(ERROR) << "Writing failed. " << status.message();
+        return EXIT_FAILURE;
+    }
+    LOG(INFO) << "Wrote " << timestamps->size() << " frame timestamps to " << output_path << ".";
+    return EXIT_SUCCESS;
+}
@@ -53,12 +53,16 @@ ABSL_FLAG(bool, auto_lock, true,
           "If false, doesn't do this automatically.");
 ABSL_FLAG(vs::InputTransformMode, input_transform_mode, vs::InputTransformMode::Unspecified_EnumEnd,
           absl::StrCat("Video input transformation mode. Possible values: ", vs::kInputTransformModeNameList));
+ABSL_FLAG(bool, v4l2_streaming, false,
+          "(Linux only) If true, capture from the camera through V4L2 memory-mapped streaming directly, "
+          "using the driver's frame timestamps, instead of going through OpenCV.");
 ABSL_FLAG(std::string, input_video_path, "",
           "Full path of video to load. Signifies prerecorded video mode will be used. When not provided, "
           "the app will attempt to use a webcam / stream.");
 ABSL_FLAG(std::string, input_video_time_path, "",
           "Full path of video timestamp txt file, "
-          "where each row represents the timestamp of each frame in milliseconds.");
+          "where each row represents the timestamp of each frame in milliseconds. "
+          "Binary frame timestamp sidecars are accepted as well.");
 // endregion ===========================================================================================================
 // region ======================== GUI / INTERACTION SETTINGS ==========================================================
 ABSL_FLAG(bool, headless, false, "If true, no GUI will be displayed.");
@@ -66,7 +70,24 @@ ABSL_FLAG(bool, also_log_to_stderr, false, "If true, log to stderr as well.");
 ABSL_FLAG(int, interframe_delay, 20,
           "Delay, in milliseconds, before capturing the next frame: "
           "higher values may free more CPU resources for the graph, giving it more time to process what it already has "
-          "and drop fewer frames, resulting in more robust output metrics.");
+          "and drop fewer frames, resulting in more robust output metrics. Ignored when --target_fps is set.");
+ABSL_FLAG(double, target_fps, 0.0,
+          "Maximum frame capture rate, in frames per second. When not positive, the rate is derived from "
+          "--interframe_delay. The actual rate is lowered automatically while the graph is dropping frames.");
+ABSL_FLAG(bool, fast_replay, false,
+          "(Prerecorded video only) If true, feed frames to the graph as fast as it takes them in, instead of at "
+          "--target_fps / --interframe_delay pace, keeping the timestamps from the video.");
+ABSL_FLAG(int, frame_queue_capacity, 4,
+          "Capacity of the queue between frame capture and frame processing. "
+          "Larger values absorb longer processing spikes at the cost of added latency.");
+ABSL_FLAG(settings::FrameQueueOverflowPolicy, frame_queue_overflow_policy,
+          settings::FrameQueueOverflowPolicy::Unknown_EnumEnd,
+          "What to do with a newly captured frame when the frame queue is full. "
+          "'auto' blocks for prerecorded input and drops the oldest queued frame for live cameras. Possible values: "
+          + absl::StrJoin(settings::GetFrameQueueOverflowPolicyNames(), ", "));
+ABSL_FLAG(std::string, metrics_export_address, "",
+          "Collect hot-path metrics and serve them as OpenMetrics text over HTTP at this address: "
+          "'<host>:<port>', '<port>' (on localhost), or 'unix:<socket path>'. Empty disables metrics.");
 ABSL_FLAG(bool,
           start_with_recording_on,
           false,
@@ -79,9 +100,19 @@ ABSL_FLAG(int, start_time_offset_ms, 0,
 // region ======================== GRAPH INTERNAL SETTINGS =============================================================
 ABSL_FLAG(bool, scale_input, true,
           "If true, uses input scaling in the ImageTransformationCalculator within the graph.");
+ABSL_FLAG(bool, pre_scale_input, false,
+          "If true (and --scale_input is on), downscale camera/video frames to the graph's input size with an area "
+          "filter while sending them into the graph, instead of sending them in at full size. Cuts per-frame memory "
+          "traffic for high-resolution input, but the graph's output video gets the downscaled size (face landmarks in "
+          "edge & core metrics still come in full-size frame coordinates). MJPEG frames from V4L2 streaming capture "
+          "then also get decoded at 1/2 or 1/4 scale where that still covers the graph's input size.");
 ABSL_FLAG(bool, enable_phasic_bp, false, "If true, enable the phasic blood pressure computation.");
 ABSL_FLAG(bool, enable_eda, false, "If true, enable the electrodermal activity computation.");
 ABSL_FLAG(bool, enable_dense_facemesh_points, false, "If true, enable dense face mesh points output.");
+ABSL_FLAG(bool, crop_to_face, false,
+          "If true, send only the region around the tracked face (and chest) into the graph instead of full frames, "
+          "falling back to full frames whenever the face is lost. Requires --enable_edge_metrics and "
+          "--enable_dense_facemesh_points; the graph's output video shows the cropped region.");
 ABSL_FLAG(bool, use_full_range_face_detection, false, "If true, uses the full range face detection model.");
 ABSL_FLAG(bool, use_full_pose_landmarks, false, "If true, uses the full pose landmarks model.");
 ABSL_FLAG(bool, enable_pose_landmark_segmentation, false, "If true, enables pose landmark segmentation.");
@@ -391,17 +422,17 @@ absl::Status RunRestContinuousEdge(
     if (enable_framerate_diagnostics) {
         MP_RETURN_IF_ERROR(container.SetOnCorePerformanceTelemetry(
             [&effective_core_throughput, &effective_core_latency, &enable_hud](
-                double effective_core_fps,
-                double effective_core_latency_seconds,
-                int64_t timestamp_microseconds
+                const spectra::container::CorePerformanceTelemetry& telemetry
             ) {
                 if (!enable_hud) {
-                    std::cout << "Effective Edge+Core Throughput: " << effective_core_fps << " FPS / HZ " << std::endl;
-                    std::cout << "Effective Edge+Core Latency: " << effective_core_latency_seconds << " seconds"
-                              << std::endl;
+                    std::cout << "Effective Edge+Core Throughput: " << telemetry.fps << " FPS / HZ " << std::endl;
+                    std::cout << "Effective Edge+Core Latency: " << telemetry.mean_latency_seconds << " seconds (p50: "
+                              << telemetry.p50_latency_seconds << ", p95: " << telemetry.p95_latency_seconds
+                              << ", p99: " << telemetry.p99_latency_seconds << ", max: "
+                              << telemetry.max_latency_seconds << ")" << std::endl;
                 } else {
-                    effective_core_throughput = effective_core_fps;
-                    effective_core_latency = effective_core_latency_seconds;
+                    effective_core_throughput = telemetry.fps;
+                    effective_core_latency = telemetry.mean_latency_seconds;
                 }
                 return absl::OkStatus();
             }
@@ -501,6 +532,24 @@ int main(int argc, char** argv) {
         absl::GetFlag(FLAGS_print_graph_contents),
         absl::GetFlag(FLAGS_log_transfer_timing_info),
         absl::GetFlag(FLAGS_verbosity),
+        settings::ImageFramePoolSettings{},
+        settings::FramePipelineSettings{
+            absl::GetFlag(FLAGS_frame_queue_capacity),
+            absl::GetFlag(FLAGS_frame_queue_overflow_policy)
+        },
+        settings::FramePacingSettings{
+            absl::GetFlag(FLAGS_target_fps),
+            absl::GetFlag(FLAGS_fast_replay)
+        },
+        settings::MetricsSettings{
+            !absl::GetFlag(FLAGS_metrics_export_address).empty(),
+            absl::GetFlag(FLAGS_metrics_export_address)
+        },
+        settings::GraphExecutorSettings{},
+        settings::RoiCropSettings{
+            absl::GetFlag(FLAGS_crop_to_face)
+        },
+        absl::GetFlag(FLAGS_pre_scale_input),
         settings::ContinuousSettings{
             absl::GetFlag(FLAGS_buffer_duration)
         },
@@ -513,6 +562,7 @@ int main(int argc, char** argv) {
 #endif
         }
     };
+    settings.video_source.v4l2_streaming = absl::GetFlag(FLAGS_v4l2_streaming);
 
     absl::Status status = RunRestContinuousEdge(settings);
 
@@ -20,6 +20,8 @@
 
 #pragma once
 // === standard library includes (if any) ===
+#include <functional>
+#include <span>
 // === third-party includes (if any) ===
 #include <mediapipe/framework/port/opencv_core_inc.h>
 // === local includes (if any) ===
@@ -42,6 +44,17 @@ public:
     typedef container::settings::Settings<TOperationMode, TIntegrationMode> SettingsType;
     using Base = Container<TDeviceType, TOperationMode, TIntegrationMode>;
 
+    /** A frame for AddFrames. */
+    struct FrameInput {
+        // 8-bit RGB(A) or grayscale frame
+        cv::Mat frame_rgb;
+        // frame timestamp in microseconds; preferably, should be based on camera's own shutter clock
+        int64_t timestamp_μs = 0;
+        // if set, the frame (which then has to be 3-channel RGB) is handed to the graph without copying, and this is
+        // invoked once the graph is done with it (see the caller-owned-buffer AddFrameWithTimestamp overload)
+        std::function<void()> release_frame = nullptr;
+    };
+
     /** Construct a background container with the provided settings. */
     explicit BackgroundContainer(SettingsType settings);
 
@@ -64,6 +77,22 @@ public:
     /** Feed a frame into the graph with an explicit timestamp. */
     absl::Status AddFrameWithTimestamp(const cv::Mat& frame_rgb, int64_t frame_timestamp_μs);
 
+    /**
+     * Feed a caller-owned RGB frame into the graph without copying it.
+     * The pixel buffer must stay valid & unmodified until release_frame is invoked. release_frame is invoked exactly
+     * once, from whichever thread drops the last reference to the frame (possibly a graph thread), or before
+     * returning if the frame could not be added.
+     */
+    absl::Status AddFrameWithTimestamp(
+        const cv::Mat& frame_rgb, int64_t frame_timestamp_μs, std::function<void()> release_frame
+    );
+
+    /**
+     * Feed several frames into the graph, in order, checking the container state only once.
+     * Release callbacks are invoked exactly once either way, i.e. also for frames that could not be added.
+     */
+    absl::Status AddFrames(std::span<const FrameInput> frames);
+
     /** Register callback invoked with Bluetooth timestamps from the graph. */
     absl::Status SetOnBluetoothCallback(std::function<absl::Status(double)> on_bluetooth);
 
@@ -77,6 +106,18 @@ public:
     absl::Status StopGraph();
 
 private:
+    /** Check that frames can currently be added. */
+    absl::Status CheckCanAddFrames() const;
+    /**
+     * Send an ingested frame, along with the recording state, into the graph.
+     * @param added_frame_size size of the frame as it was added, before any pre-scaling
+     */
+    absl::Status FeedFrame(
+        std::unique_ptr<mediapipe::ImageFrame> input_frame,
+        int64_t frame_timestamp_μs,
+        const cv::Size& added_frame_size
+    );
+
     physiology::StatusCode previous_status_code = physiology::StatusCode::PROCESSING_NOT_STARTED;
 };
 
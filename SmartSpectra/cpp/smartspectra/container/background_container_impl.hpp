@@ -97,8 +97,13 @@ absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
         physiology::edge::graph::output_streams::kMetricsBuffer,
         [this](const mediapipe::Packet& output_packet) -> absl::Status {
             if (!output_packet.IsEmpty()) {
+                ScopedTimer callback_timer(this->metrics.callback_seconds);
                 auto metrics_buffer = output_packet.Get<physiology::MetricsBuffer>();
                 auto timestamp = output_packet.Timestamp();
+                if (this->graph_input_scaling.has_value() && metrics_buffer.has_face()) {
+                    // landmarks come out in the coordinates of the pre-scaled frames, consumers get full-size ones
+                    this->ingested_frame_map.MapLandmarks(*metrics_buffer.mutable_face(), timestamp.Value());
+                }
                 MP_RETURN_IF_ERROR(this->ComputeCorePerformanceTelemetry(metrics_buffer));
                 return this->OnCoreMetricsOutput(metrics_buffer, timestamp.Value());
             }
@@ -117,6 +122,11 @@ absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
                 [this](const mediapipe::Packet& output_packet) {
                     if (!output_packet.IsEmpty()) {
                         auto metrics_buffer = output_packet.Get<physiology::Metrics>();
+                        if (this->graph_input_scaling.has_value() && metrics_buffer.has_face()) {
+                            this->ingested_frame_map.MapLandmarks(
+                                *metrics_buffer.mutable_face(), output_packet.Timestamp().Value()
+                            );
+                        }
                         return this->OnEdgeMetricsOutput(metrics_buffer);
                     }
                     return absl::OkStatus();
@@ -130,13 +140,20 @@ absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
         physiology::edge::graph::output_streams::kOutputVideo,
         [this](const mediapipe::Packet& output_video_packet) -> absl::Status {
             if (!output_video_packet.IsEmpty()) {
+                if (!this->video_output_callback_set) {
+                    // nobody's listening, skip retrieval & conversion altogether
+                    return absl::OkStatus();
+                }
+                ScopedTimer callback_timer(this->metrics.callback_seconds);
                 cv::Mat output_frame_rgb;
                 MP_RETURN_IF_ERROR(it::GetFrameFromPacket<TDeviceType>(output_frame_rgb,
                                                                        this->device_context,
                                                                        output_video_packet));
-                // Convert to BGR and display.
-                cv::cvtColor(output_frame_rgb, this->output_frame_bgr, cv::COLOR_RGB2BGR);
                 auto timestamp = output_video_packet.Timestamp();
+                if (this->video_output_pixel_format == video_source::PixelFormat::RGB) {
+                    return this->OnVideoOutput(output_frame_rgb, timestamp.Value());
+                }
+                cv::cvtColor(output_frame_rgb, this->output_frame_bgr, cv::COLOR_RGB2BGR);
                 return this->OnVideoOutput(this->output_frame_bgr, timestamp.Value());
             }
             return absl::OkStatus();
@@ -149,6 +166,9 @@ absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
         [this](const mediapipe::Packet& output_packet) {
            if (!output_packet.IsEmpty()) {
                bool frame_sent_through = output_packet.Get<bool>();
+               if (!frame_sent_through && this->metrics.frames_dropped_by_graph != nullptr) {
+                   this->metrics.frames_dropped_by_graph->Increment();
+               }
                auto timestamp = output_packet.Timestamp();
                return this->OnFrameSentThrough(frame_sent_through, timestamp.Value());
            }
@@ -186,50 +206,126 @@ absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
     return absl::OkStatus();
 }
 
-/**
- * Adds frame input to graph. Also, updates the recording status within the graph based on internal state of the container
- * (i.e. recording / not recording)
- * @tparam TDeviceType
- * @tparam TOperationMode
- * @tparam TIntegrationMode
- * @param frame
- * @param frame_timestamp_μs frame timestamp in microseconds; preferably, should be based on camera's own shutter clock
- * @return status of the operation
- */
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
-absl::Status BackgroundContainer<TDeviceType,
-    TOperationMode,
-    TIntegrationMode>::AddFrameWithTimestamp(const cv::Mat& frame_rgb, int64_t frame_timestamp_μs) {
+absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::CheckCanAddFrames() const {
     if (!this->initialized) {
         return absl::FailedPreconditionError("Container not initialized.");
     }
     if (!this->running) {
         return absl::FailedPreconditionError("Graph not started.");
     }
-    // Wrap Mat into an ImageFrame.
-    auto input_frame = absl::make_unique<mediapipe::ImageFrame>(
-        mediapipe::ImageFormat::SRGB, frame_rgb.cols, frame_rgb.rows,
-        mediapipe::ImageFrame::kDefaultAlignmentBoundary
-    );
-    cv::Mat input_frame_mat = mediapipe::formats::MatView(input_frame.get());
-    // transfer camera_frame data to input_frame
-    frame_rgb.copyTo(input_frame_mat);
+    return absl::OkStatus();
+}
 
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::FeedFrame(
+    std::unique_ptr<mediapipe::ImageFrame> input_frame,
+    int64_t frame_timestamp_μs,
+    const cv::Size& added_frame_size
+) {
     auto frame_timestamp = mediapipe::Timestamp(frame_timestamp_μs);
+    if (this->graph_input_scaling.has_value()) {
+        // every frame gets recorded: frames handed over without copying go in at full size
+        this->ingested_frame_map.RecordIngestedFrame(
+            frame_timestamp_μs, cv::Rect(cv::Point(0, 0), added_frame_size),
+            cv::Size(input_frame->Width(), input_frame->Height())
+        );
+    }
     this->AddFrameTimestampToBenchmarkingInfo(frame_timestamp);
+    ScopedTimer feed_timer(this->metrics.feed_seconds);
     // Send recording state to the graph.
-    MP_RETURN_IF_ERROR(
-        this->graph
-            .AddPacketToInputStream(
-                pe::graph::input_streams::kRecording,
-                mediapipe::MakePacket<bool>(this->recording).At(frame_timestamp)
-            )
-    );
+    MP_RETURN_IF_ERROR(this->graph.AddPacketToInputStream(
+        pe::graph::input_streams::kRecording, this->GetRecordingPacket(frame_timestamp)
+    ));
     // Send image packet into the graph.
     MP_RETURN_IF_ERROR(
         it::FeedFrameToGraph(std::move(input_frame), this->graph, this->device_context, frame_timestamp_μs,
                              pe::graph::input_streams::kInputVideo)
     );
+    feed_timer.Stop();
+    if (this->metrics.frames_fed != nullptr) {
+        this->metrics.frames_fed->Increment();
+    }
+    return absl::OkStatus();
+}
+
+/**
+ * Adds frame input to graph. Also, updates the recording status within the graph based on internal state of the container
+ * (i.e. recording / not recording)
+ * @tparam TDeviceType
+ * @tparam TOperationMode
+ * @tparam TIntegrationMode
+ * @param frame
+ * @param frame_timestamp_μs frame timestamp in microseconds; preferably, should be based on camera's own shutter clock
+ * @return status of the operation
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status BackgroundContainer<TDeviceType,
+    TOperationMode,
+    TIntegrationMode>::AddFrameWithTimestamp(const cv::Mat& frame_rgb, int64_t frame_timestamp_μs) {
+    MP_RETURN_IF_ERROR(this->CheckCanAddFrames());
+    // Transfer frame data directly into the ImageFrame that gets sent to the graph.
+    MP_ASSIGN_OR_RETURN(auto input_frame, this->IngestFrame(frame_rgb, false));
+    return this->FeedFrame(std::move(input_frame), frame_timestamp_μs, frame_rgb.size());
+}
+
+/**
+ * Adds caller-owned frame input to graph without copying the pixel data.
+ * @param frame_rgb 8-bit, 3-channel RGB frame
+ * @param frame_timestamp_μs frame timestamp in microseconds; preferably, should be based on camera's own shutter clock
+ * @param release_frame invoked exactly once when the pixel buffer of the frame is no longer needed
+ * @return status of the operation
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::AddFrameWithTimestamp(
+    const cv::Mat& frame_rgb,
+    int64_t frame_timestamp_μs,
+    std::function<void()> release_frame
+) {
+    // adopt the buffer first, so that it's released on any failure below
+    MP_ASSIGN_OR_RETURN(auto input_frame, it::WrapInImageFrame(frame_rgb, std::move(release_frame)));
+    MP_RETURN_IF_ERROR(this->CheckCanAddFrames());
+    return this->FeedFrame(std::move(input_frame), frame_timestamp_μs, frame_rgb.size());
+}
+
+/**
+ * Adds a batch of frames to graph, in order. Frames with a release callback are handed to the graph without copying.
+ * On failure, frames after the failing one are not added. Release callbacks are still invoked exactly once for every
+ * frame, i.e. also for the failing frame and the ones after it, as if each had gone through AddFrameWithTimestamp.
+ * @param frames frames to add
+ * @return status of the operation
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status BackgroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::AddFrames(
+    std::span<const FrameInput> frames
+) {
+    // frames from first_unadopted_frame onward haven't been handed to the graph (nor released) yet
+    auto release_unadopted_frames = [&frames](size_t first_unadopted_frame) {
+        for (size_t i_frame = first_unadopted_frame; i_frame < frames.size(); i_frame++) {
+            if (frames[i_frame].release_frame != nullptr) {
+                frames[i_frame].release_frame();
+            }
+        }
+    };
+    if (absl::Status status = this->CheckCanAddFrames(); !status.ok()) {
+        release_unadopted_frames(0);
+        return status;
+    }
+    for (size_t i_frame = 0; i_frame < frames.size(); i_frame++) {
+        const FrameInput& frame = frames[i_frame];
+        // once wrapped, the frame's buffer is released by the wrapper (also if wrapping or feeding fails)
+        absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> input_frame =
+            frame.release_frame != nullptr ? it::WrapInImageFrame(frame.frame_rgb, frame.release_frame)
+                                           : this->IngestFrame(frame.frame_rgb, false);
+        absl::Status status = input_frame.status();
+        if (status.ok()) {
+            status = this->FeedFrame(std::move(input_frame).value(), frame.timestamp_μs, frame.frame_rgb.size());
+        }
+        if (!status.ok()) {
+            release_unadopted_frames(i_frame + 1);
+            return status;
+        }
+    }
     return absl::OkStatus();
 }
 
@@ -24,10 +24,15 @@
 // === standard library includes ===
 #include <functional>
 #include <filesystem>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
 // === third-party includes (if any) ===
 #include <absl/status/status.h>
 #include <absl/status/statusor.h>
 #include <mediapipe/framework/calculator_graph.h>
+#include <mediapipe/framework/formats/image_frame.h>
 #include <mediapipe/framework/port/opencv_core_inc.h>
 #include <physiology/modules/device_type.h>
 #include <physiology/modules/device_context.h>
@@ -36,6 +41,14 @@
 // === local includes (if any) ===
 #include "settings.hpp"
 #include "operation_context.hpp"
+#include "image_frame_pool.hpp"
+#include "graph_input_scaling.hpp"
+#include "ingested_frame_map.hpp"
+#include "core_performance_telemetry.hpp"
+#include "metrics_registry.hpp"
+#include "metrics_exporter.hpp"
+#include <smartspectra/video_source/pixel_format.hpp>
+#include <smartspectra/video_source/input_transform.hpp>
 
 /**
  * @defgroup container Containers
@@ -49,6 +62,18 @@
 /** Primary namespace for Container classes and related helpers */
 namespace presage::smartspectra::container {
 
+/**
+ * @brief Counters describing how input frames were transferred into graph-ready buffers.
+ */
+struct FrameIngestionStatistics {
+    /** Total number of frames converted into graph input buffers. */
+    int64_t frames_ingested = 0;
+    /** Frames whose color conversion (or copy) wrote straight into the graph buffer in a single pass. */
+    int64_t single_pass_frames = 0;
+    /** Frames that needed an intermediate full-frame buffer before landing in the graph buffer. */
+    int64_t intermediate_copy_frames = 0;
+};
+
 template<
     platform_independence::DeviceType TDeviceType,
     settings::OperationMode TOperationMode,
@@ -91,6 +116,16 @@ public:
         const std::function<absl::Status(cv::Mat& output_frame, int64_t input_timestamp)>& on_video_output
     );
 
+    /**
+     * Set callback invoked with each preprocessed output frame, in the requested pixel format (BGR or RGB).
+     * RGB skips the conversion from the graph's output; the frame then refers to the graph's own output buffer and
+     * must not be modified or kept beyond the callback.
+     */
+    absl::Status SetOnVideoOutput(
+        const std::function<absl::Status(cv::Mat& output_frame, int64_t input_timestamp)>& on_video_output,
+        video_source::PixelFormat output_pixel_format
+    );
+
     /**
      * Set callback used for frame drop diagnostics.
      */
@@ -99,7 +134,14 @@ public:
     );
 
     /**
-     * Set callback for benchmarking effective core FPS and latency.
+     * Set callback for benchmarking effective core FPS and latency (mean, percentiles & maximum).
+     */
+    absl::Status SetOnCorePerformanceTelemetry(
+        const std::function<absl::Status(const CorePerformanceTelemetry&)>& on_core_performance_telemetry
+    );
+
+    /**
+     * Set callback for benchmarking effective core FPS and mean latency.
      */
     absl::Status SetOnCorePerformanceTelemetry(
         const std::function<absl::Status(double, double, int64_t)>& on_effective_core_fps_output
@@ -110,6 +152,21 @@ public:
      */
     virtual absl::Status Initialize();
 
+    /**
+     * Retrieve counters describing how input frames have been transferred into the graph so far.
+     */
+    FrameIngestionStatistics GetFrameIngestionStatistics() const;
+
+    /**
+     * Retrieve usage counters of the pool that recycles input frame pixel buffers.
+     */
+    ImageFramePoolStatistics GetImageFramePoolStatistics() const;
+
+    /**
+     * Retrieve the registry of hot-path metrics (empty unless metrics are enabled in settings).
+     */
+    const MetricsRegistry& GetMetricsRegistry() const;
+
 protected:
     /** Retrieve the suffix used for the optional third graph file. */
     virtual std::string GetThirdGraphFileSuffix() const;
@@ -130,6 +187,67 @@ protected:
     /** Track the timestamp of each frame added to the graph for benchmarking. */
     void AddFrameTimestampToBenchmarkingInfo(const mediapipe::Timestamp& timestamp);
 
+    /**
+     * Convert an input frame to RGB directly inside a graph-ready ImageFrame (recycled from the image frame pool,
+     * if enabled) and update frame ingestion statistics.
+     *
+     * @param frame 8-bit input frame with 1, 3, or 4 channels
+     * @param frame_is_bgr true if the channel order of the frame is BGR(A), false if it is RGB(A)
+     */
+    absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> IngestFrame(const cv::Mat& frame, bool frame_is_bgr);
+
+    /**
+     * Bring an input frame in the given video source pixel format into a graph-ready ImageFrame. RGB frames are
+     * wrapped without copying: the ImageFrame shares (and holds a reference to) the frame's pixel buffer, so the
+     * caller must not write into that buffer afterwards. Other formats are converted as in the overload above.
+     *
+     * @param input_transform input transform still to be applied to the frame (i.e. deferred by the video source),
+     * fused with the conversion for BGR and RGB frames
+     */
+    absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> IngestFrame(
+        const cv::Mat& frame,
+        video_source::PixelFormat pixel_format,
+        video_source::InputTransformMode input_transform = video_source::InputTransformMode::None
+    );
+
+    /** Convert an input frame to RGB with the given OpenCV color conversion code (-1 to copy). */
+    absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ConvertAndIngestFrame(
+        const cv::Mat& frame,
+        int color_conversion_code
+    );
+
+    /**
+     * Downscale an 8-bit, 3-channel frame to the given size (after the input transform) with an area filter, applying
+     * the input transform and bringing it to RGB along the way.
+     */
+    absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ScaleAndIngestFrame(
+        const cv::Mat& frame,
+        video_source::InputTransformMode input_transform,
+        bool frame_is_bgr,
+        const cv::Size& scaled_frame_size
+    );
+
+    /**
+     * Size to pre-scale a 3-channel input frame to, or std::nullopt if input pre-scaling is off or wouldn't shrink it.
+     */
+    std::optional<cv::Size> GetPreScaledInputFrameSize(
+        const cv::Mat& frame,
+        video_source::InputTransformMode input_transform
+    ) const;
+
+    /** Apply the input transform to an 8-bit, 3-channel frame and bring it to RGB in a single pass. */
+    absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> TransformAndIngestFrame(
+        const cv::Mat& frame,
+        video_source::InputTransformMode input_transform,
+        bool frame_is_bgr
+    );
+
+    /**
+     * Packet carrying the current recording state for the kRecording graph input stream. Shares one immutable
+     * payload for each state, so no allocation happens per frame.
+     */
+    mediapipe::Packet GetRecordingPacket(mediapipe::Timestamp timestamp) const;
+
 // ==== settings
 // TODO: maybe figure out how to make `settings` `const` again?
     SettingsType settings;
@@ -153,6 +271,9 @@ protected:
     // if needed, set to a callback that handles video frames after they get preprocessed on the edge / in SDK
     std::function<absl::Status(cv::Mat& output_frame, int64_t input_timestamp)> OnVideoOutput =
         [](cv::Mat& output_frame, int64_t input_timestamp) { return absl::OkStatus(); };
+    // output frames are converted for OnVideoOutput only if a callback was actually set
+    bool video_output_callback_set = false;
+    video_source::PixelFormat video_output_pixel_format = video_source::PixelFormat::BGR;
 
     // if needed, set to a callback that handles frame sent-through-graph / dropped-from-graph events,
     // e.g., logs them somewhere.
@@ -160,7 +281,7 @@ protected:
         [](bool frame_sent_through, int64_t input_timestamp) { return absl::OkStatus(); };
 
     // for benchmarking
-    std::optional<std::function<absl::Status(double fps, double latency_s, int64_t input_timestamp)>>
+    std::optional<std::function<absl::Status(const CorePerformanceTelemetry&)>>
         OnCorePerformanceTelemetry = std::nullopt;
 
     platform_independence::DeviceContext<TDeviceType> device_context;
@@ -168,23 +289,40 @@ protected:
     bool running = false;
 // == dynamic/changing during runtime
     physiology::StatusValue status;
-    bool recording = false;
+    // may be toggled from a different thread than the one feeding frames to the graph
+    std::atomic<bool> recording = false;
 
     // for video output (optional)
     cv::Mat output_frame_bgr;
     OperationContext<TOperationMode> operation_context;
 
+    // recycles pixel buffers of frames sent into the graph
+    ImageFramePool image_frame_pool;
+    // input scaling of the graph that input frames get pre-scaled for, if enabled in settings and found in the graph
+    std::optional<GraphInputScaling> graph_input_scaling;
+    // how the frames sent into the graph map onto the input frames, if they get pre-scaled or (foreground container
+    // only) cropped to the face; used to place face landmarks coming out of the graph back on the input frames
+    IngestedFrameMap ingested_frame_map;
+
+    // hot-path metrics, registered only if enabled in settings
+    MetricsRegistry metrics_registry;
+    ContainerMetrics metrics;
+    std::unique_ptr<OpenMetricsExporter::Registration> metrics_export_registration;
+
 private:
+    // frame ingestion statistics
+    std::atomic<int64_t> frames_ingested = 0;
+    std::atomic<int64_t> single_pass_frames = 0;
+
+    // payloads of recording state packets
+    const mediapipe::Packet recording_on_packet = mediapipe::MakePacket<bool>(true);
+    const mediapipe::Packet recording_off_packet = mediapipe::MakePacket<bool>(false);
+
     // benchmarking
-    std::set<int64_t> frames_in_graph_timestamps;
-    const int64_t fps_averaging_window_microseconds = 3 * 1000000; // 3 seconds
-    struct MetricsBufferBenchmarkingInfo {
-        int64_t first_timestamp = 0;
-        int64_t last_timestamp = 0;
-        int32_t frame_count = 0;
-        double latency_seconds = 0;
-    };
-    std::vector<MetricsBufferBenchmarkingInfo> metrics_buffer_benchmarking_info_buffer;
+    // frames may be fed into the graph and metrics may be received on different threads
+    std::mutex benchmarking_mutex;
+    // bounded memory, no per-frame allocation
+    CorePerformanceTracker core_performance_tracker;
     std::optional<double> offset_from_system_time = std::nullopt;
 };
 
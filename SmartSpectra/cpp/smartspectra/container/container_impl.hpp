@@ -30,11 +30,14 @@
 #include <mediapipe/framework/formats/image_frame_opencv.h>
 #include <physiology/graph/stream_and_packet_names.h>
 // === local includes (if any) ===
+#include <smartspectra/video_source/input_transformer.hpp>
+#include <smartspectra/video_source/input_transform_kernels.hpp>
 #include "container.hpp"
 #include "initialization.hpp"
 #include "image_transfer.hpp"
 #include "packet_helpers.hpp"
 #include "benchmarking.hpp"
+#include "shared_executor.hpp"
 #include "keyboard_input.hpp"
 #include "json_file_io.hpp"
 
@@ -47,6 +50,7 @@ namespace keys = keyboard_input;
 namespace ph = packet_helpers;
 namespace it = image_transfer;
 namespace bench = benchmarking;
+namespace pe = physiology::edge;
 
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
 Container<TDeviceType, TOperationMode, TIntegrationMode>::Container(Container::SettingsType settings) :
@@ -54,6 +58,12 @@ Container<TDeviceType, TOperationMode, TIntegrationMode>::Container(Container::S
     graph(),
     device_context(),
     operation_context(settings.operation),
+    image_frame_pool(settings.image_frame_pool.max_free_buffers_per_size,
+                     static_cast<size_t>(settings.image_frame_pool.huge_page_arena_size_mb) * 1024 * 1024),
+    metrics_registry(!this->settings.metrics.enabled ? std::string() :
+                     !this->settings.metrics.container_label.empty() ? this->settings.metrics.container_label :
+                     ContainerMetrics::GetNextContainerLabel()),
+    metrics(this->settings.metrics.enabled ? ContainerMetrics::Register(this->metrics_registry) : ContainerMetrics{}),
     status(physiology::BuildStatusValue(physiology::StatusCode::PROCESSING_NOT_STARTED,
            std::chrono::duration_cast<std::chrono::microseconds>(
                std::chrono::system_clock::now().time_since_epoch()).count()
@@ -74,6 +84,11 @@ absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::Initializ
     static_assert(CV_MAJOR_VERSION > 4 || (CV_MAJOR_VERSION >= 4 && CV_MINOR_VERSION >= 2),
                   "OpenCV 4.2 or above is required");
 
+    if (this->settings.graph_executor.use_shared_pool) {
+        // has to happen before graph initialization; the graph keeps the lease for its lifetime
+        auto shared_pool = SharedExecutorPool::GetInstance(this->settings.graph_executor.shared_pool_thread_count);
+        MP_RETURN_IF_ERROR(this->graph.SetExecutor("", shared_pool->CreateLease(this->settings.graph_executor.weight)));
+    }
     MP_ASSIGN_OR_RETURN(std::filesystem::path graph_path, GetGraphFilePath());
     MP_RETURN_IF_ERROR(
         init::InitializeGraph<TDeviceType>(this->graph,
@@ -83,11 +98,256 @@ absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::Initializ
     );
     MP_RETURN_IF_ERROR(init::InitializeComputingDevice<TDeviceType>(this->graph, this->device_context));
 
+    if (this->settings.pre_scale_input) {
+        // look in the config with subgraphs expanded, the scaling calculator may well be inside one
+        this->graph_input_scaling =
+            FindGraphInputScaling(this->graph.Config(), pe::graph::input_streams::kInputVideo);
+        if (!this->graph_input_scaling.has_value()) {
+            LOG(WARNING) << "Input pre-scaling is on, but the graph doesn't scale its input to a fixed size: "
+                            "input frames will be sent in at full size.";
+        } else if (this->settings.verbosity_level > 0) {
+            LOG(INFO) << "Pre-scaling input frames for a graph input size of "
+                      << this->graph_input_scaling->output_size.width << "x"
+                      << this->graph_input_scaling->output_size.height << ".";
+        }
+    }
+
+    if (this->settings.metrics.enabled && !this->settings.metrics.export_address.empty()) {
+        // shared with other containers exporting at the same address
+        MP_ASSIGN_OR_RETURN(
+            std::shared_ptr<OpenMetricsExporter> metrics_exporter,
+            OpenMetricsExporter::GetInstance(this->settings.metrics.export_address)
+        );
+        this->metrics_export_registration =
+            std::make_unique<OpenMetricsExporter::Registration>(std::move(metrics_exporter), this->metrics_registry);
+    }
+
     initialized = true;
     return absl::OkStatus();
 }
 
 
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+FrameIngestionStatistics
+Container<TDeviceType, TOperationMode, TIntegrationMode>::GetFrameIngestionStatistics() const {
+    FrameIngestionStatistics statistics;
+    statistics.frames_ingested = this->frames_ingested.load(std::memory_order_relaxed);
+    statistics.single_pass_frames = this->single_pass_frames.load(std::memory_order_relaxed);
+    statistics.intermediate_copy_frames = statistics.frames_ingested - statistics.single_pass_frames;
+    return statistics;
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+ImageFramePoolStatistics
+Container<TDeviceType, TOperationMode, TIntegrationMode>::GetImageFramePoolStatistics() const {
+    return this->image_frame_pool.GetStatistics();
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+const MetricsRegistry& Container<TDeviceType, TOperationMode, TIntegrationMode>::GetMetricsRegistry() const {
+    return this->metrics_registry;
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>>
+Container<TDeviceType, TOperationMode, TIntegrationMode>::IngestFrame(const cv::Mat& frame, bool frame_is_bgr) {
+    if (frame.type() == CV_8UC3) {
+        std::optional<cv::Size> pre_scaled_frame_size =
+            this->GetPreScaledInputFrameSize(frame, video_source::InputTransformMode::None);
+        if (pre_scaled_frame_size.has_value()) {
+            return this->ScaleAndIngestFrame(
+                frame, video_source::InputTransformMode::None, frame_is_bgr, pre_scaled_frame_size.value()
+            );
+        }
+    }
+    MP_ASSIGN_OR_RETURN(int color_conversion_code, it::GetColorConversionCodeToRgb(frame.channels(), frame_is_bgr));
+    return this->ConvertAndIngestFrame(frame, color_conversion_code);
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>>
+Container<TDeviceType, TOperationMode, TIntegrationMode>::IngestFrame(
+    const cv::Mat& frame,
+    video_source::PixelFormat pixel_format,
+    video_source::InputTransformMode input_transform
+) {
+    if (frame.type() == CV_8UC3 &&
+        (pixel_format == video_source::PixelFormat::BGR || pixel_format == video_source::PixelFormat::RGB)) {
+        const bool frame_is_bgr = pixel_format == video_source::PixelFormat::BGR;
+        std::optional<cv::Size> pre_scaled_frame_size = this->GetPreScaledInputFrameSize(frame, input_transform);
+        if (pre_scaled_frame_size.has_value()) {
+            return this->ScaleAndIngestFrame(frame, input_transform, frame_is_bgr, pre_scaled_frame_size.value());
+        }
+        if (input_transform != video_source::InputTransformMode::None) {
+            return this->TransformAndIngestFrame(frame, input_transform, frame_is_bgr);
+        }
+    }
+    if (input_transform != video_source::InputTransformMode::None) {
+        // no fused kernel for this format: transform first, then convert as usual
+        return this->IngestFrame(video_source::InputTransformer{input_transform}.apply(frame), pixel_format);
+    }
+    if (pixel_format == video_source::PixelFormat::RGB && frame.type() == CV_8UC3) {
+        // already in the graph's format: share the buffer, the ImageFrame keeps it alive
+        ScopedTimer conversion_timer(this->metrics.conversion_seconds);
+        MP_ASSIGN_OR_RETURN(auto image_frame, it::WrapInImageFrame(frame, [frame_reference = frame]() {}));
+        this->single_pass_frames.fetch_add(1, std::memory_order_relaxed);
+        this->frames_ingested.fetch_add(1, std::memory_order_relaxed);
+        return image_frame;
+    }
+    MP_ASSIGN_OR_RETURN(int color_conversion_code, it::GetColorConversionCodeToRgb(pixel_format));
+    return this->ConvertAndIngestFrame(frame, color_conversion_code);
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>>
+Container<TDeviceType, TOperationMode, TIntegrationMode>::ConvertAndIngestFrame(
+    const cv::Mat& frame,
+    int color_conversion_code
+) {
+    ScopedTimer conversion_timer(this->metrics.conversion_seconds);
+    bool converted_in_place;
+    std::unique_ptr<mediapipe::ImageFrame> image_frame;
+    if (this->settings.image_frame_pool.enabled) {
+        const cv::Size converted_frame_size = it::GetConvertedFrameSize(frame, color_conversion_code);
+        MP_ASSIGN_OR_RETURN(
+            image_frame,
+            this->image_frame_pool.Acquire(
+                mediapipe::ImageFormat::SRGB, converted_frame_size.width, converted_frame_size.height
+            )
+        );
+        MP_RETURN_IF_ERROR(it::ConvertIntoImageFrame(frame, color_conversion_code, *image_frame, converted_in_place));
+    } else {
+        MP_ASSIGN_OR_RETURN(image_frame, it::ConvertToImageFrame(frame, color_conversion_code, converted_in_place));
+    }
+    if (converted_in_place) {
+        this->single_pass_frames.fetch_add(1, std::memory_order_relaxed);
+    } else if (this->settings.verbosity_level > 1) {
+        LOG(WARNING) << "Input frame required an intermediate buffer during conversion to RGB.";
+    }
+    this->frames_ingested.fetch_add(1, std::memory_order_relaxed);
+    return image_frame;
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+std::optional<cv::Size> Container<TDeviceType, TOperationMode, TIntegrationMode>::GetPreScaledInputFrameSize(
+    const cv::Mat& frame,
+    video_source::InputTransformMode input_transform
+) const {
+    if (!this->graph_input_scaling.has_value()) {
+        return std::nullopt;
+    }
+    return GetPreScaledFrameSize(
+        video_source::GetTransformedFrameSize(frame.size(), input_transform), this->graph_input_scaling.value()
+    );
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>>
+Container<TDeviceType, TOperationMode, TIntegrationMode>::ScaleAndIngestFrame(
+    const cv::Mat& frame,
+    video_source::InputTransformMode input_transform,
+    bool frame_is_bgr,
+    const cv::Size& scaled_frame_size
+) {
+    ScopedTimer conversion_timer(this->metrics.conversion_seconds);
+    bool scaled_in_place;
+    std::unique_ptr<mediapipe::ImageFrame> image_frame;
+    if (this->settings.image_frame_pool.enabled) {
+        MP_ASSIGN_OR_RETURN(
+            image_frame,
+            this->image_frame_pool.Acquire(
+                mediapipe::ImageFormat::SRGB, scaled_frame_size.width, scaled_frame_size.height
+            )
+        );
+        MP_RETURN_IF_ERROR(
+            it::ScaleIntoImageFrame(frame, input_transform, frame_is_bgr, *image_frame, scaled_in_place)
+        );
+    } else {
+        MP_ASSIGN_OR_RETURN(
+            image_frame,
+            it::ScaleToImageFrame(frame, input_transform, frame_is_bgr, scaled_frame_size, scaled_in_place)
+        );
+    }
+    // the intermediate buffer, if any, only holds the downscaled frame: not worth a warning
+    if (scaled_in_place) {
+        this->single_pass_frames.fetch_add(1, std::memory_order_relaxed);
+    }
+    this->frames_ingested.fetch_add(1, std::memory_order_relaxed);
+    return image_frame;
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>>
+Container<TDeviceType, TOperationMode, TIntegrationMode>::TransformAndIngestFrame(
+    const cv::Mat& frame,
+    video_source::InputTransformMode input_transform,
+    bool frame_is_bgr
+) {
+    ScopedTimer conversion_timer(this->metrics.conversion_seconds);
+    std::unique_ptr<mediapipe::ImageFrame> image_frame;
+    if (this->settings.image_frame_pool.enabled) {
+        const cv::Size transformed_frame_size = video_source::GetTransformedFrameSize(frame.size(), input_transform);
+        MP_ASSIGN_OR_RETURN(
+            image_frame,
+            this->image_frame_pool.Acquire(
+                mediapipe::ImageFormat::SRGB, transformed_frame_size.width, transformed_frame_size.height
+            )
+        );
+        MP_RETURN_IF_ERROR(it::TransformIntoImageFrame(frame, input_transform, frame_is_bgr, *image_frame));
+    } else {
+        MP_ASSIGN_OR_RETURN(image_frame, it::TransformToImageFrame(frame, input_transform, frame_is_bgr));
+    }
+    this->single_pass_frames.fetch_add(1, std::memory_order_relaxed);
+    this->frames_ingested.fetch_add(1, std::memory_order_relaxed);
+    return image_frame;
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+mediapipe::Packet
+Container<TDeviceType, TOperationMode, TIntegrationMode>::GetRecordingPacket(mediapipe::Timestamp timestamp) const {
+    return (this->recording ? this->recording_on_packet : this->recording_off_packet).At(timestamp);
+}
+
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
 std::string Container<TDeviceType, TOperationMode, TIntegrationMode>::GetThirdGraphFileSuffix() const {
     return settings::AbslUnparseFlag(TIntegrationMode);
@@ -173,9 +433,29 @@ template<
 >
 absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::SetOnVideoOutput(
     const std::function<absl::Status(cv::Mat&, int64_t)>& on_video_output
+) {
+    return this->SetOnVideoOutput(on_video_output, video_source::PixelFormat::BGR);
+}
+
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::SetOnVideoOutput(
+    const std::function<absl::Status(cv::Mat&, int64_t)>& on_video_output,
+    video_source::PixelFormat output_pixel_format
 ) {
     MP_RETURN_IF_ERROR(CheckCallbackNotNull(on_video_output));
+    if (output_pixel_format != video_source::PixelFormat::BGR && output_pixel_format != video_source::PixelFormat::RGB) {
+        return absl::InvalidArgumentError(
+            "Video output frames can only be provided as BGR or RGB, not "
+            + video_source::AbslUnparseFlag(output_pixel_format) + "."
+        );
+    }
     this->OnVideoOutput = on_video_output;
+    this->video_output_callback_set = true;
+    this->video_output_pixel_format = output_pixel_format;
     return absl::OkStatus();
 }
 
@@ -192,6 +472,19 @@ absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::SetOnFram
     return absl::OkStatus();
 }
 
+template<
+    platform_independence::DeviceType TDeviceType,
+    settings::OperationMode TOperationMode,
+    settings::IntegrationMode TIntegrationMode
+>
+absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::SetOnCorePerformanceTelemetry(
+    const std::function<absl::Status(const CorePerformanceTelemetry&)>& on_core_performance_telemetry
+) {
+    MP_RETURN_IF_ERROR(CheckCallbackNotNull(on_core_performance_telemetry));
+    this->OnCorePerformanceTelemetry = on_core_performance_telemetry;
+    return absl::OkStatus();
+}
+
 template<
     platform_independence::DeviceType TDeviceType,
     settings::OperationMode TOperationMode,
@@ -201,7 +494,9 @@ absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::SetOnCore
     const std::function<absl::Status(double, double, int64_t)>& on_effective_core_fps_output
 ) {
     MP_RETURN_IF_ERROR(CheckCallbackNotNull(on_effective_core_fps_output));
-    this->OnCorePerformanceTelemetry = on_effective_core_fps_output;
+    this->OnCorePerformanceTelemetry = [on_effective_core_fps_output](const CorePerformanceTelemetry& telemetry) {
+        return on_effective_core_fps_output(telemetry.fps, telemetry.mean_latency_seconds, telemetry.input_timestamp);
+    };
     return absl::OkStatus();
 }
 
@@ -213,19 +508,20 @@ template<
 >
 void Container<TDeviceType, TOperationMode, TIntegrationMode>::AddFrameTimestampToBenchmarkingInfo(const mediapipe::Timestamp& timestamp) {
     if (this->OnCorePerformanceTelemetry.has_value() && this->recording) {
+        std::lock_guard<std::mutex> lock(this->benchmarking_mutex);
         // Calculate the offset of frame capture time from system time
         if (!offset_from_system_time.has_value()) {
             double current_system_seconds =
                 std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
             offset_from_system_time = current_system_seconds - timestamp.Seconds();
         }
-        this->frames_in_graph_timestamps.insert(timestamp.Value());
+        this->core_performance_tracker.RecordFrameInput(timestamp.Value());
     }
 }
 
 /**
- * Computes effective fps if OnEffectiveCoreFpsOutput has been set.
- * Relies on this->frames_in_graph_timestamps with timestamps of every frame put into the graph
+ * Computes effective fps & latency statistics if OnCorePerformanceTelemetry has been set.
+ * Relies on timestamps of every frame put into the graph being tracked
  * (AddFrameTimestampToBenchmarkingInfo should be used in child classes at every frame)
  * @param metrics_buffer - last output metrics buffer
  * @return status
@@ -239,74 +535,28 @@ absl::Status Container<TDeviceType, TOperationMode, TIntegrationMode>::ComputeCo
     const physiology::MetricsBuffer& metrics_buffer
 ) {
     if (this->OnCorePerformanceTelemetry.has_value()) {
+        std::unique_lock<std::mutex> lock(this->benchmarking_mutex);
+        if (!offset_from_system_time.has_value()) {
+            return absl::OkStatus();
+        }
         double current_system_seconds =
             std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
 
         auto last_buffer_input_timestamp = metrics_buffer.metadata().frame_timestamp();
-        auto last_buffer_input_timestamp_location =
-            this->frames_in_graph_timestamps.find(last_buffer_input_timestamp);
-        auto first_buffer_input_timestamp = *this->frames_in_graph_timestamps.begin();
-
-        // want to be using buffer frame count further (which is captured during send/receive),
-        // NOT last_output_timestamp_loc - this->frames_in_graph_timestamps.begin(),
-        // because some input frames may have been dropped.
-
-        // erase all frames associated with this buffer (even dropped ones)
-        this->frames_in_graph_timestamps.erase(this->frames_in_graph_timestamps.begin(),
-                                               last_buffer_input_timestamp_location);
-
         // compute buffer latency
         double absolute_last_output_system_seconds =
             mediapipe::Timestamp(last_buffer_input_timestamp).Seconds() + offset_from_system_time.value();
         double buffer_latency_seconds = current_system_seconds - absolute_last_output_system_seconds;
 
-        // add buffer benchmarking information to buffer to compute averages later
-        this->metrics_buffer_benchmarking_info_buffer.push_back(
-            MetricsBufferBenchmarkingInfo{
-                first_buffer_input_timestamp,
-                last_buffer_input_timestamp,
-                metrics_buffer.metadata().frame_count(),
-                buffer_latency_seconds
-            }
+        // want to be using buffer frame count (which is captured during send/receive), NOT the number of tracked
+        // frames covered by the buffer, because some input frames may have been dropped.
+        std::optional<CorePerformanceTelemetry> telemetry = this->core_performance_tracker.RecordMetricsBuffer(
+            last_buffer_input_timestamp, metrics_buffer.metadata().frame_count(), buffer_latency_seconds
         );
-
-        // clear out benchmarking information from buffer from before the current window (using window duration)
-        // (approximate, since we use last output timestamp)
-        auto metrics_buffer_benchmarking_info_location =
-            this->metrics_buffer_benchmarking_info_buffer.begin();
-        auto current_window_start = last_buffer_input_timestamp - this->fps_averaging_window_microseconds;
-        while (metrics_buffer_benchmarking_info_location != this->metrics_buffer_benchmarking_info_buffer.end()
-               && metrics_buffer_benchmarking_info_location->last_timestamp < current_window_start) {
-            metrics_buffer_benchmarking_info_location++;
-        }
-        if (metrics_buffer_benchmarking_info_location > this->metrics_buffer_benchmarking_info_buffer.begin() + 1) {
-            this->metrics_buffer_benchmarking_info_buffer.erase(this->metrics_buffer_benchmarking_info_buffer.begin(),
-                                                                metrics_buffer_benchmarking_info_location--);
-        }
-
-        // compute total average framerate
-        int64_t window_total_microseconds =
-            last_buffer_input_timestamp - this->metrics_buffer_benchmarking_info_buffer.begin()->first_timestamp;
-        int32_t window_frame_count = 0;
-        double aggregate_latency_seconds = 0.0;
-        for (const auto& buffer_benchmarking_info: this->metrics_buffer_benchmarking_info_buffer) {
-            window_frame_count += buffer_benchmarking_info.frame_count;
-            aggregate_latency_seconds += buffer_benchmarking_info.latency_seconds;
+        lock.unlock();
+        if (telemetry.has_value()) {
+            MP_RETURN_IF_ERROR(this->OnCorePerformanceTelemetry.value()(telemetry.value()));
         }
-
-        // note: exclude the very last frame from the count, since it's "incomplete" when it's just captured,
-        // and the window ends with it being just captured
-        double effective_core_fps =
-            static_cast<double>(window_frame_count - 1) * 1000000.0 /
-            static_cast<double>(window_total_microseconds);
-
-        double effective_core_latency_seconds =
-            aggregate_latency_seconds / this->metrics_buffer_benchmarking_info_buffer.size();
-
-        MP_RETURN_IF_ERROR(this->OnCorePerformanceTelemetry.value()(
-            effective_core_fps, effective_core_latency_seconds, first_buffer_input_timestamp
-        ));
-
     }
     return absl::OkStatus();
 }
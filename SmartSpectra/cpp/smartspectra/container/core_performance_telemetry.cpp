@@ -0,0 +1,155 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <bit>
+#include <cmath>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "core_performance_telemetry.hpp"
+
+namespace presage::smartspectra::container {
+
+// ==== LatencyHistogram
+
+int LatencyHistogram::BucketIndex(int64_t value) {
+    const auto clamped_value = static_cast<uint64_t>(std::clamp<int64_t>(value, 0, kMaxValue));
+    // values up to 2 * kSubBucketCount map to themselves; each further power of two gets kSubBucketCount buckets
+    const int shift = std::max(0, static_cast<int>(std::bit_width(clamped_value)) - (kSubBucketBits + 1));
+    return (shift << kSubBucketBits) + static_cast<int>(clamped_value >> shift);
+}
+
+int64_t LatencyHistogram::HighestEquivalentValue(int bucket_index) {
+    if (bucket_index < 2 * kSubBucketCount) {
+        return bucket_index;
+    }
+    const int shift = bucket_index / kSubBucketCount - 1;
+    const int64_t mantissa = bucket_index - shift * kSubBucketCount;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(int64_t value) {
+    this->counts[BucketIndex(value)]++;
+    this->total_count++;
+}
+
+void LatencyHistogram::Remove(int64_t value) {
+    uint32_t& count = this->counts[BucketIndex(value)];
+    if (count > 0) {
+        count--;
+        this->total_count--;
+    }
+}
+
+void LatencyHistogram::Clear() {
+    this->counts.fill(0);
+    this->total_count = 0;
+}
+
+int64_t LatencyHistogram::ValueAtQuantile(double quantile) const {
+    if (this->total_count == 0) {
+        return 0;
+    }
+    const auto target_count = std::max<int64_t>(
+        1, static_cast<int64_t>(std::ceil(std::clamp(quantile, 0.0, 1.0) * static_cast<double>(this->total_count)))
+    );
+    int64_t cumulative_count = 0;
+    for (int i_bucket = 0; i_bucket < kBucketCount; i_bucket++) {
+        cumulative_count += this->counts[i_bucket];
+        if (cumulative_count >= target_count) {
+            return HighestEquivalentValue(i_bucket);
+        }
+    }
+    return kMaxValue;
+}
+
+// ==== CorePerformanceTracker
+
+CorePerformanceTracker::CorePerformanceTracker(
+    int64_t window_microseconds,
+    int max_tracked_frames,
+    int max_tracked_buffers
+) : window_microseconds(window_microseconds),
+    frame_timestamps(max_tracked_frames),
+    buffers_in_window(max_tracked_buffers) {}
+
+void CorePerformanceTracker::RecordFrameInput(int64_t input_timestamp) {
+    this->frame_timestamps.PushBack(input_timestamp);
+}
+
+void CorePerformanceTracker::EvictOldestBuffer() {
+    this->latency_histogram.Remove(this->buffers_in_window.Front().latency_microseconds);
+    this->buffers_in_window.PopFront();
+}
+
+std::optional<CorePerformanceTelemetry> CorePerformanceTracker::RecordMetricsBuffer(
+    int64_t last_input_timestamp, int32_t frame_count, double latency_seconds
+) {
+    if (this->frame_timestamps.Empty()) {
+        return std::nullopt;
+    }
+    const int64_t first_input_timestamp = this->frame_timestamps.Front();
+    // drop all frames associated with this buffer (even dropped ones), except for the last one, which starts the next
+    while (!this->frame_timestamps.Empty() && this->frame_timestamps.Front() < last_input_timestamp) {
+        this->frame_timestamps.PopFront();
+    }
+
+
+    const auto latency_microseconds = static_cast<int64_t>(std::max(0.0, latency_seconds) * 1000000.0);
+    if (this->buffers_in_window.Size() == this->buffers_in_window.Capacity()) {
+        EvictOldestBuffer();
+    }
+    this->buffers_in_window.PushBack(
+        BufferInfo{first_input_timestamp, last_input_timestamp, frame_count, latency_seconds, latency_microseconds}
+    );
+    this->latency_histogram.Record(latency_microseconds);
+
+    // slide the window (approximate, since we use last output timestamp), but keep the last buffer that starts
+    // before it, so that the window spans its full duration
+    const int64_t window_start = last_input_timestamp - this->window_microseconds;
+    while (this->buffers_in_window.Size() > 1 && this->buffers_in_window[1].last_timestamp < window_start) {
+        EvictOldestBuffer();
+    }
+
+    CorePerformanceTelemetry telemetry;
+    int64_t window_frame_count = 0;
+    double aggregate_latency_seconds = 0.0;
+    for (size_t i_buffer = 0; i_buffer < this->buffers_in_window.Size(); i_buffer++) {
+        const BufferInfo& buffer_info = this->buffers_in_window[i_buffer];
+        window_frame_count += buffer_info.frame_count;
+        aggregate_latency_seconds += buffer_info.latency_seconds;
+        telemetry.max_latency_seconds = std::max(telemetry.max_latency_seconds, buffer_info.latency_seconds);
+    }
+    const int64_t window_total_microseconds = last_input_timestamp - this->buffers_in_window.Front().first_timestamp;
+    // note: exclude the very last frame from the count, since it's "incomplete" when it's just captured,
+    // and the window ends with it being just captured
+    if (window_total_microseconds > 0) {
+        telemetry.fps = static_cast<double>(window_frame_count - 1) * 1000000.0 /
+                        static_cast<double>(window_total_microseconds);
+    }
+    telemetry.mean_latency_seconds = aggregate_latency_seconds / static_cast<double>(this->buffers_in_window.Size());
+    // histogram values are upper bounds of their buckets, so they may slightly overshoot the exact maximum
+    auto latency_quantile_seconds = [&](double quantile) {
+        return std::min(
+            telemetry.max_latency_seconds,
+            static_cast<double>(this->latency_histogram.ValueAtQuantile(quantile)) / 1000000.0
+        );
+    };
+    telemetry.p50_latency_seconds = latency_quantile_seconds(0.50);
+    telemetry.p95_latency_seconds = latency_quantile_seconds(0.95);
+    telemetry.p99_latency_seconds = latency_quantile_seconds(0.99);
+    telemetry.input_timestamp = first_input_timestamp;
+    return telemetry;
+}
+
+void CorePerformanceTracker::Reset() {
+    this->frame_timestamps.Clear();
+    this->buffers_in_window.Clear();
+    this->latency_histogram.Clear();
+}
+
+} // namespace presage::smartspectra::container
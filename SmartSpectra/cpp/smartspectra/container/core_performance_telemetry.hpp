@@ -0,0 +1,164 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Effective throughput & latency of the edge + core processing pipeline over a sliding time window.
+ */
+struct CorePerformanceTelemetry {
+    /** Effective rate at which frames go through the whole pipeline, in frames per second. */
+    double fps = 0.0;
+    /** Mean latency from frame input to metrics output, in seconds. */
+    double mean_latency_seconds = 0.0;
+    double p50_latency_seconds = 0.0;
+    double p95_latency_seconds = 0.0;
+    double p99_latency_seconds = 0.0;
+    double max_latency_seconds = 0.0;
+    /** Input timestamp (microseconds) of the first frame covered by the latest metrics buffer. */
+    int64_t input_timestamp = 0;
+};
+
+/**
+ * @brief Fixed-size log-linear (HDR-style) histogram of non-negative integer values.
+ *
+ * Values below 2^(kSubBucketBits + 1) are counted exactly; above that, every power-of-two range is split into
+ * 2^kSubBucketBits buckets, which bounds the relative error of reported quantiles by 2^-kSubBucketBits (~3%).
+ * Values above kMaxValue are clamped. Recording and removing values never allocates.
+ */
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 5;
+    static constexpr int kMaxValueBits = 27;
+    /** With values in microseconds, a little over two minutes. */
+    static constexpr int64_t kMaxValue = (int64_t(1) << kMaxValueBits) - 1;
+
+    void Record(int64_t value);
+    /** Remove a value recorded earlier, e.g. when it slides out of a time window. */
+    void Remove(int64_t value);
+    void Clear();
+
+    int64_t TotalCount() const { return this->total_count; }
+    /**
+     * @param quantile in [0, 1]
+     * @return largest value equivalent (within histogram precision) to the value at the given quantile,
+     * or 0 if the histogram is empty
+     */
+    int64_t ValueAtQuantile(double quantile) const;
+
+private:
+    static constexpr int kSubBucketCount = 1 << kSubBucketBits;
+    static constexpr int kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+    static int BucketIndex(int64_t value);
+    static int64_t HighestEquivalentValue(int bucket_index);
+
+    std::array<uint32_t, kBucketCount> counts{};
+    int64_t total_count = 0;
+};
+
+/**
+ * @brief Computes CorePerformanceTelemetry from frames fed into the graph and metrics buffers coming out of it.
+ *
+ * All bookkeeping lives in rings with capacity fixed at construction, so memory stays bounded and no allocation
+ * happens per frame, even if metrics buffers stop arriving (the oldest frame timestamps are then overwritten).
+ * Not thread-safe.
+ */
+class CorePerformanceTracker {
+public:
+    /**
+     * @param window_microseconds duration of the sliding window FPS & latency are computed over
+     * @param max_tracked_frames maximum number of frames awaiting a metrics buffer that are tracked
+     * @param max_tracked_buffers maximum number of metrics buffers kept within the window
+     */
+    explicit CorePerformanceTracker(
+        int64_t window_microseconds = 3 * 1000000,
+        int max_tracked_frames = 4096,
+        int max_tracked_buffers = 256
+    );
+
+    /** Record a frame fed into the graph. Timestamps are expected to increase monotonically. */
+    void RecordFrameInput(int64_t input_timestamp);
+
+    /**
+     * Record a metrics buffer received from core.
+     * @param last_input_timestamp input timestamp of the last frame covered by the buffer
+     * @param frame_count number of frames covered by the buffer
+     * @param latency_seconds time from input of the buffer's last frame until the buffer was received
+     * @return telemetry over the current window, or std::nullopt if no frames are being tracked
+     */
+    std::optional<CorePerformanceTelemetry> RecordMetricsBuffer(
+        int64_t last_input_timestamp, int32_t frame_count, double latency_seconds
+    );
+
+    void Reset();
+
+private:
+    struct BufferInfo {
+        int64_t first_timestamp = 0;
+        int64_t last_timestamp = 0;
+        int32_t frame_count = 0;
+        double latency_seconds = 0;
+        int64_t latency_microseconds = 0;
+    };
+
+    /** Fixed-capacity FIFO that overwrites its oldest element when full. */
+    template<typename T>
+    class Ring {
+    public:
+        explicit Ring(int capacity) : elements(std::max(1, capacity)) {}
+
+        /** @return true if the oldest element had to be overwritten */
+        bool PushBack(const T& element) {
+            const bool overwrite = this->count == this->elements.size();
+            if (overwrite) {
+                PopFront();
+            }
+            this->elements[(this->head + this->count) % this->elements.size()] = element;
+            this->count++;
+            return overwrite;
+        }
+        void PopFront() {
+            this->head = (this->head + 1) % this->elements.size();
+            this->count--;
+        }
+        const T& Front() const { return this->elements[this->head]; }
+        const T& operator[](size_t index) const {
+            return this->elements[(this->head + index) % this->elements.size()];
+        }
+        size_t Size() const { return this->count; }
+        size_t Capacity() const { return this->elements.size(); }
+        bool Empty() const { return this->count == 0; }
+        void Clear() {
+            this->head = 0;
+            this->count = 0;
+        }
+
+    private:
+        std::vector<T> elements;
+        size_t head = 0;
+        size_t count = 0;
+    };
+
+    void EvictOldestBuffer();
+
+    const int64_t window_microseconds;
+    Ring<int64_t> frame_timestamps;
+    Ring<BufferInfo> buffers_in_window;
+    LatencyHistogram latency_histogram;
+};
+
+} // namespace presage::smartspectra::container
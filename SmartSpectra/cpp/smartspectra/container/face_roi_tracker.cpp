@@ -0,0 +1,109 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cmath>
+#include <limits>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "face_roi_tracker.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+// expand the box by the given fractions of its size, snap outwards to even coordinates (keeps chroma-subsampled
+// and SIMD-friendly layouts happy) and clamp to the frame
+cv::Rect ExpandBox(const cv::Rect2f& box, const settings::RoiCropSettings& settings, const cv::Size& frame_size) {
+    const float left = box.x - box.width * settings.side_margin;
+    const float right = box.x + box.width * (1.0f + settings.side_margin);
+    const float top = box.y - box.height * settings.top_margin;
+    const float bottom = box.y + box.height * (1.0f + settings.bottom_margin);
+    const int x0 = std::max(0, static_cast<int>(std::floor(left)) & ~1);
+    const int y0 = std::max(0, static_cast<int>(std::floor(top)) & ~1);
+    const int x1 = std::min(frame_size.width, (static_cast<int>(std::ceil(right)) + 1) & ~1);
+    const int y1 = std::min(frame_size.height, (static_cast<int>(std::ceil(bottom)) + 1) & ~1);
+    return {x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0)};
+}
+
+bool Contains(const cv::Rect& outer, const cv::Rect& inner) {
+    return inner.x >= outer.x && inner.y >= outer.y &&
+           inner.x + inner.width <= outer.x + outer.width && inner.y + inner.height <= outer.y + outer.height;
+}
+
+} // anonymous namespace
+
+FaceRoiTracker::FaceRoiTracker(const settings::RoiCropSettings& settings) : settings(settings) {}
+
+cv::Rect FaceRoiTracker::ComputeTargetCrop(const cv::Size& frame_size) const {
+    cv::Rect target = ExpandBox(this->face_box.value(), this->settings, frame_size);
+    if (target.empty() ||
+        static_cast<double>(target.area()) > this->settings.maximum_area_ratio * frame_size.area()) {
+        // not worth it
+        return {};
+    }
+    return target;
+}
+
+cv::Rect FaceRoiTracker::GetCrop(const cv::Size& frame_size, int64_t timestamp) {
+    const cv::Rect full_frame(0, 0, frame_size.width, frame_size.height);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->face_box.has_value()) {
+        return full_frame;
+    }
+    if (timestamp - this->face_box_timestamp > static_cast<int64_t>(this->settings.track_timeout_ms) * 1000) {
+        // lost track of the face
+        this->face_box.reset();
+        this->crop = {};
+        return full_frame;
+    }
+    const cv::Rect target = this->ComputeTargetCrop(frame_size);
+    // Keep the current crop while it still holds the face with at least half of the margins around it and isn't
+    // much larger than needed, so that the graph doesn't see the frame shift around for every small movement.
+    bool keep_current_crop = false;
+    if (!this->crop.empty() && !target.empty() && Contains(full_frame, this->crop)) {
+        settings::RoiCropSettings half_margins = this->settings;
+        half_margins.side_margin /= 2;
+        half_margins.top_margin /= 2;
+        half_margins.bottom_margin /= 2;
+        const cv::Rect minimal_crop = ExpandBox(this->face_box.value(), half_margins, frame_size);
+        keep_current_crop = Contains(this->crop, minimal_crop) && this->crop.area() <= 2 * target.area();
+    }
+    if (!keep_current_crop) {
+        this->crop = target;
+    }
+    return this->crop.empty() ? full_frame : this->crop;
+}
+
+void FaceRoiTracker::HandleEdgeMetrics(const physiology::Metrics& edge_metrics, int64_t timestamp) {
+    if (!edge_metrics.has_face() || edge_metrics.face().landmarks().empty()) {
+        return;
+    }
+    const auto& latest_landmarks = *edge_metrics.face().landmarks().rbegin();
+    if (latest_landmarks.value().empty()) {
+        return;
+    }
+    float x_min = std::numeric_limits<float>::max(), y_min = std::numeric_limits<float>::max();
+    float x_max = std::numeric_limits<float>::lowest(), y_max = std::numeric_limits<float>::lowest();
+    for (const auto& point: latest_landmarks.value()) {
+        x_min = std::min(x_min, point.x());
+        y_min = std::min(y_min, point.y());
+        x_max = std::max(x_max, point.x());
+        y_max = std::max(y_max, point.y());
+    }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->face_box = cv::Rect2f(x_min, y_min, x_max - x_min, y_max - y_min);
+    this->face_box_timestamp = timestamp;
+}
+
+void FaceRoiTracker::Reset() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->face_box.reset();
+    this->crop = {};
+}
+
+} // namespace presage::smartspectra::container
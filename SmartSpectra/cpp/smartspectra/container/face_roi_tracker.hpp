@@ -0,0 +1,67 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <mutex>
+#include <optional>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/opencv_core_inc.h>
+#include <physiology/modules/messages/metrics.h>
+// === local includes (if any) ===
+#include "settings.hpp"
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Tracks the face through the dense face landmarks in edge metrics and picks the region of each input frame
+ * to send into the graph.
+ *
+ * Frames get cropped to the face landmark bounding box plus margins. Since the graph only ever sees cropped (and
+ * possibly pre-scaled) frames, its landmarks have to be mapped back onto the full frame (see IngestedFrameMap) before
+ * they can update the track.
+ *
+ * The crop is kept as long as the face stays well inside it, so it doesn't jitter from frame to frame. Frames go back
+ * to full size when the track is lost (no landmarks for a while) or reset (e.g. on a non-OK status).
+ *
+ * GetCrop is called by the feed stage, the rest by the output stage; all are thread-safe.
+ */
+class FaceRoiTracker {
+public:
+    explicit FaceRoiTracker(const settings::RoiCropSettings& settings);
+
+    /**
+     * Region of the next frame to send into the graph.
+     * @param frame_size size of the full frame (after the input transform)
+     * @param timestamp frame timestamp, in microseconds
+     * @return the region, in full-frame coordinates: the whole frame if there is no face track
+     */
+    cv::Rect GetCrop(const cv::Size& frame_size, int64_t timestamp);
+
+    /**
+     * Update the track from the latest face landmarks of edge metrics.
+     * @param edge_metrics edge metrics, with landmarks in full-frame coordinates
+     * @param timestamp timestamp of the frame the edge metrics were produced for, in microseconds
+     */
+    void HandleEdgeMetrics(const physiology::Metrics& edge_metrics, int64_t timestamp);
+
+    /** Drop the face track, so that frames go back to full size until the face is found again. */
+    void Reset();
+
+private:
+    cv::Rect ComputeTargetCrop(const cv::Size& frame_size) const;
+
+    const settings::RoiCropSettings settings;
+    std::mutex mutex;
+    // bounding box of the latest face landmarks, in full-frame coordinates
+    std::optional<cv::Rect2f> face_box;
+    int64_t face_box_timestamp = 0;
+    // crop currently in use; empty for full frames
+    cv::Rect crop;
+};
+
+} // namespace presage::smartspectra::container
@@ -22,13 +22,20 @@
 // === configuration header ===
 #include <physiology/modules/configuration.h>
 // === standard library includes (if any) ===
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
 // === third-party includes (if any) ===
 #ifdef WITH_VIDEO_OUTPUT
 #include <mediapipe/framework/port/opencv_video_inc.h>
 #endif
 // === local includes (if any) ===
 #include "container.hpp"
-#include "output_stream_poller_wrapper.hpp"
+#include "output_stream_multiplexer.hpp"
+#include "frame_ring.hpp"
+#include "frame_pacer.hpp"
+#include "face_roi_tracker.hpp"
 #include <smartspectra/video_source/video_source.hpp>
 
 namespace presage::smartspectra::container {
@@ -49,24 +56,85 @@ public:
     /** Construct a foreground container with the provided settings. */
     explicit ForegroundContainer(SettingsType settings);
 
+    /**
+     * Capture from the given (initialized) video source instead of building one from the video source settings, e.g.
+     * to run one container per stream of a video_source::v4l2::SynchronizedCameraGroup, or several containers off the
+     * same camera via a video_source::FrameBroadcaster. Call before Initialize.
+     */
+    absl::Status SetVideoSource(std::unique_ptr<video_source::VideoSource> video_source);
     /** Initialize container and any GUI/video resources. */
     absl::Status Initialize() override;
     /** Main capture loop for foreground operation. */
     virtual absl::Status Run();
 
+    /** Change the maximum frame capture rate, e.g. while running. */
+    absl::Status SetTargetFps(double target_fps);
+    /** Frame capture rate currently used for pacing (may be lower than the target if the graph drops frames). */
+    double GetCurrentFps() const;
+
 protected:
 
-    presage::smartspectra::container::output_stream_poller_wrapper::OutputStreamPollerWrapper core_metrics_poller;
-    presage::smartspectra::container::output_stream_poller_wrapper::OutputStreamPollerWrapper edge_metrics_poller;
+    // funnels graph output to the output stage
+    OutputStreamMultiplexer output_stream_multiplexer;
+
+    /** Observe graph output streams that carry metrics. */
+    virtual absl::Status ObserveOutputDataStreams();
+    /** Handle metrics produced by the core processing pipeline. */
+    virtual absl::Status HandleCoreMetricsOutput(const physiology::MetricsBuffer& metrics_buffer, int64_t timestamp);
+    /** Observe the remaining graph output streams (video, status, etc.), as well as the ones carrying metrics. */
+    absl::Status ObserveOutputStreams();
+
+    /** A frame grabbed by the capture stage, waiting for the conversion/feed stage. */
+    struct CapturedFrame {
+        cv::Mat frame;
+        int64_t timestamp = 0;
+        video_source::PixelFormat pixel_format = video_source::PixelFormat::BGR;
+        // input transform deferred to the conversion/feed stage, where it is fused with the conversion to RGB
+        video_source::InputTransformMode input_transform = video_source::InputTransformMode::None;
+    };
+
+    /** Pick the cheapest pixel format for the video source to produce and select it. */
+    absl::Status NegotiateInputPixelFormat();
 
-    /** Setup MediaPipe pollers for metrics and video output. */
-    virtual absl::Status InitializeOutputDataPollers();
-    /** Handle metrics and video output for the given frame. */
-    virtual absl::Status HandleOutputData(int64_t frame_timestamp);
+    /** Capture stage: grab frames from the video source and queue them up for the conversion/feed stage. */
+    absl::Status CaptureFrames(FrameRing<CapturedFrame>& captured_frames, settings::FrameQueueOverflowPolicy policy);
+    /** Conversion/feed stage: convert queued frames and send them into the graph. */
+    absl::Status FeedFrames(FrameRing<CapturedFrame>& captured_frames);
+    /** Output stage: dispatch graph output, handle GUI & keyboard input (runs on the thread that called Run). */
+    absl::Status HandleGraphOutput();
+    /** Resolve the overflow policy of the capture queue, picking one based on the video source if unspecified. */
+    settings::FrameQueueOverflowPolicy GetFrameQueueOverflowPolicy() const;
+    /** True if frames come from a video file or a file stream rather than a live camera. */
+    bool IsInputPrerecorded() const;
+    /**
+     * Apply a control (e.g., exposure) to the video source. While the capture stage runs, the control gets queued up
+     * and applied by the capture stage between frames, so that the calling stage never waits on a frame to arrive.
+     * @return status of the control if applied right away, OK if queued up (the capture stage fails on errors)
+     */
+    absl::Status ControlVideoSource(std::function<absl::Status(video_source::VideoSource&)> control);
+    /** Capture stage: apply the video source controls queued up since the last frame. */
+    absl::Status ApplyPendingVideoSourceControls();
 
     // state
-    bool keep_grabbing_frames;
+    std::atomic<bool> keep_grabbing_frames;
+    // set when capture stage stops producing frames
+    std::atomic<bool> capture_finished = false;
+    // set when conversion/feed stage stops sending frames to the graph
+    std::atomic<bool> feeding_finished = false;
+    std::atomic<int64_t> frames_dropped_from_capture_queue = 0;
+    // only accessed by the output stage
+    physiology::StatusCode previous_status_code = physiology::StatusCode::PROCESSING_NOT_STARTED;
+    // paces the capture stage
+    FramePacer frame_pacer;
+    // picks the region of input frames to send into the graph, if cropping to the face is on
+    FaceRoiTracker face_roi_tracker;
     std::unique_ptr<video_source::VideoSource> video_source = nullptr;
+    // Guards video_source while the capture stage isn't running, and the members below. While it runs, the capture stage
+    // has video_source to itself: it reads frames without holding the lock, other stages control the source through
+    // pending_video_source_controls.
+    std::mutex video_source_mutex;
+    bool capture_stage_owns_video_source = false;
+    std::vector<std::function<absl::Status(video_source::VideoSource&)>> pending_video_source_controls;
 #ifdef WITH_VIDEO_OUTPUT
     cv::VideoWriter stream_writer;
 #endif
@@ -74,7 +142,7 @@ protected:
     // settings
     const bool load_video;
 private:
-    /** Skip frames until reaching the configured start time offset. */
+    /** Seek past the configured start time offset (or skip frames until reaching it, where seeking fails). */
     void ScrollPastTimeOffset();
     static std::string GenerateGuiWindowName();
     static const std::string kWindowName;
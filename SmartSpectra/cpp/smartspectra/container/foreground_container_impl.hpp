@@ -20,6 +20,7 @@
 
 #pragma once
 // === standard library includes (if any) ===
+#include <algorithm>
 #include <thread>
 // === third-party includes (if any) ===
 #include <mediapipe/framework/port/opencv_imgproc_inc.h>
@@ -35,6 +36,7 @@
 #include "benchmarking.hpp"
 #include "keyboard_input.hpp"
 #include <smartspectra/video_source/factory.hpp>
+#include <smartspectra/video_source/input_transform_kernels.hpp>
 
 
 namespace presage::smartspectra::container {
@@ -54,7 +56,19 @@ ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::ForegroundCo
     SettingsType settings
 ): Base(settings),
    load_video(!this->settings.video_source.input_video_path.empty()),
-   video_source(nullptr), keep_grabbing_frames(false) {}
+   video_source(nullptr), keep_grabbing_frames(false),
+   frame_pacer(this->settings.frame_pacing, this->settings.interframe_delay_ms),
+   face_roi_tracker(this->settings.roi_crop) {}
+
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::SetTargetFps(double target_fps) {
+    return this->frame_pacer.SetTargetFps(target_fps);
+}
+
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+double ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::GetCurrentFps() const {
+    return this->frame_pacer.GetCurrentFps();
+}
 
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
 std::string ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::GenerateGuiWindowName() {
@@ -70,84 +84,256 @@ const std::string ForegroundContainer<TDeviceType, TOperationMode, TIntegrationM
     TOperationMode,
     TIntegrationMode>::GenerateGuiWindowName();
 /**
- * Called from Run() at each frame iteration.
- * @tparam TDeviceType
- * @tparam TOperationMode
- * @param frame_timestamp
- * @return
+ * Called from the output stage whenever the graph produces a core metrics buffer.
+ * @param metrics_buffer core metrics
+ * @param timestamp timestamp of the metrics buffer packet
+ * @return status of the handling
  */
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
-absl::Status ForegroundContainer<TDeviceType,
-    TOperationMode,
-    TIntegrationMode>::HandleOutputData(int64_t frame_timestamp) {
-    bool got_core_metrics_output;
-    physiology::MetricsBuffer metrics_buffer;
-    MP_RETURN_IF_ERROR(ph::GetPacketContentsIfAny(
-        metrics_buffer,
-        got_core_metrics_output,
-        this->core_metrics_poller.Get(),
-        pe::graph::output_streams::kMetricsBuffer,
-        this->settings.verbosity_level > 2
-    ));
-    if (got_core_metrics_output) {
-        MP_RETURN_IF_ERROR(this->OnCoreMetricsOutput(metrics_buffer, frame_timestamp));
-        if (TOperationMode == settings::OperationMode::Spot) {
-            // reset to start state
-            this->recording = false;
-            if (this->load_video) {
-                keep_grabbing_frames = false;
-            } else if (this->settings.video_source.auto_lock &&
-                       this->video_source->SupportsExposureControls()) {
-                MP_RETURN_IF_ERROR(this->video_source->TurnOnAutoExposure());
-            }
-        } else {
-            MP_RETURN_IF_ERROR(this->ComputeCorePerformanceTelemetry(metrics_buffer));
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::HandleCoreMetricsOutput(
+    const physiology::MetricsBuffer& metrics_buffer,
+    int64_t timestamp
+) {
+    MP_RETURN_IF_ERROR(this->OnCoreMetricsOutput(metrics_buffer, timestamp));
+    if (TOperationMode == settings::OperationMode::Spot) {
+        // reset to start state
+        this->recording = false;
+        if (this->load_video) {
+            keep_grabbing_frames = false;
+        } else if (this->settings.video_source.auto_lock) {
+            MP_RETURN_IF_ERROR(this->ControlVideoSource([](video_source::VideoSource& video_source) {
+                return video_source.SupportsExposureControls() ? video_source.TurnOnAutoExposure()
+                                                               : absl::OkStatus();
+            }));
         }
+    } else {
+        MP_RETURN_IF_ERROR(this->ComputeCorePerformanceTelemetry(metrics_buffer));
     }
+    return absl::OkStatus();
+}
+
+/**
+ * Called from Run() to start observing the graph output streams that carry metrics.
+ * @return status of the operation
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::ObserveOutputDataStreams() {
+    MP_RETURN_IF_ERROR(this->output_stream_multiplexer.Observe(
+        this->graph, pe::graph::output_streams::kMetricsBuffer,
+        [this](const mediapipe::Packet& metrics_buffer_packet) {
+            const auto& metrics_buffer = metrics_buffer_packet.Get<physiology::MetricsBuffer>();
+            ph::LogPacketContentsIf(this->settings.verbosity_level > 2, pe::graph::output_streams::kMetricsBuffer,
+                                    metrics_buffer, metrics_buffer_packet.Timestamp());
+            if ((this->settings.roi_crop.enabled || this->graph_input_scaling.has_value()) &&
+                metrics_buffer.has_face()) {
+                // landmarks come out in the coordinates of the cropped/scaled frames, consumers get full-frame ones
+                physiology::MetricsBuffer full_frame_metrics_buffer = metrics_buffer;
+                this->ingested_frame_map.MapLandmarks(
+                    *full_frame_metrics_buffer.mutable_face(), metrics_buffer_packet.Timestamp().Value()
+                );
+                return this->HandleCoreMetricsOutput(
+                    full_frame_metrics_buffer, metrics_buffer_packet.Timestamp().Value()
+                );
+            }
+            return this->HandleCoreMetricsOutput(metrics_buffer, metrics_buffer_packet.Timestamp().Value());
+        }
+    ));
     // A separate outer if-clause used here to increase the likelihood of compiler optimizing this out
     // when we're in spot mode.
     if (TOperationMode == settings::OperationMode::Continuous) {
         if (this->settings.enable_edge_metrics) {
-            bool got_edge_metrics_output;
-            do {
-                physiology::Metrics edge_metrics;
-                MP_RETURN_IF_ERROR(ph::GetPacketContentsIfAny(
-                    edge_metrics, got_edge_metrics_output, this->edge_metrics_poller.Get(),
-                    pe::graph::output_streams::kEdgeMetrics,
-                    this->settings.verbosity_level > 2
-                ));
-                if (got_edge_metrics_output) {
-                    MP_RETURN_IF_ERROR(this->OnEdgeMetricsOutput(edge_metrics));
+            MP_RETURN_IF_ERROR(this->output_stream_multiplexer.Observe(
+                this->graph, pe::graph::output_streams::kEdgeMetrics,
+                [this](const mediapipe::Packet& edge_metrics_packet) {
+                    const auto& edge_metrics = edge_metrics_packet.Get<physiology::Metrics>();
+                    ph::LogPacketContentsIf(this->settings.verbosity_level > 2,
+                                            pe::graph::output_streams::kEdgeMetrics,
+                                            edge_metrics, edge_metrics_packet.Timestamp());
+                    if (this->settings.roi_crop.enabled || this->graph_input_scaling.has_value()) {
+                        // landmarks come out in the coordinates of the cropped/scaled frame, consumers get full-frame
+                        // ones
+                        physiology::Metrics full_frame_edge_metrics = edge_metrics;
+                        const bool landmarks_mapped =
+                            full_frame_edge_metrics.has_face() &&
+                            this->ingested_frame_map.MapLandmarks(
+                                *full_frame_edge_metrics.mutable_face(), edge_metrics_packet.Timestamp().Value()
+                            );
+                        if (this->settings.roi_crop.enabled && landmarks_mapped) {
+                            this->face_roi_tracker.HandleEdgeMetrics(
+                                full_frame_edge_metrics, edge_metrics_packet.Timestamp().Value()
+                            );
+                        }
+                        return this->OnEdgeMetricsOutput(full_frame_edge_metrics);
+                    }
+                    return this->OnEdgeMetricsOutput(edge_metrics);
                 }
-            } while (got_edge_metrics_output);
+            ));
         }
     }
-
     return absl::OkStatus();
 }
 
 /**
- * Called from Run() to initialize the output data pollers.
- * @tparam TDeviceType
- * @tparam TOperationMode
- * @param frame_timestamp
- * @return status of the initialization
+ * Called from Run() to start observing all graph output streams handled by the output stage.
+ * @return status of the operation
  */
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
-absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::InitializeOutputDataPollers() {
-    MP_RETURN_IF_ERROR(this->core_metrics_poller.Initialize(this->graph, pe::graph::output_streams::kMetricsBuffer));
-    if (TOperationMode == settings::OperationMode::Spot) {
-        return absl::OkStatus();
-    } else {
-        return this->edge_metrics_poller.Initialize(this->graph, pe::graph::output_streams::kEdgeMetrics);
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::ObserveOutputStreams() {
+    //TODO: check that callbacks aren't nullptr (potentially, move the checks out into container base class and call
+    // from both here and background container's StartGraph, instead of duplicating the code that's already there.)
+    auto& multiplexer = this->output_stream_multiplexer;
+    multiplexer.Clear();
+    multiplexer.SetMetrics(
+        this->metrics.output_retrieval_seconds, this->metrics.callback_seconds, this->metrics.output_queue_depth
+    );
+
+    MP_RETURN_IF_ERROR(multiplexer.Observe(
+        this->graph, pe::graph::output_streams::kOutputVideo,
+        [this](const mediapipe::Packet& output_video_packet) -> absl::Status {
+            cv::Mat output_frame_rgb;
+            MP_RETURN_IF_ERROR(it::GetFrameFromPacket<TDeviceType>(output_frame_rgb,
+                                                                   this->device_context,
+                                                                   output_video_packet));
+
+            // Convert to BGR only if something downstream actually needs it.
+            bool bgr_callback = this->video_output_callback_set &&
+                                this->video_output_pixel_format == video_source::PixelFormat::BGR;
+            bool bgr_needed = bgr_callback || !this->settings.headless;
+#ifdef WITH_VIDEO_OUTPUT
+            bgr_needed |= this->stream_writer.isOpened() && !this->settings.video_sink.passthrough;
+#endif
+            if (bgr_needed) {
+                cv::cvtColor(output_frame_rgb, this->output_frame_bgr, cv::COLOR_RGB2BGR);
+            }
+
+            // Envoke Callback on the video
+            if (this->video_output_callback_set) {
+                MP_RETURN_IF_ERROR(this->OnVideoOutput(
+                    bgr_callback ? this->output_frame_bgr : output_frame_rgb, output_video_packet.Timestamp().Value()
+                ));
+            }
+
+            // only display output window when we're not in headless mode.
+            if (!this->settings.headless) {
+                cv::imshow(kWindowName, this->output_frame_bgr);
+            }
+#ifdef WITH_VIDEO_OUTPUT
+            if (this->stream_writer.isOpened() && !this->settings.video_sink.passthrough) {
+                this->stream_writer.write(this->output_frame_bgr);
+            }
+#endif
+            return absl::OkStatus();
+        }
+    ));
+
+    MP_RETURN_IF_ERROR(multiplexer.Observe(
+        this->graph, pe::graph::output_streams::kStatusCode,
+        [this](const mediapipe::Packet& status_packet) -> absl::Status {
+            this->status = status_packet.Get<physiology::StatusValue>();
+            ph::LogPacketContentsIf(this->settings.verbosity_level > 2, pe::graph::output_streams::kStatusCode,
+                                    this->status, status_packet.Timestamp());
+            if (this->status.value() != this->previous_status_code) {
+                MP_RETURN_IF_ERROR(this->OnStatusChange(this->status));
+                this->previous_status_code = this->status.value();
+            }
+            if (this->settings.roi_crop.enabled && this->status.value() != physiology::StatusCode::OK) {
+                // whatever went wrong (e.g. the face moved out of the crop), the graph gets to look at full frames
+                this->face_roi_tracker.Reset();
+            }
+            if (this->settings.headless && !this->load_video) {
+                // if we loaded video, that means we started recording already.
+                // Otherwise, start recording iff status code is OK
+                if (!this->recording && this->status.value() == physiology::StatusCode::OK) {
+                    if (this->settings.video_source.auto_lock) {
+                        MP_RETURN_IF_ERROR(this->ControlVideoSource([](video_source::VideoSource& video_source) {
+                            return video_source.SupportsExposureControls() ? video_source.TurnOffAutoExposure()
+                                                                           : absl::OkStatus();
+                        }));
+                    }
+                    this->recording = true;
+                    LOG(INFO) << "====== Recording started after timestamp:" << status_packet.Timestamp().Value()
+                              << " ======";
+                }
+            }
+            return absl::OkStatus();
+        }
+    ));
+
+    MP_RETURN_IF_ERROR(multiplexer.Observe(
+        this->graph, pe::graph::output_streams::kBlueTooth,
+        [this](const mediapipe::Packet& blue_tooth_packet) {
+            ph::LogPacketContentsIf(this->settings.verbosity_level > 0, pe::graph::output_streams::kBlueTooth,
+                                    blue_tooth_packet.Get<double>(), blue_tooth_packet.Timestamp());
+            return absl::OkStatus();
+        }
+    ));
+
+    // frame rate diagnostics
+    MP_RETURN_IF_ERROR(multiplexer.Observe(
+        this->graph, pe::graph::output_streams::kFrameSentThrough,
+        [this](const mediapipe::Packet& frame_sent_through_packet) {
+            bool frame_sent_through = frame_sent_through_packet.Get<bool>();
+            ph::LogPacketContentsIf(this->settings.verbosity_level > 4, pe::graph::output_streams::kFrameSentThrough,
+                                    frame_sent_through, frame_sent_through_packet.Timestamp());
+            this->frame_pacer.RecordFrameSentThrough(frame_sent_through);
+            if (!frame_sent_through && this->metrics.frames_dropped_by_graph != nullptr) {
+                this->metrics.frames_dropped_by_graph->Increment();
+            }
+            return this->OnFrameSentThrough(frame_sent_through, frame_sent_through_packet.Timestamp().Value());
+        }
+    ));
+
+    MP_RETURN_IF_ERROR(this->ObserveOutputDataStreams());
+    MP_RETURN_IF_ERROR(
+        this->operation_context.ObserveOutputStreams(this->graph, multiplexer, this->settings.verbosity_level > 1)
+    );
+    return absl::OkStatus();
+}
+
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::SetVideoSource(
+    std::unique_ptr<video_source::VideoSource> video_source
+) {
+    if (video_source == nullptr) {
+        return absl::InvalidArgumentError("Video source must not be null.");
     }
+    if (this->load_video || !this->settings.video_source.file_stream_path.empty()) {
+        return absl::FailedPreconditionError(
+            "A video source can't be provided when the settings call for reading frames from files."
+        );
+    }
+    std::lock_guard<std::mutex> lock(this->video_source_mutex);
+    this->video_source = std::move(video_source);
+    return absl::OkStatus();
 }
 
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
 absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::Initialize() {
     LOG(INFO) << "Begin to initialize preprocessing container.";
+    if (this->settings.roi_crop.enabled &&
+        (TOperationMode != settings::OperationMode::Continuous || !this->settings.enable_edge_metrics ||
+         !this->settings.enable_dense_facemesh_points)) {
+        return absl::InvalidArgumentError(
+            "Cropping input frames to the face requires continuous mode with edge metrics and dense facemesh points "
+            "enabled, since the face is tracked through the edge metrics landmarks."
+        );
+    }
     MP_RETURN_IF_ERROR(Base::Initialize());
-    MP_ASSIGN_OR_RETURN(this->video_source, video_source::BuildVideoSource(this->settings.video_source));
+    if (this->video_source == nullptr) {
+        video_source::VideoSourceSettings video_source_settings = this->settings.video_source;
+        if (this->graph_input_scaling.has_value() &&
+            video_source_settings.decode_target_width_px <= 0 && video_source_settings.decode_target_height_px <= 0) {
+            // frames get pre-scaled to the graph's input size anyway, so compressed frames can be decoded at a
+            // reduced scale right away (the target is in capture orientation, i.e. before the input transform)
+            cv::Size decode_target_size = video_source::GetTransformedFrameSize(
+                this->graph_input_scaling->output_size, video_source_settings.input_transform_mode
+            );
+            video_source_settings.decode_target_width_px = decode_target_size.width;
+            video_source_settings.decode_target_height_px = decode_target_size.height;
+        }
+        MP_ASSIGN_OR_RETURN(this->video_source, video_source::BuildVideoSource(video_source_settings));
+    }
+    MP_RETURN_IF_ERROR(this->NegotiateInputPixelFormat());
 
     MP_RETURN_IF_ERROR(init::InitializeGui(this->settings, kWindowName));
     // legacy behavior: assume user wants to start with recording=on when a video file is supplied.
@@ -182,6 +368,30 @@ absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
     return absl::OkStatus();
 }
 
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::NegotiateInputPixelFormat() {
+    auto supported_pixel_formats = this->video_source->GetSupportedPixelFormats();
+    auto supports = [&supported_pixel_formats](video_source::PixelFormat pixel_format) {
+        return std::find(supported_pixel_formats.begin(), supported_pixel_formats.end(), pixel_format) !=
+               supported_pixel_formats.end();
+    };
+    // RGB frames go into the graph as they are, without a conversion pass or a copy; any other format gets converted
+    // into the ImageFrame, which the source would otherwise have had to do for BGR anyway.
+    video_source::PixelFormat pixel_format = video_source::PixelFormat::BGR;
+    if (supports(video_source::PixelFormat::RGB)) {
+        pixel_format = video_source::PixelFormat::RGB;
+    } else if (!supports(video_source::PixelFormat::BGR) && !supported_pixel_formats.empty()) {
+        pixel_format = supported_pixel_formats.front();
+    }
+    if (pixel_format != this->video_source->GetOutputPixelFormat()) {
+        MP_RETURN_IF_ERROR(this->video_source->SetOutputPixelFormat(pixel_format));
+    }
+    if (this->settings.verbosity_level > 0) {
+        LOG(INFO) << "Video source pixel format: " << video_source::AbslUnparseFlag(pixel_format);
+    }
+    return absl::OkStatus();
+}
+
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
 void ForegroundContainer<TDeviceType,
     TOperationMode,
@@ -195,6 +405,14 @@ void ForegroundContainer<TDeviceType,
             // calculate correct recording start time
             int64_t frame_timestamp = this->video_source->GetFrameTimestamp();
             int64_t recording_start_time = frame_timestamp + this->settings.start_time_offset_ms * 1e3;
+            absl::Status seek_status = this->video_source->Seek(recording_start_time);
+            if (seek_status.ok()) {
+                return;
+            }
+            if (!absl::IsUnimplemented(seek_status)) {
+                LOG(WARNING) << "Failed to seek to the start time offset (" << seek_status
+                             << "), skipping frames one at a time instead.";
+            }
             // skip frames until recording time is reached
             while ((frame_timestamp < recording_start_time) && !camera_frame_raw.empty()) {
                 *(this->video_source) >> camera_frame_raw;
@@ -205,204 +423,342 @@ void ForegroundContainer<TDeviceType,
 }
 
 template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
-absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::Run() {
-    this->operation_context.Reset();
-    if (!this->initialized) {
-        return absl::PermissionDeniedError("Client not initialized.");
+settings::FrameQueueOverflowPolicy
+ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::GetFrameQueueOverflowPolicy() const {
+    auto policy = this->settings.frame_pipeline.overflow_policy;
+    if (policy == settings::FrameQueueOverflowPolicy::Unknown_EnumEnd) {
+        // prerecorded input has no sensor cadence to keep up with, so frames shouldn't be lost to queue overflow
+        policy = this->IsInputPrerecorded() ? settings::FrameQueueOverflowPolicy::Block
+                                            : settings::FrameQueueOverflowPolicy::DropOldest;
     }
-    this->running = true;
-    LOG(INFO) << "Set up output pollers.";
-
-    //TODO: check that callbacks aren't nullptr (potentially, move the checks out into container base class and call
-    // from both here and background container's StartGraph, instead of duplicating the code that's already there.)
-
-    MP_ASSIGN_OR_RETURN(mediapipe::OutputStreamPoller output_video_poller,
-                        this->graph.AddOutputStreamPoller(pe::graph::output_streams::kOutputVideo));
-    MP_ASSIGN_OR_RETURN(mediapipe::OutputStreamPoller status_code_poller,
-                        this->graph.AddOutputStreamPoller(pe::graph::output_streams::kStatusCode));
-    MP_ASSIGN_OR_RETURN(mediapipe::OutputStreamPoller blue_tooth_poller,
-                        this->graph.AddOutputStreamPoller(pe::graph::output_streams::kBlueTooth));
-
-    // frame rate diagnostics
-    MP_ASSIGN_OR_RETURN(mediapipe::OutputStreamPoller frame_sent_through_poller,
-                        this->graph.AddOutputStreamPoller(pe::graph::output_streams::kFrameSentThrough));
-
-
-    MP_RETURN_IF_ERROR(this->InitializeOutputDataPollers());
-
-    MP_RETURN_IF_ERROR(this->operation_context.InitializePollers(this->graph));
+    return policy;
+}
 
-    LOG(INFO) << "Start running the calculator graph.";
-    MP_RETURN_IF_ERROR(this->graph.StartRun({}));
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+bool ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::IsInputPrerecorded() const {
+    return this->load_video || !this->settings.video_source.file_stream_path.empty();
+}
 
-    LOG(INFO) << "Start to grab and process frames.";
-    this->keep_grabbing_frames = true;
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::ControlVideoSource(
+    std::function<absl::Status(video_source::VideoSource&)> control
+) {
+    std::lock_guard<std::mutex> lock(this->video_source_mutex);
+    if (this->capture_stage_owns_video_source) {
+        this->pending_video_source_controls.push_back(std::move(control));
+        return absl::OkStatus();
+    }
+    return control(*this->video_source);
+}
 
-    double blue_tooth;
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::ApplyPendingVideoSourceControls() {
+    std::vector<std::function<absl::Status(video_source::VideoSource&)>> controls;
+    {
+        std::lock_guard<std::mutex> lock(this->video_source_mutex);
+        controls.swap(this->pending_video_source_controls);
+    }
+    for (auto& control: controls) {
+        MP_RETURN_IF_ERROR(control(*this->video_source));
+    }
+    return absl::OkStatus();
+}
 
+/**
+ * Capture stage of the frame pipeline, runs on its own thread.
+ * @param captured_frames queue leading to the conversion/feed stage
+ * @param policy what to do when the queue is full
+ * @return status of the capture stage
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::CaptureFrames(
+    FrameRing<CapturedFrame>& captured_frames,
+    settings::FrameQueueOverflowPolicy policy
+) {
 #ifdef BENCHMARK_CAMERA_CAPTURE
     int64_t i_frame = 0;
     std::chrono::duration<double> interval_capture_time(0.);
     std::chrono::duration<double> interval_frame_time(0.);
     int64 frame_interval = 30;
 #endif
-
-    //TODO: this function needs to be moved into VideoSourceInterface and implemented in related subclasses.
-    // This way, video sources such as CaptureVideoFileSource can do the scrolling, whereas other sources
-    // can ignore the command (still not sure what FileStreamVideoSource should do for scroll behavior).
-    this->ScrollPastTimeOffset();
-
-    physiology::StatusCode previous_status_code = physiology::StatusCode::PROCESSING_NOT_STARTED;
-
-    // loop over frames
+    // Leave the input transform to the conversion/feed stage, which fuses it with the conversion to RGB, unless the
+    // captured frames get recorded as they are.
+    bool defer_input_transform = true;
+#ifdef WITH_VIDEO_OUTPUT
+    defer_input_transform = !(this->stream_writer.isOpened() && this->settings.video_sink.passthrough);
+#endif
+    this->frame_pacer.Reset();
     while (this->keep_grabbing_frames) {
-        cv::Mat camera_frame_raw;
+        this->frame_pacer.WaitForNextFrame();
+        CapturedFrame captured_frame;
 #ifdef BENCHMARK_CAMERA_CAPTURE
         auto frame_loop_start = std::chrono::high_resolution_clock::now();
 #endif
-        // Capture frame from camera or video.
-        *this->video_source >> camera_frame_raw;
-#ifdef WITH_VIDEO_OUTPUT
-        if (this->stream_writer.isOpened() && this->settings.video_sink.passthrough) {
-                  this->stream_writer.write(camera_frame_raw);
+        {
+            // Capture frame from camera or video.
+            ScopedTimer capture_timer(this->metrics.capture_seconds);
+            MP_RETURN_IF_ERROR(this->ApplyPendingVideoSourceControls());
+            if (defer_input_transform) {
+                this->video_source->ReadPreTransformFrame(captured_frame.frame);
+            } else {
+                *this->video_source >> captured_frame.frame;
+            }
+            if (!captured_frame.frame.empty()) {
+                captured_frame.timestamp = this->video_source->GetFrameTimestamp();
+                captured_frame.pixel_format = this->video_source->GetOutputPixelFormat();
+                if (defer_input_transform) {
+                    captured_frame.input_transform = this->video_source->GetInputTransformMode();
+                }
+            }
         }
-#endif
 #ifdef BENCHMARK_CAMERA_CAPTURE
         auto frame_capture_end = std::chrono::high_resolution_clock::now();
 #endif
-        if (camera_frame_raw.empty()) {
+        if (captured_frame.frame.empty()) {
             LOG(INFO) << "Encountered empty frame: assuming end of video or stream reached.";
             this->keep_grabbing_frames = false;
-        } else {
-            // === got new frame, now process it and handle output ===
-
-            // compute timestamp
-            int64_t frame_timestamp = this->video_source->GetFrameTimestamp();
-            auto mp_frame_timestamp = mediapipe::Timestamp(frame_timestamp);
-            this->AddFrameTimestampToBenchmarkingInfo(mp_frame_timestamp);
-
-            // === handle output
-            cv::Mat camera_frame;
-            cv::cvtColor(camera_frame_raw, camera_frame, cv::COLOR_BGR2RGB);
-
-            // Wrap Mat into an ImageFrame.
-            auto input_frame = absl::make_unique<mediapipe::ImageFrame>(
-                mediapipe::ImageFormat::SRGB, camera_frame.cols, camera_frame.rows,
-                mediapipe::ImageFrame::kDefaultAlignmentBoundary
-            );
-            cv::Mat input_frame_mat = mediapipe::formats::MatView(input_frame.get());
-            // transfer camera_frame data to input_frame
-            camera_frame.copyTo(input_frame_mat);
-
-            // Send recording state to the graph.
-            MP_RETURN_IF_ERROR(
-                this->graph
-                    .AddPacketToInputStream(
-                        pe::graph::input_streams::kRecording,
-                        mediapipe::MakePacket<bool>(this->recording).At(mp_frame_timestamp)
-                    )
-            );
-            // Send image packet into the graph.
-            MP_RETURN_IF_ERROR(
-                it::FeedFrameToGraph(std::move(input_frame), this->graph, this->device_context, frame_timestamp,
-                                     pe::graph::input_streams::kInputVideo)
-            );
-
-            // region ========================================== HANDLE GRAPH OUTPUT ===================================
-            // Get the graph video output packet, or stop if that fails.
-            mediapipe::Packet output_video_packet;
-            if (output_video_poller.QueueSize() > 0) {
-                if (!output_video_poller.Next(&output_video_packet)) break;
-                cv::Mat output_frame_rgb;
-                MP_RETURN_IF_ERROR(it::GetFrameFromPacket<TDeviceType>(output_frame_rgb,
-                                                                       this->device_context,
-                                                                       output_video_packet));
-
-                // Convert to BGR and display.
-                cv::cvtColor(output_frame_rgb, this->output_frame_bgr, cv::COLOR_RGB2BGR);
-
-                // Envoke Callback on the video
-                MP_RETURN_IF_ERROR(this->OnVideoOutput(this->output_frame_bgr, frame_timestamp));
-
-                // only display output window when we're not in headless mode.
-                if (!this->settings.headless) {
-                    cv::imshow(kWindowName, this->output_frame_bgr);
-                }
+            break;
+        }
+        if (this->metrics.frames_captured != nullptr) {
+            this->metrics.frames_captured->Increment();
+        }
 #ifdef WITH_VIDEO_OUTPUT
-                if (this->stream_writer.isOpened() && !this->settings.video_sink.passthrough) {
-                  this->stream_writer.write(output_frame_bgr);
+        if (this->stream_writer.isOpened() && this->settings.video_sink.passthrough) {
+            if (captured_frame.pixel_format == video_source::PixelFormat::BGR) {
+                this->stream_writer.write(captured_frame.frame);
+            } else {
+                // the writer expects BGR
+                cv::Mat passthrough_frame_bgr;
+                switch (captured_frame.pixel_format) {
+                    case video_source::PixelFormat::YUYV:
+                        cv::cvtColor(captured_frame.frame, passthrough_frame_bgr, cv::COLOR_YUV2BGR_YUYV);
+                        break;
+                    case video_source::PixelFormat::NV12:
+                        cv::cvtColor(captured_frame.frame, passthrough_frame_bgr, cv::COLOR_YUV2BGR_NV12);
+                        break;
+                    default:
+                        cv::cvtColor(captured_frame.frame, passthrough_frame_bgr, cv::COLOR_RGB2BGR);
+                        break;
                 }
+                this->stream_writer.write(passthrough_frame_bgr);
+            }
+        }
 #endif
+        auto push_result = captured_frames.Push(std::move(captured_frame), policy, this->keep_grabbing_frames);
+        if (push_result == FrameRing<CapturedFrame>::PushResult::PushedAfterDroppingOldest ||
+            push_result == FrameRing<CapturedFrame>::PushResult::DroppedNewest) {
+            int64_t dropped_frame_count = ++this->frames_dropped_from_capture_queue;
+            if (this->metrics.frames_dropped_from_capture_queue != nullptr) {
+                this->metrics.frames_dropped_from_capture_queue->Increment();
             }
-
-            bool got_status_code_packet;
-            physiology::StatusValue status_value;
-            MP_RETURN_IF_ERROR(ph::GetPacketContentsIfAny(
-                status_value, got_status_code_packet, status_code_poller, pe::graph::output_streams::kStatusCode,
-                this->settings.verbosity_level > 2
-            ));
-
-            if (got_status_code_packet){
-                this->status = status_value;
-                if (this->status.value() != previous_status_code) {
-                    MP_RETURN_IF_ERROR(this->OnStatusChange(this->status));
-                    previous_status_code = this->status.value();
-                }
+            if (this->settings.verbosity_level > 2) {
+                LOG(INFO) << "Capture queue full, dropped a frame (" << dropped_frame_count << " dropped so far).";
             }
+        }
+#ifdef BENCHMARK_CAMERA_CAPTURE
+        MP_RETURN_IF_ERROR(
+            bench::HandleCameraBenchmarking(
+                i_frame, interval_capture_time, interval_frame_time, frame_loop_start, frame_capture_end,
+                frame_interval, /*interframe_delay_ms=*/0, this->settings.verbosity_level
+            )
+        );
+#endif
+    }
+    return absl::OkStatus();
+}
 
-            bool got_blue_tooth_packet;
-            MP_RETURN_IF_ERROR(ph::GetPacketContentsIfAny(
-                blue_tooth, got_blue_tooth_packet, blue_tooth_poller, pe::graph::output_streams::kBlueTooth,
-                this->settings.verbosity_level > 0
-            ));
-
-            bool operation_state_changed;
-            MP_RETURN_IF_ERROR(this->operation_context
-                                   .QueryPollers(operation_state_changed, this->settings.verbosity_level > 1));
-
-            bool got_frame_sent_through_packet;
-            bool frame_sent_through;
-            mediapipe::Timestamp frame_sent_through_timestamp;
-            MP_RETURN_IF_ERROR(ph::GetPacketContentsIfAny(
-                frame_sent_through, got_frame_sent_through_packet, frame_sent_through_poller,
-                pe::graph::output_streams::kFrameSentThrough, frame_sent_through_timestamp,
-                this->settings.verbosity_level > 4
-            ));
-            if(got_frame_sent_through_packet){
-                MP_RETURN_IF_ERROR(this->OnFrameSentThrough(frame_sent_through, frame_sent_through_timestamp.Value()));
+/**
+ * Conversion/feed stage of the frame pipeline, runs on its own thread.
+ * @param captured_frames queue coming from the capture stage
+ * @return status of the conversion/feed stage
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::FeedFrames(
+    FrameRing<CapturedFrame>& captured_frames
+) {
+    constexpr auto kQueueWaitTimeout = std::chrono::milliseconds(10);
+    CapturedFrame captured_frame;
+    while (true) {
+        if (!captured_frames.WaitPop(captured_frame, kQueueWaitTimeout)) {
+            // drain whatever the capture stage managed to queue up before it finished
+            if (this->capture_finished && captured_frames.Size() == 0) {
+                break;
             }
+            continue;
+        }
+        if (this->metrics.capture_queue_depth != nullptr) {
+            this->metrics.capture_queue_depth->Set(static_cast<int64_t>(captured_frames.Size()));
+        }
+        int64_t frame_timestamp = captured_frame.timestamp;
+        auto mp_frame_timestamp = mediapipe::Timestamp(frame_timestamp);
+        this->AddFrameTimestampToBenchmarkingInfo(mp_frame_timestamp);
+
+        // Transform & convert the camera frame to RGB directly inside the ImageFrame that gets sent to the graph (or,
+        // if the source already produces untransformed RGB, hand its buffer over as is).
+        cv::Mat frame_to_ingest = captured_frame.frame;
+        // the tracker works on frames as the graph sees them, i.e. after the (possibly deferred) input transform
+        const cv::Size transformed_frame_size =
+            video_source::GetTransformedFrameSize(captured_frame.frame.size(), captured_frame.input_transform);
+        cv::Rect roi(0, 0, transformed_frame_size.width, transformed_frame_size.height);
+        // packed YUV frames can't be cropped by just narrowing down the view, those always go in full
+        if (this->settings.roi_crop.enabled && captured_frame.frame.type() == CV_8UC3) {
+            roi = this->face_roi_tracker.GetCrop(transformed_frame_size, frame_timestamp);
+            frame_to_ingest = captured_frame.frame(
+                video_source::GetUntransformedRect(roi, captured_frame.frame.size(), captured_frame.input_transform)
+            );
+        }
+        MP_ASSIGN_OR_RETURN(
+            auto input_frame,
+            this->IngestFrame(frame_to_ingest, captured_frame.pixel_format, captured_frame.input_transform)
+        );
+        if (this->settings.roi_crop.enabled || this->graph_input_scaling.has_value()) {
+            this->ingested_frame_map.RecordIngestedFrame(
+                frame_timestamp, roi, cv::Size(input_frame->Width(), input_frame->Height())
+            );
+        }
+        frame_to_ingest.release();
+        captured_frame.frame.release();
+
+        ScopedTimer feed_timer(this->metrics.feed_seconds);
+        // Send recording state to the graph.
+        MP_RETURN_IF_ERROR(this->graph.AddPacketToInputStream(
+            pe::graph::input_streams::kRecording, this->GetRecordingPacket(mp_frame_timestamp)
+        ));
+        // Send image packet into the graph.
+        MP_RETURN_IF_ERROR(
+            it::FeedFrameToGraph(std::move(input_frame), this->graph, this->device_context, frame_timestamp,
+                                 pe::graph::input_streams::kInputVideo)
+        );
+        feed_timer.Stop();
+        if (this->metrics.frames_fed != nullptr) {
+            this->metrics.frames_fed->Increment();
+        }
+    }
+    return absl::OkStatus();
+}
 
-            MP_RETURN_IF_ERROR(this->HandleOutputData(frame_timestamp));
-
-            // endregion ===============================================================================================
-            if (this->settings.headless) {
-                if (!this->load_video) {
-                    // if we loaded video, that means we started recording already.
-                    // Otherwise, start recording iff status code is OK
-                    if (!this->recording && this->status.value() == physiology::StatusCode::OK) {
-                        if (this->settings.video_source.auto_lock && this->video_source->SupportsExposureControls()) {
-                            return this->video_source->TurnOffAutoExposure();
+/**
+ * Output stage of the frame pipeline, runs on the thread that called Run() (GUI calls need to stay there).
+ * Dispatches graph output as soon as it arrives, regardless of input frame cadence.
+ * @return status of the output stage
+ */
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::HandleGraphOutput() {
+    // upper bound on how long to wait for graph output before checking for shutdown; the feed stage wakes us up anyway
+    constexpr auto kOutputWaitTimeout = std::chrono::milliseconds(100);
+    // in GUI mode, cv::waitKey does the waiting (and also keeps the window responsive)
+    constexpr int kGuiRefreshIntervalMs = 1;
+
+    while (!this->feeding_finished) {
+        MP_RETURN_IF_ERROR(this->output_stream_multiplexer.DispatchPending(
+            this->settings.headless ? kOutputWaitTimeout : std::chrono::milliseconds(0)
+        ).status());
+        if (!this->settings.headless) {
+            const int pressed_key = cv::waitKey(kGuiRefreshIntervalMs);
+            if (pressed_key != -1) {
+                // keys may act on the video source, so they take effect once the capture stage is between frames
+                MP_RETURN_IF_ERROR(this->ControlVideoSource(
+                    [this, pressed_key, status = this->status](video_source::VideoSource& video_source) {
+                        bool keep_grabbing_frames_after_key = this->keep_grabbing_frames;
+                        bool recording_after_key = this->recording;
+                        MP_RETURN_IF_ERROR(keys::HandlePressedKey(
+                            pressed_key, keep_grabbing_frames_after_key, recording_after_key, video_source,
+                            this->settings, status
+                        ));
+                        this->recording = recording_after_key;
+                        if (!keep_grabbing_frames_after_key) {
+                            this->keep_grabbing_frames = false;
                         }
-                        this->recording = true;
-                        LOG(INFO) << "====== Recording started after timestamp:" << frame_timestamp << " ======";
+                        return absl::OkStatus();
                     }
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(this->settings.interframe_delay_ms));
-            } else {
-                MP_RETURN_IF_ERROR(keys::HandleKeyboardInput(
-                    this->keep_grabbing_frames, this->recording, *(this->video_source), this->settings, this->status
                 ));
             }
         }
+    }
+    return absl::OkStatus();
+}
 
-#ifdef BENCHMARK_CAMERA_CAPTURE
-        MP_RETURN_IF_ERROR(
-            bench::HandleCameraBenchmarking(
-                i_frame, interval_capture_time, interval_frame_time, frame_loop_start, frame_capture_end,
-                frame_interval, this->settings.interframe_delay_ms, this->settings.verbosity_level
-            )
-        );
-#endif
+template<platform_independence::DeviceType TDeviceType, settings::OperationMode TOperationMode, settings::IntegrationMode TIntegrationMode>
+absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>::Run() {
+    this->operation_context.Reset();
+    if (!this->initialized) {
+        return absl::PermissionDeniedError("Client not initialized.");
+    }
+    this->running = true;
+    LOG(INFO) << "Set up output stream observers.";
+
+    MP_RETURN_IF_ERROR(this->ObserveOutputStreams());
+
+    LOG(INFO) << "Start running the calculator graph.";
+    MP_RETURN_IF_ERROR(this->graph.StartRun({}));
+
+    LOG(INFO) << "Start to grab and process frames.";
+    this->keep_grabbing_frames = true;
+    this->capture_finished = false;
+    this->feeding_finished = false;
+    this->frames_dropped_from_capture_queue = 0;
+    this->previous_status_code = physiology::StatusCode::PROCESSING_NOT_STARTED;
+
+    this->ScrollPastTimeOffset();
+
+    // === frame pipeline: capture thread -> conversion/feed thread -> graph -> output handling on this thread ===
+    const auto overflow_policy = this->GetFrameQueueOverflowPolicy();
+    FrameRing<CapturedFrame> captured_frames(std::max(1, this->settings.frame_pipeline.frame_queue_capacity));
+    const bool fast_replay = this->settings.frame_pacing.fast_replay && this->IsInputPrerecorded();
+    if (this->settings.frame_pacing.fast_replay && !fast_replay) {
+        LOG(WARNING) << "Fast replay only applies to prerecorded input, pacing camera frames as usual.";
+    }
+    this->frame_pacer.SetReplayMode(fast_replay);
+    if (this->settings.verbosity_level > 0) {
+        LOG(INFO) << "Capture queue capacity: " << captured_frames.Capacity() << ", overflow policy: "
+                  << settings::AbslUnparseFlag(overflow_policy) << ", target capture rate: "
+                  << (fast_replay ? std::string("as fast as the graph takes frames in")
+                                  : std::to_string(this->frame_pacer.GetTargetFps()) + " FPS") << ".";
+    }
+
+    absl::Status capture_status;
+    absl::Status feed_status;
+    {
+        std::lock_guard<std::mutex> lock(this->video_source_mutex);
+        this->capture_stage_owns_video_source = true;
+    }
+    std::thread capture_thread([&] {
+        capture_status = this->CaptureFrames(captured_frames, overflow_policy);
+        {
+            // apply whatever got queued up too late for the capture stage to pick up
+            std::lock_guard<std::mutex> lock(this->video_source_mutex);
+            this->capture_stage_owns_video_source = false;
+            for (auto& control: this->pending_video_source_controls) {
+                absl::Status control_status = control(*this->video_source);
+                if (!control_status.ok()) {
+                    LOG(WARNING) << "Failed to control the video source: " << control_status.message();
+                }
+            }
+            this->pending_video_source_controls.clear();
+        }
+        if (!capture_status.ok()) {
+            this->keep_grabbing_frames = false;
+        }
+        this->capture_finished = true;
+        captured_frames.WakeUp();
+    });
+    std::thread feed_thread([&] {
+        feed_status = this->FeedFrames(captured_frames);
+        this->keep_grabbing_frames = false;
+        this->feeding_finished = true;
+        this->output_stream_multiplexer.WakeUp();
+        // unblock the capture stage if it is waiting on a full queue
+        captured_frames.WakeUp();
+    });
+
+    absl::Status output_status = this->HandleGraphOutput();
+    this->keep_grabbing_frames = false;
+    captured_frames.WakeUp();
+    capture_thread.join();
+    feed_thread.join();
+
+    if (this->settings.verbosity_level > 0 && this->frames_dropped_from_capture_queue > 0) {
+        LOG(INFO) << "Frames dropped due to capture queue overflow: " << this->frames_dropped_from_capture_queue;
     }
 
     LOG(INFO) << "Shutting down.";
@@ -414,7 +770,13 @@ absl::Status ForegroundContainer<TDeviceType, TOperationMode, TIntegrationMode>:
     }
 #endif
     MP_RETURN_IF_ERROR(this->graph.WaitUntilDone());
+    if (output_status.ok()) {
+        // deliver output the graph produced while shutting down
+        output_status = this->output_stream_multiplexer.DispatchPending(std::chrono::milliseconds(0)).status();
+    }
     this->running = false;
-    return absl::OkStatus();
+    MP_RETURN_IF_ERROR(capture_status);
+    MP_RETURN_IF_ERROR(feed_status);
+    return output_status;
 }
 } // namespace presage::smartspectra::container
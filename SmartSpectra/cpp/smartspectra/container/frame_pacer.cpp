@@ -0,0 +1,191 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <string>
+#include <thread>
+#ifdef __linux__
+#include <time.h>
+#endif
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+// === local includes (if any) ===
+#include "frame_pacer.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+constexpr int64_t kNanosecondsPerSecond = 1000000000;
+// shortest delay inserted between replayed frames after the graph drops one
+constexpr int64_t kMinimumReplayDelayNs = 1000000;
+// the graph doesn't report on frames it never got to see (e.g. on shutdown), so don't wait on a report forever
+constexpr auto kReplayReportTimeout = std::chrono::seconds(1);
+
+int64_t MonotonicNowNs() {
+    // steady_clock is CLOCK_MONOTONIC on Linux, which is also what the deadlines are slept against
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+void SleepUntilNs(int64_t deadline_ns) {
+#ifdef __linux__
+    timespec deadline{};
+    deadline.tv_sec = static_cast<time_t>(deadline_ns / kNanosecondsPerSecond);
+    deadline.tv_nsec = static_cast<long>(deadline_ns % kNanosecondsPerSecond);
+    // restart after signal interruptions: the deadline is absolute, so no time accounting is needed
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR) {}
+#else
+    std::this_thread::sleep_until(
+        std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline_ns))
+    );
+#endif
+}
+
+} // anonymous namespace
+
+FramePacer::FramePacer(const settings::FramePacingSettings& settings, int fallback_interframe_delay_ms)
+    : settings(settings),
+      target_fps(settings.target_fps > 0 ? settings.target_fps
+                                         : 1000.0 / std::max(1, fallback_interframe_delay_ms)),
+      current_fps(0.0),
+      frame_period_ns(0) {
+    SetCurrentFps(this->target_fps);
+}
+
+void FramePacer::Reset() {
+    this->next_deadline_ns = MonotonicNowNs();
+    {
+        std::lock_guard<std::mutex> lock(this->adaptation_mutex);
+        this->window_frame_count = 0;
+        this->window_dropped_frame_count = 0;
+    }
+    std::lock_guard<std::mutex> lock(this->replay_mutex);
+    this->replay_mode_active = this->replay_mode;
+    this->frames_awaiting_report = 0;
+    this->replay_delay_ns = 0;
+}
+
+void FramePacer::SetReplayMode(bool replay_mode) {
+    std::lock_guard<std::mutex> lock(this->replay_mutex);
+    this->replay_mode = replay_mode;
+}
+
+void FramePacer::WaitForNextFrame() {
+    if (this->replay_mode_active.load(std::memory_order_relaxed)) {
+        this->WaitForGraphToReport();
+        return;
+    }
+    const int64_t frame_period = this->frame_period_ns.load(std::memory_order_relaxed);
+    if (this->next_deadline_ns == 0) {
+        this->next_deadline_ns = MonotonicNowNs();
+    }
+    this->next_deadline_ns += frame_period;
+    const int64_t now = MonotonicNowNs();
+    if (now - this->next_deadline_ns > frame_period) {
+        // fell behind by over a period (e.g., the video source blocked): resynchronize instead of bursting frames
+        this->next_deadline_ns = now;
+        return;
+    }
+    if (this->next_deadline_ns > now) {
+        SleepUntilNs(this->next_deadline_ns);
+    }
+}
+
+void FramePacer::RecordFrameSentThrough(bool frame_sent_through) {
+    if (this->replay_mode_active.load(std::memory_order_relaxed)) {
+        this->RecordReplayedFrameSentThrough(frame_sent_through);
+        return;
+    }
+    if (!this->settings.adaptive) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(this->adaptation_mutex);
+    this->window_frame_count++;
+    if (!frame_sent_through) {
+        this->window_dropped_frame_count++;
+    }
+    if (this->window_frame_count < std::max(1, this->settings.adaptation_window_frame_count)) {
+        return;
+    }
+    const double drop_ratio =
+        static_cast<double>(this->window_dropped_frame_count) / static_cast<double>(this->window_frame_count);
+    this->window_frame_count = 0;
+    this->window_dropped_frame_count = 0;
+
+    const double fps = this->current_fps.load(std::memory_order_relaxed);
+    double adjusted_fps = fps;
+    if (drop_ratio > this->settings.backoff_drop_ratio) {
+        adjusted_fps = std::max(this->settings.minimum_fps, fps * this->settings.backoff_factor);
+    } else if (drop_ratio <= this->settings.recovery_drop_ratio) {
+        adjusted_fps = std::min(this->target_fps.load(std::memory_order_relaxed),
+                                fps + this->settings.recovery_step_fps);
+    }
+    if (adjusted_fps != fps) {
+        SetCurrentFps(adjusted_fps);
+        LOG(INFO) << "Frame pacer: graph drop ratio " << drop_ratio << ", pacing frames at " << adjusted_fps
+                  << " FPS.";
+    }
+}
+
+absl::Status FramePacer::SetTargetFps(double target_fps) {
+    if (!(target_fps > 0.0)) {
+        return absl::InvalidArgumentError("Target FPS must be positive, got: " + std::to_string(target_fps));
+    }
+    this->target_fps = target_fps;
+    SetCurrentFps(target_fps);
+    return absl::OkStatus();
+}
+
+double FramePacer::GetTargetFps() const {
+    return this->target_fps.load(std::memory_order_relaxed);
+}
+
+double FramePacer::GetCurrentFps() const {
+    return this->current_fps.load(std::memory_order_relaxed);
+}
+
+void FramePacer::SetCurrentFps(double fps) {
+    this->current_fps = fps;
+    this->frame_period_ns = static_cast<int64_t>(static_cast<double>(kNanosecondsPerSecond) / fps);
+}
+
+void FramePacer::WaitForGraphToReport() {
+    int64_t delay_ns;
+    {
+        std::unique_lock<std::mutex> lock(this->replay_mutex);
+        this->frame_reported.wait_for(lock, kReplayReportTimeout, [this] { return this->frames_awaiting_report == 0; });
+        this->frames_awaiting_report = 1;
+        delay_ns = this->replay_delay_ns;
+    }
+    if (delay_ns > 0) {
+        SleepUntilNs(MonotonicNowNs() + delay_ns);
+    }
+}
+
+void FramePacer::RecordReplayedFrameSentThrough(bool frame_sent_through) {
+    {
+        std::lock_guard<std::mutex> lock(this->replay_mutex);
+        this->frames_awaiting_report = std::max(0, this->frames_awaiting_report - 1);
+        if (frame_sent_through) {
+            this->replay_delay_ns = this->replay_delay_ns / 2 < kMinimumReplayDelayNs ? 0 : this->replay_delay_ns / 2;
+        } else {
+            // never wait longer than pacing at the minimum frame rate would
+            const int64_t maximum_delay_ns = static_cast<int64_t>(
+                static_cast<double>(kNanosecondsPerSecond) / std::max(this->settings.minimum_fps, 1.0)
+            );
+            this->replay_delay_ns =
+                std::min(std::max(kMinimumReplayDelayNs, this->replay_delay_ns * 2), maximum_delay_ns);
+        }
+    }
+    this->frame_reported.notify_one();
+}
+
+} // namespace presage::smartspectra::container
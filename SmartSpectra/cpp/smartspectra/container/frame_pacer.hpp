@@ -0,0 +1,94 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+// === third-party includes (if any) ===
+#include <absl/status/status.h>
+// === local includes (if any) ===
+#include "settings.hpp"
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Paces frame capture against absolute deadlines at an adaptive target frame rate.
+ *
+ * Unlike sleeping for a fixed delay after each frame, waiting for absolute deadlines (clock_nanosleep with
+ * TIMER_ABSTIME on Linux) keeps the frame rate independent of how long each frame takes to process.
+ *
+ * When adaptive pacing is on, the current rate is adjusted from the graph's frame-sent-through reports over fixed-size
+ * windows: it is cut multiplicatively when the graph drops too many frames and raised additively (up to the target)
+ * while the graph keeps up.
+ *
+ * In replay mode (for prerecorded input), there is no frame rate: each frame is let through as soon as the graph has
+ * reported on the previous one. Since a frame the graph drops means it is still busy, every drop doubles a delay
+ * inserted before the next frame, and every frame let through halves it.
+ *
+ * WaitForNextFrame is meant to be called from a single (capture) thread; everything else is thread-safe.
+ */
+class FramePacer {
+public:
+    /**
+     * @param settings pacing settings
+     * @param fallback_interframe_delay_ms frame period to use when settings.target_fps isn't positive
+     */
+    FramePacer(const settings::FramePacingSettings& settings, int fallback_interframe_delay_ms);
+
+    /** Restart pacing, using the current time as the first deadline. */
+    void Reset();
+
+    /** Switch replay mode on or off; takes effect on the next Reset(). */
+    void SetReplayMode(bool replay_mode);
+
+    /**
+     * Sleep until the next frame deadline. Deadlines that are already more than a period late are skipped.
+     * In replay mode, wait for the graph to report on the previous frame instead.
+     */
+    void WaitForNextFrame();
+
+    /** Feed back whether the graph let a frame through or dropped it. */
+    void RecordFrameSentThrough(bool frame_sent_through);
+
+    /** Change the target frame rate at runtime; the current rate is reset to the new target. */
+    absl::Status SetTargetFps(double target_fps);
+
+    /** Upper limit of the paced frame rate. */
+    double GetTargetFps() const;
+
+    /** Frame rate currently used for pacing (equal to the target unless adaptive pacing backed off). */
+    double GetCurrentFps() const;
+
+private:
+    void SetCurrentFps(double fps);
+    void WaitForGraphToReport();
+    void RecordReplayedFrameSentThrough(bool frame_sent_through);
+
+    const settings::FramePacingSettings settings;
+    std::atomic<double> target_fps;
+    std::atomic<double> current_fps;
+    std::atomic<int64_t> frame_period_ns;
+    // next deadline on the monotonic clock; only touched by the pacing thread
+    int64_t next_deadline_ns = 0;
+
+    // adaptation window
+    std::mutex adaptation_mutex;
+    int window_frame_count = 0;
+    int window_dropped_frame_count = 0;
+
+    // replay mode
+    bool replay_mode = false;
+    std::atomic<bool> replay_mode_active = false;
+    std::mutex replay_mutex;
+    std::condition_variable frame_reported;
+    int frames_awaiting_report = 0;
+    int64_t replay_delay_ns = 0;
+};
+
+} // namespace presage::smartspectra::container
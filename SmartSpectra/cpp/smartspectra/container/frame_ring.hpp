@@ -0,0 +1,209 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "settings.hpp"
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Bounded lock-free ring connecting two pipeline stages (one producer thread, one consumer thread).
+ *
+ * Each slot carries a sequence number (Vyukov-style), so that, in addition to the consumer, the producer itself can
+ * safely pop the oldest entry when the ring is full. That is what makes the drop-oldest overflow policy possible
+ * without locks. The data path never locks; a mutex/condition variable pair is only touched to park a consumer
+ * waiting on an empty ring (or a producer waiting on a full ring under the block policy).
+ *
+ * @tparam T entry type, must be default-constructible and movable
+ */
+template<typename T>
+class FrameRing {
+public:
+    enum class PushResult {
+        Pushed,
+        PushedAfterDroppingOldest,
+        DroppedNewest,
+        Aborted
+    };
+
+    /**
+     * @param minimum_capacity requested capacity, rounded up to the nearest power of two
+     */
+    explicit FrameRing(size_t minimum_capacity) : capacity(RoundUpToPowerOfTwo(minimum_capacity)),
+                                                  mask(capacity - 1),
+                                                  slots(std::make_unique<Slot[]>(capacity)) {
+        for (size_t i_slot = 0; i_slot < capacity; i_slot++) {
+            slots[i_slot].sequence.store(i_slot, std::memory_order_relaxed);
+        }
+    }
+
+    FrameRing(const FrameRing&) = delete;
+    FrameRing& operator=(const FrameRing&) = delete;
+
+    /** Attempt to add an entry without blocking. */
+    bool TryPush(T&& entry) {
+        size_t position = enqueue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+                if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.entry = std::move(entry);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    WakeUp();
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // full
+            } else {
+                position = enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /** Attempt to take the oldest entry without blocking. Safe to call from both the consumer and the producer. */
+    bool TryPop(T& entry) {
+        size_t position = dequeue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0) {
+                if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    entry = std::move(slot.entry);
+                    slot.entry = T();
+                    slot.sequence.store(position + mask + 1, std::memory_order_release);
+                    WakeUp();
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false; // empty
+            } else {
+                position = dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Add an entry, resolving a full ring according to the given policy.
+     * @param keep_running checked while blocking; the push is aborted once it becomes false
+     */
+    PushResult Push(T&& entry, settings::FrameQueueOverflowPolicy policy, const std::atomic<bool>& keep_running) {
+        if (TryPush(std::move(entry))) {
+            return PushResult::Pushed;
+        }
+        switch (policy) {
+            case settings::FrameQueueOverflowPolicy::DropNewest:
+                return PushResult::DroppedNewest;
+            case settings::FrameQueueOverflowPolicy::Block:
+                while (keep_running.load(std::memory_order_acquire)) {
+                    if (TryPush(std::move(entry))) {
+                        return PushResult::Pushed;
+                    }
+                    WaitForChange(kBlockedPollInterval, [this] { return Size() < this->capacity; });
+                }
+                return PushResult::Aborted;
+            case settings::FrameQueueOverflowPolicy::DropOldest:
+            default: {
+                T evicted;
+                // the consumer may have freed a slot in between, in which case nothing needs to be evicted
+                bool dropped = TryPop(evicted);
+                while (!TryPush(std::move(entry))) {
+                    dropped |= TryPop(evicted);
+                }
+                return dropped ? PushResult::PushedAfterDroppingOldest : PushResult::Pushed;
+            }
+        }
+    }
+
+    /**
+     * Take the oldest entry, waiting up to the given timeout for one to arrive.
+     * @return true if an entry was retrieved
+     */
+    template<typename TRep, typename TPeriod>
+    bool WaitPop(T& entry, std::chrono::duration<TRep, TPeriod> timeout) {
+        if (TryPop(entry)) {
+            return true;
+        }
+        WaitForChange(timeout, [this] { return Size() > 0; });
+        return TryPop(entry);
+    }
+
+    /** Approximate number of entries in the ring. */
+    size_t Size() const {
+        size_t enqueued = enqueue_position.load(std::memory_order_acquire);
+        size_t dequeued = dequeue_position.load(std::memory_order_acquire);
+        return enqueued >= dequeued ? enqueued - dequeued : 0;
+    }
+
+    size_t Capacity() const {
+        return capacity;
+    }
+
+    /** Wake up any thread waiting on this ring, e.g. during shutdown. */
+    void WakeUp() {
+        // pairs with the fence in WaitForChange: either the waiter sees our update or we see the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiter_count.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(wait_mutex);
+            change_counter++;
+            wait_condition.notify_all();
+        }
+    }
+
+private:
+    static constexpr auto kBlockedPollInterval = std::chrono::milliseconds(5);
+    // avoid false sharing between producer- and consumer-side positions
+    static constexpr size_t kCacheLineSize = 64;
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T entry;
+    };
+
+    static size_t RoundUpToPowerOfTwo(size_t value) {
+        size_t power = 1;
+        while (power < value) {
+            power <<= 1;
+        }
+        return power < 2 ? 2 : power;
+    }
+
+    template<typename TRep, typename TPeriod, typename TPredicate>
+    void WaitForChange(std::chrono::duration<TRep, TPeriod> timeout, TPredicate ready) {
+        std::unique_lock<std::mutex> lock(wait_mutex);
+        waiter_count.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            uint64_t observed_change = change_counter;
+            wait_condition.wait_for(lock, timeout, [&] { return change_counter != observed_change; });
+        }
+        waiter_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    const size_t capacity;
+    const size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(kCacheLineSize) std::atomic<size_t> enqueue_position = 0;
+    alignas(kCacheLineSize) std::atomic<size_t> dequeue_position = 0;
+    alignas(kCacheLineSize) std::atomic<int> waiter_count = 0;
+    std::mutex wait_mutex;
+    std::condition_variable wait_condition;
+    uint64_t change_counter = 0;
+};
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,172 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <chrono>
+#include <filesystem>
+#include <string_view>
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+// === third-party includes (if any) ===
+#include <physiology/modules/graph_tweaks.h>
+#include <mediapipe/framework/port/file_helpers.h>
+#include <mediapipe/framework/port/parse_text_proto.h>
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "graph_config_cache.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+struct FileSignature {
+    int64_t modification_time_ns = 0;
+    int64_t size = 0;
+};
+
+absl::StatusOr<FileSignature> GetFileSignature(const std::string& file_path) {
+    std::error_code error_code;
+    auto modification_time = std::filesystem::last_write_time(file_path, error_code);
+    if (error_code) {
+        return absl::NotFoundError("Could not access graph file " + file_path + ": " + error_code.message());
+    }
+    auto size = std::filesystem::file_size(file_path, error_code);
+    if (error_code) {
+        return absl::NotFoundError("Could not access graph file " + file_path + ": " + error_code.message());
+    }
+    return FileSignature{
+        std::chrono::duration_cast<std::chrono::nanoseconds>(modification_time.time_since_epoch()).count(),
+        static_cast<int64_t>(size)
+    };
+}
+
+/**
+ * Read-only view of a file's contents, memory-mapped where possible.
+ */
+class FileContents {
+public:
+    static absl::StatusOr<std::unique_ptr<FileContents>> Load(const std::string& file_path, bool binary) {
+        auto contents = std::unique_ptr<FileContents>(new FileContents());
+#ifdef __linux__
+        int file_descriptor = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (file_descriptor >= 0) {
+            struct stat file_status{};
+            if (fstat(file_descriptor, &file_status) == 0 && file_status.st_size > 0) {
+                void* mapping = mmap(nullptr, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                if (mapping != MAP_FAILED) {
+                    contents->mapping = mapping;
+                    contents->mapping_size = static_cast<size_t>(file_status.st_size);
+                }
+            }
+            close(file_descriptor);
+            if (contents->mapping != nullptr) {
+                return contents;
+            }
+        }
+#endif
+        // fall back to reading the file into memory
+        MP_RETURN_IF_ERROR(mediapipe::file::GetContents(file_path, &contents->buffer, /*read_as_binary=*/binary));
+        return contents;
+    }
+
+    ~FileContents() {
+#ifdef __linux__
+        if (this->mapping != nullptr) {
+            munmap(this->mapping, this->mapping_size);
+        }
+#endif
+    }
+
+    std::string_view View() const {
+        if (this->mapping != nullptr) {
+            return {static_cast<const char*>(this->mapping), this->mapping_size};
+        }
+        return this->buffer;
+    }
+
+private:
+    FileContents() = default;
+
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::string buffer;
+};
+
+absl::StatusOr<std::shared_ptr<const mediapipe::CalculatorGraphConfig>> LoadGraphConfig(
+    const std::string& graph_file_path,
+    bool binary_graph,
+    bool scale_input
+) {
+    MP_ASSIGN_OR_RETURN(auto contents, FileContents::Load(graph_file_path, binary_graph));
+    std::string_view contents_view = contents->View();
+    auto config = std::make_shared<mediapipe::CalculatorGraphConfig>();
+    if (binary_graph) {
+        // parse straight from the mapped pages, no copy needed
+        if (!config->ParseFromArray(contents_view.data(), static_cast<int>(contents_view.size()))) {
+            return absl::InvalidArgumentError("Could not parse binary graph config from " + graph_file_path);
+        }
+    } else {
+        std::string config_text(contents_view);
+        if (!scale_input) {
+            // get rid of input scaling
+            presage::graph_tweaks::SetOutputWidthAndHeightToZeroIfPresent(config_text);
+        }
+        if (!mediapipe::ParseTextProto<mediapipe::CalculatorGraphConfig>(config_text, config.get())) {
+            return absl::InvalidArgumentError("Could not parse text graph config from " + graph_file_path);
+        }
+    }
+    return std::shared_ptr<const mediapipe::CalculatorGraphConfig>(std::move(config));
+}
+
+} // anonymous namespace
+
+GraphConfigCache& GraphConfigCache::GetInstance() {
+    static GraphConfigCache instance;
+    return instance;
+}
+
+absl::StatusOr<std::shared_ptr<const mediapipe::CalculatorGraphConfig>> GraphConfigCache::GetOrLoad(
+    const std::string& graph_file_path,
+    bool binary_graph,
+    bool scale_input
+) {
+    MP_ASSIGN_OR_RETURN(FileSignature file_signature, GetFileSignature(graph_file_path));
+    // the input scaling tweak only applies to text graphs
+    const std::string key =
+        graph_file_path + (binary_graph ? "|binary" : (scale_input ? "|text|scaled" : "|text|unscaled"));
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        auto entry = this->entries.find(key);
+        if (entry != this->entries.end() &&
+            entry->second.file_modification_time_ns == file_signature.modification_time_ns &&
+            entry->second.file_size == file_signature.size) {
+            this->statistics.hits++;
+            return entry->second.config;
+        }
+        this->statistics.misses++;
+    }
+    // load outside the lock, so that sessions using different graphs don't wait on each other
+    MP_ASSIGN_OR_RETURN(auto config, LoadGraphConfig(graph_file_path, binary_graph, scale_input));
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries[key] = Entry{config, file_signature.modification_time_ns, file_signature.size};
+    return config;
+}
+
+GraphConfigCache::Statistics GraphConfigCache::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->statistics;
+}
+
+void GraphConfigCache::Clear() {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+}
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,65 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/calculator.pb.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Process-wide cache of parsed graph configs.
+ *
+ * Configs are keyed by graph file path and by the settings that affect loading (binary vs. text format, input
+ * scaling tweak). Graph files are read through a read-only memory mapping where available. A cached config is
+ * reused for as long as the file's modification time & size stay the same, so new sessions for an already-seen
+ * device/mode/integration combination skip both file I/O and parsing. Thread-safe.
+ */
+class GraphConfigCache {
+public:
+    struct Statistics {
+        int64_t hits = 0;
+        int64_t misses = 0;
+    };
+
+    static GraphConfigCache& GetInstance();
+
+    /**
+     * Retrieve the parsed config from the cache, loading (and caching) it if needed.
+     * @param graph_file_path path to the .binarypb or .pbtxt graph file
+     * @param binary_graph true if the file is a binary proto, false if it's a text proto
+     * @param scale_input false to get rid of input scaling (applies to text graphs only)
+     */
+    absl::StatusOr<std::shared_ptr<const mediapipe::CalculatorGraphConfig>> GetOrLoad(
+        const std::string& graph_file_path, bool binary_graph, bool scale_input
+    );
+
+    Statistics GetStatistics() const;
+    void Clear();
+
+private:
+    struct Entry {
+        std::shared_ptr<const mediapipe::CalculatorGraphConfig> config;
+        int64_t file_modification_time_ns = 0;
+        int64_t file_size = 0;
+    };
+
+    GraphConfigCache() = default;
+
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries;
+    Statistics statistics;
+};
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,191 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+// === third-party includes (if any) ===
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/message.h>
+// === local includes (if any) ===
+#include "graph_input_scaling.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+// Options are read through protobuf reflection, so there is no build dependency on the calculator itself: if the
+// graph uses it, its options are in the generated descriptor pool.
+constexpr std::string_view kImageTransformationCalculator = "ImageTransformationCalculator";
+constexpr std::string_view kImageTransformationOptionsType = "mediapipe.ImageTransformationCalculatorOptions";
+
+// values of mediapipe::ScaleMode::Mode and mediapipe::RotationMode::Mode
+constexpr int kScaleModeDefault = 0;
+constexpr int kScaleModeStretch = 1;
+constexpr int kScaleModeFit = 2;
+constexpr int kScaleModeFillAndCrop = 3;
+constexpr int kRotationModeRotation0 = 1;
+
+bool ReadsStream(const mediapipe::CalculatorGraphConfig::Node& node, const std::string& stream_name) {
+    for (const std::string& input_stream: node.input_stream()) {
+        // "TAG:index:name", "TAG:name", or "name"
+        const size_t name_start = input_stream.rfind(':');
+        if (input_stream.compare(name_start == std::string::npos ? 0 : name_start + 1, std::string::npos,
+                                 stream_name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HasInputTag(const mediapipe::CalculatorGraphConfig::Node& node, std::string_view tag) {
+    for (const std::string& input_stream: node.input_stream()) {
+        if (input_stream.size() > tag.size() && input_stream.compare(0, tag.size(), tag) == 0 &&
+            input_stream[tag.size()] == ':') {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Find the ImageTransformationCalculatorOptions of a node, either in its (proto2 extension) options or in its
+ * (google.protobuf.Any) node_options.
+ * @param unpacked_options holds the options if they had to be unpacked from node_options
+ */
+const google::protobuf::Message* FindImageTransformationOptions(
+    const mediapipe::CalculatorGraphConfig::Node& node,
+    std::unique_ptr<google::protobuf::Message>& unpacked_options
+) {
+    if (node.has_options()) {
+        const google::protobuf::Reflection* reflection = node.options().GetReflection();
+        std::vector<const google::protobuf::FieldDescriptor*> fields;
+        reflection->ListFields(node.options(), &fields);
+        for (const google::protobuf::FieldDescriptor* field: fields) {
+            if (field->is_extension() && field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE &&
+                field->message_type()->full_name() == kImageTransformationOptionsType) {
+                return &reflection->GetMessage(node.options(), field);
+            }
+        }
+    }
+    for (const auto& any_options: node.node_options()) {
+        const std::string& type_url = any_options.type_url();
+        const size_t type_name_start = type_url.rfind('/');
+        std::string_view type_name(type_url);
+        type_name.remove_prefix(type_name_start == std::string::npos ? 0 : type_name_start + 1);
+        if (type_name != kImageTransformationOptionsType) {
+            continue;
+        }
+        const google::protobuf::Descriptor* descriptor =
+            google::protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(std::string(type_name));
+        if (descriptor == nullptr) {
+            return nullptr;
+        }
+        const google::protobuf::Message* prototype =
+            google::protobuf::MessageFactory::generated_factory()->GetPrototype(descriptor);
+        if (prototype == nullptr) {
+            return nullptr;
+        }
+        unpacked_options.reset(prototype->New());
+        if (!unpacked_options->ParseFromString(any_options.value())) {
+            return nullptr;
+        }
+        return unpacked_options.get();
+    }
+    return nullptr;
+}
+
+// value of an int32 or enum field, 0 if unset or missing
+int GetIntegerField(const google::protobuf::Message& message, const std::string& field_name) {
+    const google::protobuf::FieldDescriptor* field = message.GetDescriptor()->FindFieldByName(field_name);
+    const google::protobuf::Reflection* reflection = message.GetReflection();
+    if (field == nullptr || field->is_repeated() || !reflection->HasField(message, field)) {
+        return 0;
+    }
+    switch (field->cpp_type()) {
+        case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+            return reflection->GetInt32(message, field);
+        case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+            return reflection->GetEnumValue(message, field);
+        default:
+            return 0;
+    }
+}
+
+} // anonymous namespace
+
+std::optional<GraphInputScaling> FindGraphInputScaling(
+    const mediapipe::CalculatorGraphConfig& config,
+    const std::string& input_stream_name
+) {
+    for (const auto& node: config.node()) {
+        if (node.calculator() != kImageTransformationCalculator || !ReadsStream(node, input_stream_name)) {
+            continue;
+        }
+        // rotation and output size that can change from frame to frame can't be anticipated
+        if (HasInputTag(node, "ROTATION_DEGREES") || HasInputTag(node, "OUTPUT_DIMENSIONS")) {
+            return std::nullopt;
+        }
+        std::unique_ptr<google::protobuf::Message> unpacked_options;
+        const google::protobuf::Message* options = FindImageTransformationOptions(node, unpacked_options);
+        if (options == nullptr) {
+            return std::nullopt;
+        }
+        const int rotation_mode = GetIntegerField(*options, "rotation_mode");
+        if (rotation_mode != 0 && rotation_mode != kRotationModeRotation0) {
+            return std::nullopt;
+        }
+        GraphInputScaling scaling;
+        scaling.output_size = {GetIntegerField(*options, "output_width"), GetIntegerField(*options, "output_height")};
+        if (scaling.output_size.width <= 0 || scaling.output_size.height <= 0) {
+            return std::nullopt;
+        }
+        switch (GetIntegerField(*options, "scale_mode")) {
+            case kScaleModeDefault: // the calculator defaults to stretching
+            case kScaleModeStretch:
+                scaling.scale_mode = GraphInputScaleMode::Stretch;
+                break;
+            case kScaleModeFit:
+                scaling.scale_mode = GraphInputScaleMode::Fit;
+                break;
+            case kScaleModeFillAndCrop:
+                scaling.scale_mode = GraphInputScaleMode::FillAndCrop;
+                break;
+            default:
+                return std::nullopt;
+        }
+        return scaling;
+    }
+    return std::nullopt;
+}
+
+std::optional<cv::Size> GetPreScaledFrameSize(const cv::Size& frame_size, const GraphInputScaling& scaling) {
+    if (frame_size.width <= 0 || frame_size.height <= 0) {
+        return std::nullopt;
+    }
+    cv::Size pre_scaled_size = scaling.output_size;
+    if (scaling.scale_mode != GraphInputScaleMode::Stretch) {
+        // same rounding as ImageTransformationCalculator, so that it ends up resizing by a factor of exactly 1
+        const float width_scale = static_cast<float>(scaling.output_size.width) / frame_size.width;
+        const float height_scale = static_cast<float>(scaling.output_size.height) / frame_size.height;
+        const float scale = scaling.scale_mode == GraphInputScaleMode::Fit ? std::min(width_scale, height_scale)
+                                                                           : std::max(width_scale, height_scale);
+        pre_scaled_size = {std::max(1, static_cast<int>(std::round(frame_size.width * scale))),
+                           std::max(1, static_cast<int>(std::round(frame_size.height * scale)))};
+    }
+    // area filtering only makes sense when shrinking
+    if (pre_scaled_size.width > frame_size.width || pre_scaled_size.height > frame_size.height ||
+        pre_scaled_size == frame_size) {
+        return std::nullopt;
+    }
+    return pre_scaled_size;
+}
+
+} // namespace presage::smartspectra::container
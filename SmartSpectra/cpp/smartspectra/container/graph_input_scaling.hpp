@@ -0,0 +1,54 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <optional>
+#include <string>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/calculator.pb.h>
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+// How the graph fits input frames into its input size, mirrors mediapipe::ScaleMode
+enum class GraphInputScaleMode : int {
+    Stretch, // resize to the input size, disregarding the aspect ratio
+    Fit, // resize to fit inside the input size, keeping the aspect ratio (the rest gets padded)
+    FillAndCrop // resize to cover the input size, keeping the aspect ratio (the rest gets cropped)
+};
+
+/**
+ * @brief Input scaling the graph applies to incoming frames, i.e. the ImageTransformationCalculator that consumes the
+ * graph's input video stream.
+ */
+struct GraphInputScaling {
+    cv::Size output_size;
+    GraphInputScaleMode scale_mode = GraphInputScaleMode::Stretch;
+};
+
+/**
+ * Find the input scaling of a graph, i.e. the output size & scale mode of the ImageTransformationCalculator reading
+ * the given input stream.
+ * @param config graph config, with subgraphs expanded (e.g. from mediapipe::CalculatorGraph::Config())
+ * @param input_stream_name name of the graph's input video stream
+ * @return the scaling, or std::nullopt if the input stream isn't scaled to a fixed size, e.g. when input scaling was
+ * disabled or the calculator also rotates frames or takes its output dimensions from a stream
+ */
+std::optional<GraphInputScaling> FindGraphInputScaling(
+    const mediapipe::CalculatorGraphConfig& config,
+    const std::string& input_stream_name
+);
+
+/**
+ * Size to pre-scale frames of the given size to, so that the graph's input scaling leaves them as they are.
+ * @return the size, or std::nullopt if frames of the given size wouldn't get downscaled by the graph (in both
+ * dimensions)
+ */
+std::optional<cv::Size> GetPreScaledFrameSize(const cv::Size& frame_size, const GraphInputScaling& scaling);
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,214 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+// === third-party includes (if any) ===
+#include <absl/status/status.h>
+#include <mediapipe/framework/port/logging.h>
+// === local includes (if any) ===
+#include "image_frame_pool.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+size_t RoundUpToAlignment(size_t value) {
+    return (value + ImageFramePool::kStrideAlignment - 1) / ImageFramePool::kStrideAlignment *
+           ImageFramePool::kStrideAlignment;
+}
+
+} // anonymous namespace
+
+struct ImageFramePool::State {
+    explicit State(int max_free_buffers_per_size, size_t huge_page_arena_bytes)
+        : max_free_buffers_per_size(max_free_buffers_per_size) {
+        if (huge_page_arena_bytes > 0) {
+            ReserveArena(huge_page_arena_bytes);
+        }
+    }
+
+    ~State() {
+        ReleaseFreeHeapBuffers();
+#ifdef __linux__
+        if (arena_begin != nullptr) {
+            munmap(arena_begin, arena_size);
+        }
+#endif
+    }
+
+    void ReserveArena(size_t requested_bytes) {
+#ifdef __linux__
+        // 2 MiB is the default hugepage size on x86_64 & aarch64 Linux
+        constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+        size_t size = (requested_bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping == MAP_FAILED) {
+            // no reserved hugepages: ask for transparent hugepages instead
+            mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (mapping == MAP_FAILED) {
+                LOG(WARNING) << "Could not map image frame pool arena of " << size
+                             << " bytes, falling back to heap allocations.";
+                return;
+            }
+            madvise(mapping, size, MADV_HUGEPAGE);
+            LOG(INFO) << "Hugepages are not reserved on this system, image frame pool arena uses transparent "
+                         "hugepages instead.";
+        }
+        arena_begin = static_cast<uint8_t*>(mapping);
+        arena_size = size;
+#else
+        LOG(WARNING) << "Hugepage-backed image frame pool arena is only supported on Linux, "
+                        "falling back to heap allocations.";
+#endif
+    }
+
+    bool IsArenaBuffer(const uint8_t* buffer) const {
+        return arena_begin != nullptr && buffer >= arena_begin && buffer < arena_begin + arena_size;
+    }
+
+    // must be called with mutex locked
+    uint8_t* AllocateBuffer(size_t buffer_size) {
+        if (arena_begin != nullptr && arena_offset + buffer_size <= arena_size) {
+            uint8_t* buffer = arena_begin + arena_offset;
+            arena_offset += buffer_size;
+            return buffer;
+        }
+        return static_cast<uint8_t*>(std::aligned_alloc(kStrideAlignment, buffer_size));
+    }
+
+    uint8_t* Take(size_t buffer_size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint8_t* buffer = nullptr;
+        auto free_list = free_buffers.find(buffer_size);
+        if (free_list != free_buffers.end() && !free_list->second.empty()) {
+            buffer = free_list->second.back();
+            free_list->second.pop_back();
+            bytes_pooled -= static_cast<int64_t>(buffer_size);
+            hits++;
+        } else {
+            buffer = AllocateBuffer(buffer_size);
+            if (buffer == nullptr) {
+                return nullptr;
+            }
+            misses++;
+        }
+        frames_in_flight++;
+        bytes_in_flight += static_cast<int64_t>(buffer_size);
+        return buffer;
+    }
+
+    void Give(uint8_t* buffer, size_t buffer_size) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames_in_flight--;
+        bytes_in_flight -= static_cast<int64_t>(buffer_size);
+        auto& free_list = free_buffers[buffer_size];
+        // arena buffers cannot be returned individually, so they are always kept; the arena bounds their count anyway
+        if (!closed && (static_cast<int>(free_list.size()) < max_free_buffers_per_size || IsArenaBuffer(buffer))) {
+            free_list.push_back(buffer);
+            bytes_pooled += static_cast<int64_t>(buffer_size);
+        } else if (!IsArenaBuffer(buffer)) {
+            std::free(buffer);
+        }
+    }
+
+    // must be called with mutex locked
+    void ReleaseFreeHeapBuffers() {
+        for (auto& [buffer_size, free_list]: free_buffers) {
+            auto kept_end = free_list.begin();
+            for (uint8_t* buffer: free_list) {
+                if (IsArenaBuffer(buffer)) {
+                    *kept_end++ = buffer;
+                } else {
+                    std::free(buffer);
+                    bytes_pooled -= static_cast<int64_t>(buffer_size);
+                }
+            }
+            free_list.erase(kept_end, free_list.end());
+        }
+    }
+
+    const int max_free_buffers_per_size;
+    mutable std::mutex mutex;
+    std::unordered_map<size_t, std::vector<uint8_t*>> free_buffers;
+    bool closed = false;
+
+    uint8_t* arena_begin = nullptr;
+    size_t arena_size = 0;
+    size_t arena_offset = 0;
+
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t frames_in_flight = 0;
+    int64_t bytes_in_flight = 0;
+    int64_t bytes_pooled = 0;
+};
+
+ImageFramePool::ImageFramePool(int max_free_buffers_per_size, size_t huge_page_arena_bytes)
+    : state(std::make_shared<State>(max_free_buffers_per_size, huge_page_arena_bytes)) {}
+
+ImageFramePool::~ImageFramePool() {
+    // frames still in flight keep the state alive; make sure their buffers are freed rather than pooled on release
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->closed = true;
+    state->ReleaseFreeHeapBuffers();
+}
+
+int ImageFramePool::ComputeWidthStep(mediapipe::ImageFormat::Format format, int width) {
+    const int bytes_per_pixel = mediapipe::ImageFrame::NumberOfChannelsForFormat(format) *
+                                mediapipe::ImageFrame::ByteDepthForFormat(format);
+    return static_cast<int>(RoundUpToAlignment(static_cast<size_t>(width) * bytes_per_pixel));
+}
+
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ImageFramePool::Acquire(
+    mediapipe::ImageFormat::Format format, int width, int height
+) {
+    if (width <= 0 || height <= 0) {
+        return absl::InvalidArgumentError(
+            "Invalid image frame dimensions: " + std::to_string(width) + "x" + std::to_string(height) + "."
+        );
+    }
+    const int width_step = ComputeWidthStep(format, width);
+    const size_t buffer_size = static_cast<size_t>(width_step) * height;
+    uint8_t* pixel_data = state->Take(buffer_size);
+    if (pixel_data == nullptr) {
+        return absl::ResourceExhaustedError(
+            "Failed to allocate " + std::to_string(buffer_size) + " bytes for an image frame."
+        );
+    }
+    return std::make_unique<mediapipe::ImageFrame>(
+        format, width, height, width_step, pixel_data,
+        [pool_state = this->state, buffer_size](uint8_t* buffer) {
+            pool_state->Give(buffer, buffer_size);
+        }
+    );
+}
+
+ImageFramePoolStatistics ImageFramePool::GetStatistics() const {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    ImageFramePoolStatistics statistics;
+    statistics.hits = state->hits;
+    statistics.misses = state->misses;
+    statistics.frames_in_flight = state->frames_in_flight;
+    statistics.bytes_in_flight = state->bytes_in_flight;
+    statistics.bytes_pooled = state->bytes_pooled;
+    statistics.arena_bytes_used = static_cast<int64_t>(state->arena_offset);
+    return statistics;
+}
+
+void ImageFramePool::Trim() {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->ReleaseFreeHeapBuffers();
+}
+
+} // namespace presage::smartspectra::container
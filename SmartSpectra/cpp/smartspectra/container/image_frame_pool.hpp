@@ -0,0 +1,85 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <memory>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/formats/image_frame.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Snapshot of ImageFramePool usage counters.
+ */
+struct ImageFramePoolStatistics {
+    /** Acquisitions served from a recycled buffer. */
+    int64_t hits = 0;
+    /** Acquisitions that required a new pixel buffer. */
+    int64_t misses = 0;
+    /** Number of pool-backed frames currently alive (e.g., held by the graph). */
+    int64_t frames_in_flight = 0;
+    /** Total pixel buffer bytes of pool-backed frames currently alive. */
+    int64_t bytes_in_flight = 0;
+    /** Total bytes held in free lists, ready to be recycled. */
+    int64_t bytes_pooled = 0;
+    /** Bytes of the hugepage arena that have been carved into pixel buffers (0 if no arena is used). */
+    int64_t arena_bytes_used = 0;
+};
+
+/**
+ * @brief Bounded, size-keyed pool of pixel buffers for mediapipe::ImageFrame.
+ *
+ * Frames acquired from the pool own their pixel buffer through a custom deleter: when the last holder of the frame
+ * (typically, the graph packet) releases it, the buffer goes back to the free list for its byte size instead of the
+ * heap. Row strides are padded to kStrideAlignment bytes, so rows start on cache-line boundaries suitable for SIMD.
+ *
+ * Optionally, buffers are carved out of a single hugepage-backed arena (Linux only; falls back to transparent hugepage
+ * advice or to regular heap allocations if hugepages cannot be reserved).
+ *
+ * The pool is thread-safe. Frames may outlive the pool object.
+ */
+class ImageFramePool {
+public:
+    /** Row stride & buffer alignment, in bytes. */
+    static constexpr int kStrideAlignment = 64;
+
+    /**
+     * @param max_free_buffers_per_size maximum number of released buffers kept for reuse per distinct buffer size
+     * @param huge_page_arena_bytes size of the hugepage-backed arena to carve buffers from; 0 disables the arena
+     */
+    explicit ImageFramePool(int max_free_buffers_per_size = 8, size_t huge_page_arena_bytes = 0);
+    ~ImageFramePool();
+
+    ImageFramePool(const ImageFramePool&) = delete;
+    ImageFramePool& operator=(const ImageFramePool&) = delete;
+
+    /**
+     * Acquire an (uninitialized) image frame of the given format & dimensions, recycling a pooled buffer if possible.
+     */
+    absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> Acquire(
+        mediapipe::ImageFormat::Format format, int width, int height
+    );
+
+    /** Retrieve current pool usage counters. */
+    ImageFramePoolStatistics GetStatistics() const;
+
+    /** Release all pooled (currently unused) heap buffers. */
+    void Trim();
+
+    /** Compute the padded row stride, in bytes, used for frames of the given format & width. */
+    static int ComputeWidthStep(mediapipe::ImageFormat::Format format, int width);
+
+private:
+    struct State;
+    // shared with deleters of frames in flight, so that buffers can be returned after the pool object is gone
+    std::shared_ptr<State> state;
+};
+
+} // namespace presage::smartspectra::container
@@ -14,13 +14,213 @@
 #include <mediapipe/gpu/gl_calculator_helper.h>
 #endif
 #include <mediapipe/framework/formats/image_frame_opencv.h>
+#include <mediapipe/framework/port/opencv_imgproc_inc.h>
 // === local includes (if any) ===
+#include <smartspectra/video_source/input_transform_kernels.hpp>
 #include "image_transfer.hpp"
 
 
 
 namespace presage::smartspectra::container::image_transfer {
 
+absl::StatusOr<int> GetColorConversionCodeToRgb(int channel_count, bool source_is_bgr) {
+    switch (channel_count) {
+        case 1:
+            return cv::COLOR_GRAY2RGB;
+        case 3:
+            return source_is_bgr ? cv::COLOR_BGR2RGB : -1;
+        case 4:
+            return source_is_bgr ? cv::COLOR_BGRA2RGB : cv::COLOR_RGBA2RGB;
+        default:
+            return absl::InvalidArgumentError(
+                "Unsupported input frame channel count: " + std::to_string(channel_count) + ". Expecting 1, 3, or 4."
+            );
+    }
+}
+
+absl::StatusOr<int> GetColorConversionCodeToRgb(video_source::PixelFormat source_pixel_format) {
+    switch (source_pixel_format) {
+        case video_source::PixelFormat::BGR:
+            return cv::COLOR_BGR2RGB;
+        case video_source::PixelFormat::RGB:
+            return -1;
+        case video_source::PixelFormat::YUYV:
+            return cv::COLOR_YUV2RGB_YUYV;
+        case video_source::PixelFormat::NV12:
+            return cv::COLOR_YUV2RGB_NV12;
+        default:
+            return absl::InvalidArgumentError(
+                "Unsupported input frame pixel format: " + video_source::AbslUnparseFlag(source_pixel_format) + "."
+            );
+    }
+}
+
+cv::Size GetConvertedFrameSize(const cv::Mat& source_frame, int color_conversion_code) {
+    if (color_conversion_code == cv::COLOR_YUV2RGB_NV12) {
+        return {source_frame.cols, source_frame.rows * 2 / 3};
+    }
+    return source_frame.size();
+}
+
+absl::Status ConvertIntoImageFrame(
+    const cv::Mat& source_frame,
+    int color_conversion_code,
+    mediapipe::ImageFrame& destination_frame,
+    bool& converted_in_place
+) {
+    if (source_frame.empty()) {
+        return absl::InvalidArgumentError("Cannot convert an empty frame.");
+    }
+    if (source_frame.depth() != CV_8U) {
+        return absl::InvalidArgumentError("Only 8-bit input frames are supported.");
+    }
+    const cv::Size converted_frame_size = GetConvertedFrameSize(source_frame, color_conversion_code);
+    if (destination_frame.Format() != mediapipe::ImageFormat::SRGB ||
+        destination_frame.Width() != converted_frame_size.width ||
+        destination_frame.Height() != converted_frame_size.height) {
+        return absl::InvalidArgumentError(
+            "Destination image frame must be SRGB and match the converted frame size."
+        );
+    }
+    // MatView wraps the ImageFrame's own (aligned) pixel buffer; OpenCV writes into a destination header of the
+    // correct size & type without reallocating, which makes this a single pass over the pixels.
+    cv::Mat destination = mediapipe::formats::MatView(&destination_frame);
+    const uchar* image_frame_data = destination.data;
+    if (color_conversion_code < 0) {
+        source_frame.copyTo(destination);
+    } else {
+        cv::cvtColor(source_frame, destination, color_conversion_code);
+    }
+    converted_in_place = destination.data == image_frame_data;
+    if (!converted_in_place) {
+        if (destination.type() != CV_8UC3) {
+            return absl::InvalidArgumentError(
+                "Color conversion code " + std::to_string(color_conversion_code) + " does not produce RGB output."
+            );
+        }
+        cv::Mat image_frame_view = mediapipe::formats::MatView(&destination_frame);
+        destination.copyTo(image_frame_view);
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ConvertToImageFrame(
+    const cv::Mat& source_frame,
+    int color_conversion_code,
+    bool& converted_in_place
+) {
+    const cv::Size converted_frame_size = GetConvertedFrameSize(source_frame, color_conversion_code);
+    auto image_frame = absl::make_unique<mediapipe::ImageFrame>(
+        mediapipe::ImageFormat::SRGB, converted_frame_size.width, converted_frame_size.height,
+        mediapipe::ImageFrame::kDefaultAlignmentBoundary
+    );
+    MP_RETURN_IF_ERROR(ConvertIntoImageFrame(source_frame, color_conversion_code, *image_frame, converted_in_place));
+    return image_frame;
+}
+
+absl::Status TransformIntoImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr,
+    mediapipe::ImageFrame& destination_frame
+) {
+    if (destination_frame.Format() != mediapipe::ImageFormat::SRGB) {
+        return absl::InvalidArgumentError("Destination image frame must be SRGB.");
+    }
+    // MatView wraps the ImageFrame's own (aligned) pixel buffer, the kernels write straight into it
+    cv::Mat destination = mediapipe::formats::MatView(&destination_frame);
+    return video_source::TransformAndSwizzleFrame(source_frame, input_transform, source_is_bgr, destination);
+}
+
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> TransformToImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr
+) {
+    const cv::Size transformed_frame_size = video_source::GetTransformedFrameSize(source_frame.size(), input_transform);
+    auto image_frame = absl::make_unique<mediapipe::ImageFrame>(
+        mediapipe::ImageFormat::SRGB, transformed_frame_size.width, transformed_frame_size.height,
+        mediapipe::ImageFrame::kDefaultAlignmentBoundary
+    );
+    MP_RETURN_IF_ERROR(TransformIntoImageFrame(source_frame, input_transform, source_is_bgr, *image_frame));
+    return image_frame;
+}
+
+absl::Status ScaleIntoImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr,
+    mediapipe::ImageFrame& destination_frame,
+    bool& scaled_in_place
+) {
+    if (source_frame.empty()) {
+        return absl::InvalidArgumentError("Cannot scale an empty frame.");
+    }
+    if (source_frame.type() != CV_8UC3) {
+        return absl::InvalidArgumentError("Only 8-bit, 3-channel input frames can be scaled.");
+    }
+    if (destination_frame.Format() != mediapipe::ImageFormat::SRGB) {
+        return absl::InvalidArgumentError("Destination image frame must be SRGB.");
+    }
+    cv::Mat destination = mediapipe::formats::MatView(&destination_frame);
+    // downscale first, so that the transform & channel swap only go over the (much fewer) downscaled pixels
+    const cv::Size scaled_frame_size = video_source::GetTransformedFrameSize(destination.size(), input_transform);
+    if (input_transform == video_source::InputTransformMode::None && !source_is_bgr) {
+        const uchar* image_frame_data = destination.data;
+        cv::resize(source_frame, destination, scaled_frame_size, 0, 0, cv::INTER_AREA);
+        scaled_in_place = destination.data == image_frame_data;
+        if (!scaled_in_place) {
+            cv::Mat image_frame_view = mediapipe::formats::MatView(&destination_frame);
+            destination.copyTo(image_frame_view);
+        }
+        return absl::OkStatus();
+    }
+    // reused from frame to frame, per thread
+    thread_local cv::Mat scaled_frame;
+    cv::resize(source_frame, scaled_frame, scaled_frame_size, 0, 0, cv::INTER_AREA);
+    scaled_in_place = false;
+    return video_source::TransformAndSwizzleFrame(scaled_frame, input_transform, source_is_bgr, destination);
+}
+
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ScaleToImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr,
+    const cv::Size& scaled_frame_size,
+    bool& scaled_in_place
+) {
+    auto image_frame = absl::make_unique<mediapipe::ImageFrame>(
+        mediapipe::ImageFormat::SRGB, scaled_frame_size.width, scaled_frame_size.height,
+        mediapipe::ImageFrame::kDefaultAlignmentBoundary
+    );
+    MP_RETURN_IF_ERROR(
+        ScaleIntoImageFrame(source_frame, input_transform, source_is_bgr, *image_frame, scaled_in_place)
+    );
+    return image_frame;
+}
+
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> WrapInImageFrame(
+    const cv::Mat& source_frame_rgb,
+    std::function<void()> release_frame
+) {
+    if (release_frame == nullptr) {
+        return absl::InvalidArgumentError("Release callback for a caller-owned frame cannot be nullptr.");
+    }
+    if (source_frame_rgb.type() != CV_8UC3 || source_frame_rgb.empty()) {
+        release_frame();
+        return absl::InvalidArgumentError(
+            "Caller-owned frames must be non-empty, 8-bit, 3-channel RGB. Got frame of type "
+            + std::to_string(source_frame_rgb.type()) + " with size " + std::to_string(source_frame_rgb.cols)
+            + "x" + std::to_string(source_frame_rgb.rows) + "."
+        );
+    }
+    return absl::make_unique<mediapipe::ImageFrame>(
+        mediapipe::ImageFormat::SRGB, source_frame_rgb.cols, source_frame_rgb.rows,
+        static_cast<int>(source_frame_rgb.step[0]), source_frame_rgb.data,
+        [release_frame = std::move(release_frame)](uint8_t*) { release_frame(); }
+    );
+}
+
 template<>
 absl::Status FeedFrameToGraph<platform_independence::DeviceType::Cpu>(
     std::unique_ptr<mediapipe::ImageFrame> input_frame,
@@ -20,17 +20,148 @@
 
 #pragma once
 // === standard library includes (if any) ===
+#include <functional>
+#include <memory>
 // === third-party includes (if any) ===
 #include <absl/status/status.h>
+#include <absl/status/statusor.h>
 #include <mediapipe/framework/formats/image_frame.h>
 #include <mediapipe/framework/calculator_framework.h>
 #include <mediapipe/framework/port/opencv_core_inc.h>
 #include <physiology/modules/device_type.h>
 #include <physiology/modules/device_context.h>
 // === local includes (if any) ===
+#include <smartspectra/video_source/pixel_format.hpp>
+#include <smartspectra/video_source/input_transform.hpp>
 
 namespace presage::smartspectra::container::image_transfer {
 
+/**
+ * @brief Pick the OpenCV color conversion code that brings an 8-bit frame with the given channel count to RGB.
+ * @param channel_count number of channels in the source frame (1, 3, or 4)
+ * @param source_is_bgr true if the source frame uses BGR(A) channel order, false if it uses RGB(A)
+ * @return conversion code, or -1 if the frame is already RGB and only needs to be copied
+ */
+absl::StatusOr<int> GetColorConversionCodeToRgb(int channel_count, bool source_is_bgr);
+
+/**
+ * @brief Pick the OpenCV color conversion code that brings a frame in the given video source pixel format to RGB.
+ * @return conversion code, or -1 if the frame is already RGB and only needs to be copied
+ */
+absl::StatusOr<int> GetColorConversionCodeToRgb(video_source::PixelFormat source_pixel_format);
+
+/**
+ * @brief Size of the RGB image produced by applying the color conversion to the source frame.
+ * @details Same as the source frame size, except for planar YUV 4:2:0 sources, whose chroma plane is stacked below the
+ * luma plane.
+ */
+cv::Size GetConvertedFrameSize(const cv::Mat& source_frame, int color_conversion_code);
+
+/**
+ * @brief Write the source frame into an existing SRGB ImageFrame of matching dimensions in a single pass.
+ * @details The color conversion (or plain copy, when color_conversion_code is -1) writes directly into the
+ * pixel buffer of the ImageFrame, so no intermediate cv::Mat is produced.
+ * @param source_frame 8-bit source frame
+ * @param color_conversion_code OpenCV color conversion code, e.g. from GetColorConversionCodeToRgb
+ * @param destination_frame SRGB ImageFrame with dimensions matching GetConvertedFrameSize
+ * @param[out] converted_in_place false if OpenCV had to go through an intermediate buffer
+ */
+absl::Status ConvertIntoImageFrame(
+    const cv::Mat& source_frame,
+    int color_conversion_code,
+    mediapipe::ImageFrame& destination_frame,
+    bool& converted_in_place
+);
+
+/**
+ * @brief Allocate a graph-ready SRGB ImageFrame and write the source frame into it in a single pass.
+ * @details The color conversion (or plain copy, when color_conversion_code is -1) writes directly into the
+ * aligned pixel buffer of the ImageFrame, so no intermediate cv::Mat is produced.
+ * @param source_frame 8-bit source frame
+ * @param color_conversion_code OpenCV color conversion code, e.g. from GetColorConversionCodeToRgb
+ * @param[out] converted_in_place false if OpenCV had to go through an intermediate buffer (should never happen
+ * with a valid conversion code; reported so that callers can keep track of it)
+ */
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ConvertToImageFrame(
+    const cv::Mat& source_frame,
+    int color_conversion_code,
+    bool& converted_in_place
+);
+
+/**
+ * @brief Apply the input transform to an 8-bit, 3-channel source frame and write the result, in RGB channel order, into
+ * an existing SRGB ImageFrame in a single pass.
+ * @details Rotation/flip, BGR -> RGB channel swap, and the write into the pixel buffer of the ImageFrame are fused into
+ * one SIMD kernel (see video_source::TransformAndSwizzleFrame), so neither the transformed nor the converted frame
+ * exists as an intermediate cv::Mat.
+ * @param source_frame 8-bit, 3-channel source frame, before the input transform
+ * @param input_transform input transform to apply
+ * @param source_is_bgr true if the source frame uses BGR channel order, false if it uses RGB
+ * @param destination_frame SRGB ImageFrame with dimensions matching video_source::GetTransformedFrameSize
+ */
+absl::Status TransformIntoImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr,
+    mediapipe::ImageFrame& destination_frame
+);
+
+/**
+ * @brief Allocate a graph-ready SRGB ImageFrame and write the transformed source frame into it, as in
+ * TransformIntoImageFrame.
+ */
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> TransformToImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr
+);
+
+/**
+ * @brief Downscale an 8-bit, 3-channel source frame to the size of an existing SRGB ImageFrame with an area filter,
+ * applying the input transform and bringing it to RGB channel order on the way.
+ * @details The area filter (cv::INTER_AREA) reads the full-size frame once. Without a transform or channel swap, it
+ * writes straight into the pixel buffer of the ImageFrame; otherwise, the fused transform & swizzle kernel moves the
+ * downscaled pixels over (see TransformIntoImageFrame).
+ * @param source_frame 8-bit, 3-channel source frame, before the input transform
+ * @param input_transform input transform to apply
+ * @param source_is_bgr true if the source frame uses BGR channel order, false if it uses RGB
+ * @param destination_frame SRGB ImageFrame of the downscaled size (after the input transform)
+ * @param[out] scaled_in_place false if the downscaled frame went through an intermediate buffer
+ */
+absl::Status ScaleIntoImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr,
+    mediapipe::ImageFrame& destination_frame,
+    bool& scaled_in_place
+);
+
+/**
+ * @brief Allocate a graph-ready SRGB ImageFrame of the given size and downscale the source frame into it, as in
+ * ScaleIntoImageFrame.
+ */
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> ScaleToImageFrame(
+    const cv::Mat& source_frame,
+    video_source::InputTransformMode input_transform,
+    bool source_is_bgr,
+    const cv::Size& scaled_frame_size,
+    bool& scaled_in_place
+);
+
+/**
+ * @brief Wrap a caller-owned RGB pixel buffer in an SRGB ImageFrame without copying it.
+ * @details The ImageFrame references the pixel data of the source frame directly (any row stride is accepted), so the
+ * buffer must stay valid and unmodified until release_frame is invoked, i.e. when the last holder of the ImageFrame
+ * (typically, the graph) lets go of it.
+ * @param source_frame_rgb 8-bit, 3-channel frame in RGB channel order
+ * @param release_frame invoked exactly once when the pixel buffer is no longer needed; if wrapping fails, it is
+ * invoked before returning
+ */
+absl::StatusOr<std::unique_ptr<mediapipe::ImageFrame>> WrapInImageFrame(
+    const cv::Mat& source_frame_rgb,
+    std::function<void()> release_frame
+);
+
 /**
  * @brief Send an image frame into the MediaPipe graph.
  */
@@ -0,0 +1,71 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <iterator>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "ingested_frame_map.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+// beyond this many changes, the oldest ones are forgotten: landmarks that far back are no longer coming
+constexpr size_t kMaxMappingChangesTracked = 256;
+
+} // anonymous namespace
+
+void IngestedFrameMap::RecordIngestedFrame(
+    int64_t timestamp,
+    const cv::Rect& region,
+    const cv::Size& ingested_frame_size
+) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (!this->mapping_changes.empty() && this->mapping_changes.back().region == region &&
+        this->mapping_changes.back().size == ingested_frame_size) {
+        return;
+    }
+    this->mapping_changes.push_back({timestamp, region, ingested_frame_size});
+    if (this->mapping_changes.size() > kMaxMappingChangesTracked) {
+        this->mapping_changes.pop_front();
+    }
+}
+
+std::optional<IngestedFrameMap::FrameMapping> IngestedFrameMap::FindFrameMapping(int64_t timestamp) const {
+    // latest change at or before the timestamp
+    auto next_change = std::upper_bound(
+        this->mapping_changes.begin(), this->mapping_changes.end(), timestamp,
+        [](int64_t timestamp, const FrameMapping& mapping) { return timestamp < mapping.timestamp; }
+    );
+    if (next_change == this->mapping_changes.begin()) {
+        return std::nullopt;
+    }
+    return *std::prev(next_change);
+}
+
+bool IngestedFrameMap::MapLandmarks(physiology::Face& face, int64_t timestamp) const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    bool all_mapped = true;
+    for (auto& landmarks: *face.mutable_landmarks()) {
+        const std::optional<FrameMapping> mapping =
+            this->FindFrameMapping(landmarks.timestamp() != 0 ? landmarks.timestamp() : timestamp);
+        if (!mapping.has_value() || mapping->size.empty()) {
+            all_mapped = false;
+            continue;
+        }
+        const float x_scale = static_cast<float>(mapping->region.width) / mapping->size.width;
+        const float y_scale = static_cast<float>(mapping->region.height) / mapping->size.height;
+        for (auto& point: *landmarks.mutable_value()) {
+            point.set_x(mapping->region.x + point.x() * x_scale);
+            point.set_y(mapping->region.y + point.y() * y_scale);
+        }
+    }
+    return all_mapped;
+}
+
+} // namespace presage::smartspectra::container
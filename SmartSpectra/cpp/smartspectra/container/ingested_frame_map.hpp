@@ -0,0 +1,65 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/opencv_core_inc.h>
+#include <physiology/modules/messages/metrics.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Remembers how the frames sent into the graph map onto the full input frames (after the input transform),
+ * i.e. which region of each full frame was sent in and at what size, so that face landmarks coming back out of the
+ * graph can be placed on the full frames.
+ *
+ * Only changes are stored, so that long stretches of frames sent in the same way (e.g. a steady face crop, or
+ * pre-scaling to a fixed size) cost next to nothing to keep track of, also for core metrics covering many seconds.
+ *
+ * RecordIngestedFrame is called by the feed stage, MapLandmarks by the output stage; both are thread-safe.
+ */
+class IngestedFrameMap {
+public:
+    /**
+     * Remember how a frame sent into the graph maps onto the full frame.
+     * @param timestamp frame timestamp, in microseconds; has to increase from one call to the next
+     * @param region region of the full frame that was sent
+     * @param ingested_frame_size size of the frame that was sent (differs from the region size if it was scaled)
+     */
+    void RecordIngestedFrame(int64_t timestamp, const cv::Rect& region, const cv::Size& ingested_frame_size);
+
+    /**
+     * Map face landmarks produced by the graph onto the full frames. Each set of landmarks is placed according to the
+     * frame it was detected in, as found by the set's own timestamp or, where that is unset, the given one.
+     * @param face face metrics (of edge or core metrics); landmarks are updated in place
+     * @param timestamp timestamp of the packet carrying the face metrics, in microseconds
+     * @return false if any set of landmarks was left as is, since there was no record of its frame
+     */
+    bool MapLandmarks(physiology::Face& face, int64_t timestamp) const;
+
+private:
+    struct FrameMapping {
+        // timestamp of the first frame sent in this way
+        int64_t timestamp;
+        cv::Rect region;
+        cv::Size size;
+    };
+
+    /** @return the mapping of the frame with the given timestamp, if there is a record of it */
+    std::optional<FrameMapping> FindFrameMapping(int64_t timestamp) const;
+
+    mutable std::mutex mutex;
+    // changes in how frames were sent in, oldest first; each holds for all frames up to the next one
+    std::deque<FrameMapping> mapping_changes;
+};
+
+} // namespace presage::smartspectra::container
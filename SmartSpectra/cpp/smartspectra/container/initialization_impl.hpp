@@ -23,19 +23,17 @@
 #include <string>
 #include <regex>
 // === third-party includes (if any) ===
-#include <physiology/modules/graph_tweaks.h>
 #include <physiology/graph/stream_and_packet_names.h>
 #include <physiology/modules/geometry.hpp>
 #include <mediapipe/framework/port/logging.h>
-#include <mediapipe/framework/port/file_helpers.h>
 #include <mediapipe/framework/port/status_macros.h>
-#include <mediapipe/framework/port/parse_text_proto.h>
 #include <mediapipe/framework/calculator.pb.h>
 #include <absl/status/statusor.h>
 #include <opencv2/highgui.hpp>
 // === local includes (if any) ===
 #include "initialization.hpp"
 #include "configuration.hpp"
+#include "graph_config_cache.hpp"
 #ifdef ENABLE_CUSTOM_SERVER
 #include "custom_rest_settings.hpp"
 #endif
@@ -97,35 +95,23 @@ inline absl::StatusOr<mediapipe::CalculatorGraphConfig> InitializeGraphConfig(
     const settings::Settings<TOperationMode, TIntegrationMode>& settings,
     bool binary_graph
 ) {
-    std::string calculator_graph_config_contents;
-    MP_RETURN_IF_ERROR(
-        mediapipe::file::GetContents(
-            graph_file_path,
-            &calculator_graph_config_contents,
-            /*read_as_binary=*/binary_graph
-        )
-    );
     if (TLog) {
         LOG(INFO) << "Scaling input in graph: " << (settings.scale_input ? "true" : "false");
     }
-    mediapipe::CalculatorGraphConfig config;
-    if (binary_graph) {
-        RET_CHECK(config.ParseFromArray(calculator_graph_config_contents.c_str(),
-                                        calculator_graph_config_contents.length()));
-    } else {
-        if (!settings.scale_input) {
-            // get rid of input scaling
-            presage::graph_tweaks::SetOutputWidthAndHeightToZeroIfPresent(calculator_graph_config_contents);
-        }
-        if (TLog) {
-            if (settings.print_graph_contents) {
-                LOG(INFO) << "Get calculator graph config contents: " << calculator_graph_config_contents;
-            }
-        }
-        config = mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig>(calculator_graph_config_contents);
+    // parsed configs are cached process-wide, so only the first session using a graph pays for file I/O & parsing
+    MP_ASSIGN_OR_RETURN(
+        std::shared_ptr<const mediapipe::CalculatorGraphConfig> cached_config,
+        GraphConfigCache::GetInstance().GetOrLoad(graph_file_path, binary_graph, settings.scale_input)
+    );
+    mediapipe::CalculatorGraphConfig config = *cached_config;
+    if (TLog && !binary_graph && settings.print_graph_contents) {
+        LOG(INFO) << "Get calculator graph config contents: " << config.DebugString();
     }
 
-    config.add_executor();
+    if (!settings.graph_executor.use_shared_pool) {
+        // default executor with its own thread pool (the shared pool gets supplied via CalculatorGraph::SetExecutor)
+        config.add_executor();
+    }
 
     return config;
 }
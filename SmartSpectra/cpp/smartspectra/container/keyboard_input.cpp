@@ -16,14 +16,14 @@ namespace presage::smartspectra::container::keyboard_input {
 
 using StatusCode = physiology::StatusCode;
 
-absl::Status HandleKeyboardInput(
+absl::Status HandlePressedKey(
+    int pressed_key,
     bool& grab_frames,
     bool& recording,
     video_source::VideoSource& v_source,
     const settings::GeneralSettings& settings,
     physiology::StatusValue status
 ) {
-    const int pressed_key = cv::waitKey(settings.interframe_delay_ms);
     if (pressed_key != -1) {
         switch (pressed_key) {
             case 'q':
@@ -71,4 +71,15 @@ absl::Status HandleKeyboardInput(
     return absl::OkStatus();
 }
 
+absl::Status HandleKeyboardInput(
+    bool& grab_frames,
+    bool& recording,
+    video_source::VideoSource& v_source,
+    const settings::GeneralSettings& settings,
+    physiology::StatusValue status
+) {
+    const int pressed_key = cv::waitKey(settings.interframe_delay_ms);
+    return HandlePressedKey(pressed_key, grab_frames, recording, v_source, settings, status);
+}
+
 } // namespace presage::smartspectra::container::keyboard_input
@@ -30,8 +30,22 @@
 
 namespace presage::smartspectra::container::keyboard_input {
 
+/**
+ * @brief Handle an already-retrieved key press (e.g. from cv::waitKey) for example applications.
+ * @param pressed_key key code, or -1 if no key was pressed
+ */
+absl::Status HandlePressedKey(
+    int pressed_key,
+    bool& grab_frames,
+    bool& recording,
+    video_source::VideoSource& v_source,
+    const settings::GeneralSettings& settings,
+    physiology::StatusValue status
+);
+
 /**
  * @brief Handle interactive keyboard commands for example applications.
+ * @details Waits for a key press for up to settings.interframe_delay_ms milliseconds.
  */
 absl::Status HandleKeyboardInput(
     bool& grab_frames,
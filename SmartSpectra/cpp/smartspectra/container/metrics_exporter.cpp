@@ -0,0 +1,284 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+// === third-party includes (if any) ===
+#include <absl/strings/numbers.h>
+#include <mediapipe/framework/port/logging.h>
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "metrics_exporter.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace {
+
+// how often the serving thread checks whether it should stop
+constexpr int kAcceptPollIntervalMs = 200;
+// scrapers that connect but never send a request shouldn't stall the exporter
+constexpr int kRequestReadTimeoutMs = 1000;
+constexpr size_t kMaxRequestSize = 4096;
+const char kUnixSocketPrefix[] = "unix:";
+
+absl::Status ErrnoStatus(const std::string& what) {
+    return absl::InternalError(what + ": " + std::strerror(errno));
+}
+
+bool SendAll(int fd, const std::string& data) {
+    size_t sent_byte_count = 0;
+    while (sent_byte_count < data.size()) {
+        ssize_t result = send(fd, data.data() + sent_byte_count, data.size() - sent_byte_count, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent_byte_count += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+/** Remove a socket file left behind by a previous run, refusing to touch anything else or a socket still in use. */
+absl::Status RemoveStaleUnixSocket(const std::string& socket_path, const sockaddr_un& socket_address) {
+    struct stat file_status{};
+    if (lstat(socket_path.c_str(), &file_status) != 0) {
+        if (errno == ENOENT) {
+            return absl::OkStatus();
+        }
+        return ErrnoStatus("Could not check metrics export socket path " + socket_path);
+    }
+    if (!S_ISSOCK(file_status.st_mode)) {
+        return absl::AlreadyExistsError("Metrics export socket path " + socket_path + " exists and is not a socket.");
+    }
+    int probe_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe_fd < 0) {
+        return ErrnoStatus("Could not create metrics export socket");
+    }
+    const bool refused =
+        connect(probe_fd, reinterpret_cast<const sockaddr*>(&socket_address), sizeof(socket_address)) != 0 &&
+        errno == ECONNREFUSED;
+    close(probe_fd);
+    if (!refused) {
+        return absl::AlreadyExistsError("Metrics export socket " + socket_path + " is already in use.");
+    }
+    if (unlink(socket_path.c_str()) != 0) {
+        return ErrnoStatus("Could not remove stale metrics export socket " + socket_path);
+    }
+    return absl::OkStatus();
+}
+
+} // anonymous namespace
+
+OpenMetricsExporter::Registration::Registration(
+    std::shared_ptr<OpenMetricsExporter> exporter,
+    const MetricsRegistry& registry
+) : exporter(std::move(exporter)), registry(registry) {
+    this->exporter->AddRegistry(this->registry);
+}
+
+OpenMetricsExporter::Registration::~Registration() {
+    this->exporter->RemoveRegistry(this->registry);
+}
+
+absl::StatusOr<std::shared_ptr<OpenMetricsExporter>> OpenMetricsExporter::GetInstance(const std::string& address) {
+    static std::mutex instances_mutex;
+    // not owning: an exporter stops serving once no container exports through it anymore
+    static std::map<std::string, std::weak_ptr<OpenMetricsExporter>> instances;
+    std::lock_guard<std::mutex> lock(instances_mutex);
+    std::shared_ptr<OpenMetricsExporter> exporter = instances[address].lock();
+    if (exporter == nullptr) {
+        exporter = std::make_shared<OpenMetricsExporter>();
+        MP_RETURN_IF_ERROR(exporter->Start(address));
+        instances[address] = exporter;
+    }
+    return exporter;
+}
+
+OpenMetricsExporter::~OpenMetricsExporter() {
+    Stop();
+}
+
+absl::Status OpenMetricsExporter::Start(const std::string& address) {
+    if (this->running) {
+        return absl::FailedPreconditionError("Metrics exporter is already running.");
+    }
+    if (address.rfind(kUnixSocketPrefix, 0) == 0) {
+        std::string socket_path = address.substr(sizeof(kUnixSocketPrefix) - 1);
+        sockaddr_un socket_address{};
+        if (socket_path.empty() || socket_path.size() >= sizeof(socket_address.sun_path)) {
+            return absl::InvalidArgumentError("Invalid Unix socket path for metrics export: " + socket_path);
+        }
+        socket_address.sun_family = AF_UNIX;
+        std::strncpy(socket_address.sun_path, socket_path.c_str(), sizeof(socket_address.sun_path) - 1);
+        MP_RETURN_IF_ERROR(RemoveStaleUnixSocket(socket_path, socket_address));
+        this->listening_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (this->listening_fd < 0) {
+            return ErrnoStatus("Could not create metrics export socket");
+        }
+        if (bind(this->listening_fd, reinterpret_cast<sockaddr*>(&socket_address), sizeof(socket_address)) != 0) {
+            absl::Status status = ErrnoStatus("Could not bind metrics export socket to " + socket_path);
+            close(this->listening_fd);
+            this->listening_fd = -1;
+            return status;
+        }
+        this->unix_socket_path = socket_path;
+    } else {
+        MP_RETURN_IF_ERROR(BindTcpSocket(address));
+    }
+    if (listen(this->listening_fd, SOMAXCONN) != 0) {
+        absl::Status status = ErrnoStatus("Could not listen on metrics export socket");
+        Stop();
+        return status;
+    }
+    this->running = true;
+    this->serving_thread = std::thread(&OpenMetricsExporter::Serve, this);
+    LOG(INFO) << "Serving OpenMetrics at " << address << ".";
+    return absl::OkStatus();
+}
+
+absl::Status OpenMetricsExporter::BindTcpSocket(const std::string& address) {
+    std::string host = "127.0.0.1";
+    std::string port_text = address;
+    size_t colon_position = address.rfind(':');
+    if (colon_position != std::string::npos) {
+        host = address.substr(0, colon_position);
+        port_text = address.substr(colon_position + 1);
+        if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+            // bracketed IPv6 address
+            host = host.substr(1, host.size() - 2);
+        }
+        if (host.empty()) {
+            host = "127.0.0.1";
+        }
+    }
+    int port;
+    if (!absl::SimpleAtoi(port_text, &port) || port <= 0 || port > 65535) {
+        return absl::InvalidArgumentError("Invalid port for metrics export: " + address);
+    }
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* resolved_addresses = nullptr;
+    int resolution_result = getaddrinfo(host.c_str(), port_text.c_str(), &hints, &resolved_addresses);
+    if (resolution_result != 0) {
+        return absl::InvalidArgumentError(
+            "Could not resolve metrics export host " + host + ": " + gai_strerror(resolution_result)
+        );
+    }
+    // bind to the first resolved address that works
+    absl::Status status = absl::InternalError("No address found for metrics export host " + host + ".");
+    for (addrinfo* resolved_address = resolved_addresses; resolved_address != nullptr;
+         resolved_address = resolved_address->ai_next) {
+        this->listening_fd = socket(
+            resolved_address->ai_family, resolved_address->ai_socktype | SOCK_CLOEXEC, resolved_address->ai_protocol
+        );
+        if (this->listening_fd < 0) {
+            status = ErrnoStatus("Could not create metrics export socket");
+            continue;
+        }
+        int reuse_address = 1;
+        setsockopt(this->listening_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address));
+        if (bind(this->listening_fd, resolved_address->ai_addr, resolved_address->ai_addrlen) == 0) {
+            status = absl::OkStatus();
+            break;
+        }
+        status = ErrnoStatus("Could not bind metrics export socket to " + address);
+        close(this->listening_fd);
+        this->listening_fd = -1;
+    }
+    freeaddrinfo(resolved_addresses);
+    return status;
+}
+
+void OpenMetricsExporter::AddRegistry(const MetricsRegistry& registry) {
+    std::lock_guard<std::mutex> lock(this->registries_mutex);
+    this->registries.push_back(&registry);
+}
+
+void OpenMetricsExporter::RemoveRegistry(const MetricsRegistry& registry) {
+    std::lock_guard<std::mutex> lock(this->registries_mutex);
+    this->registries.erase(
+        std::remove(this->registries.begin(), this->registries.end(), &registry), this->registries.end()
+    );
+}
+
+void OpenMetricsExporter::Stop() {
+    this->running = false;
+    if (this->serving_thread.joinable()) {
+        this->serving_thread.join();
+    }
+    if (this->listening_fd >= 0) {
+        close(this->listening_fd);
+        this->listening_fd = -1;
+    }
+    if (!this->unix_socket_path.empty()) {
+        unlink(this->unix_socket_path.c_str());
+        this->unix_socket_path.clear();
+    }
+}
+
+void OpenMetricsExporter::Serve() {
+    pollfd listening_poll_fd{this->listening_fd, POLLIN, 0};
+    while (this->running) {
+        int ready_count = poll(&listening_poll_fd, 1, kAcceptPollIntervalMs);
+        if (ready_count <= 0) {
+            continue;
+        }
+        int connection_fd = accept4(this->listening_fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection_fd < 0) {
+            continue;
+        }
+        HandleConnection(connection_fd);
+        close(connection_fd);
+    }
+}
+
+void OpenMetricsExporter::HandleConnection(int connection_fd) const {
+    // read until the end of the request headers (requests have no body we care about)
+    std::string request;
+    char buffer[1024];
+    pollfd connection_poll_fd{connection_fd, POLLIN, 0};
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < kMaxRequestSize) {
+        if (poll(&connection_poll_fd, 1, kRequestReadTimeoutMs) <= 0) {
+            return;
+        }
+        ssize_t received_byte_count = recv(connection_fd, buffer, sizeof(buffer), 0);
+        if (received_byte_count <= 0) {
+            return;
+        }
+        request.append(buffer, static_cast<size_t>(received_byte_count));
+    }
+    std::string response;
+    if (request.rfind("GET ", 0) == 0) {
+        std::string body;
+        {
+            // registries can't go away while being serialized
+            std::lock_guard<std::mutex> lock(this->registries_mutex);
+            body = MetricsRegistry::SerializeOpenMetrics(this->registries);
+        }
+        response = "HTTP/1.1 200 OK\r\n"
+                   "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                   "Connection: close\r\n\r\n" + body;
+    } else {
+        response = "HTTP/1.1 405 Method Not Allowed\r\nAllow: GET\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    SendAll(connection_fd, response);
+}
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,86 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/status.h>
+#include <absl/status/statusor.h>
+// === local includes (if any) ===
+#include "metrics_registry.hpp"
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Serves the metrics of MetricsRegistry instances as OpenMetrics text over HTTP, for Prometheus to scrape.
+ *
+ * Any GET request is answered with the full exposition of all registries added to the exporter. Requests are served
+ * one at a time on a dedicated thread, so scrapes never run on (or block) the frame pipeline. Containers exporting at
+ * the same address share a single exporter (see GetInstance), their metrics told apart by the container label.
+ */
+class OpenMetricsExporter {
+public:
+    /** @brief Keeps a registry exported, and the exporter alive, for as long as it exists. */
+    class Registration {
+    public:
+        /** @param registry registry to export; must outlive the registration */
+        Registration(std::shared_ptr<OpenMetricsExporter> exporter, const MetricsRegistry& registry);
+        ~Registration();
+        Registration(const Registration&) = delete;
+        Registration& operator=(const Registration&) = delete;
+    private:
+        std::shared_ptr<OpenMetricsExporter> exporter;
+        const MetricsRegistry& registry;
+    };
+
+    /**
+     * Get the process-wide exporter serving at the given address, starting one if none is alive there.
+     * @param address see Start
+     */
+    static absl::StatusOr<std::shared_ptr<OpenMetricsExporter>> GetInstance(const std::string& address);
+
+    OpenMetricsExporter() = default;
+    ~OpenMetricsExporter();
+
+    OpenMetricsExporter(const OpenMetricsExporter&) = delete;
+    OpenMetricsExporter& operator=(const OpenMetricsExporter&) = delete;
+
+    /**
+     * Start listening & serving.
+     * @param address either "unix:<socket path>", "<host>:<port>", or "<port>" (host then defaults to 127.0.0.1); the
+     * host may be a name or an IPv4/IPv6 address (IPv6 in brackets); an existing file at the socket path is only
+     * replaced if it is a socket nobody listens on anymore
+     */
+    absl::Status Start(const std::string& address);
+    /** Stop serving & close the listening socket. */
+    void Stop();
+    bool IsRunning() const { return this->running; }
+
+    /** Export the given registry along with those added before; it must stay alive until removed. */
+    void AddRegistry(const MetricsRegistry& registry);
+    /** Stop exporting the given registry; waits for a scrape in progress to finish. */
+    void RemoveRegistry(const MetricsRegistry& registry);
+
+private:
+    absl::Status BindTcpSocket(const std::string& address);
+    void Serve();
+    void HandleConnection(int connection_fd) const;
+
+    mutable std::mutex registries_mutex;
+    std::vector<const MetricsRegistry*> registries;
+    int listening_fd = -1;
+    std::string unix_socket_path;
+    std::atomic<bool> running = false;
+    std::thread serving_thread;
+};
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,255 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "metrics_registry.hpp"
+
+namespace presage::smartspectra::container {
+
+namespace metrics_internal {
+int GetThreadShardIndex() {
+    static std::atomic<int> next_thread_index = 0;
+    thread_local const int shard_index = next_thread_index.fetch_add(1, std::memory_order_relaxed) % kShardCount;
+    return shard_index;
+}
+} // namespace metrics_internal
+
+namespace {
+
+void WriteValue(std::ostringstream& output, double value) {
+    if (value == std::numeric_limits<double>::infinity()) {
+        output << "+Inf";
+    } else {
+        output << value;
+    }
+}
+
+/** Quoted & escaped label value. */
+std::string FormatLabelValue(const std::string& value) {
+    std::string quoted_value = "\"";
+    for (char character: value) {
+        if (character == '\\' || character == '"') {
+            quoted_value += '\\';
+            quoted_value += character;
+        } else if (character == '\n') {
+            quoted_value += "\\n";
+        } else {
+            quoted_value += character;
+        }
+    }
+    return quoted_value + "\"";
+}
+
+/** Label set of a sample, e.g. {container="0",le="0.5"}; empty if there are no labels. */
+std::string FormatLabelSet(const std::string& label_text, const std::string& extra_label_text = "") {
+    if (label_text.empty() && extra_label_text.empty()) {
+        return "";
+    }
+    if (label_text.empty() || extra_label_text.empty()) {
+        return "{" + label_text + extra_label_text + "}";
+    }
+    return "{" + label_text + "," + extra_label_text + "}";
+}
+
+} // anonymous namespace
+
+// ==== Counter
+
+uint64_t Counter::Value() const {
+    uint64_t value = 0;
+    for (const auto& shard: this->shards) {
+        value += shard.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+// ==== Histogram
+
+Histogram::Histogram(std::vector<double> bucket_upper_bounds) : bucket_upper_bounds(std::move(bucket_upper_bounds)) {
+    for (auto& shard: this->shards) {
+        // one extra bucket for +Inf
+        const size_t bucket_count = this->bucket_upper_bounds.size() + 1;
+        shard.bucket_counts = std::make_unique<std::atomic<uint64_t>[]>(bucket_count);
+        for (size_t i_bucket = 0; i_bucket < bucket_count; i_bucket++) {
+            shard.bucket_counts[i_bucket].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void Histogram::Observe(double value) {
+    // bucket lists are short, so a linear scan beats a binary search here
+    size_t i_bucket = 0;
+    while (i_bucket < this->bucket_upper_bounds.size() && value > this->bucket_upper_bounds[i_bucket]) {
+        i_bucket++;
+    }
+    Shard& shard = this->shards[metrics_internal::GetThreadShardIndex()];
+    shard.bucket_counts[i_bucket].fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> Histogram::GetBucketCounts() const {
+    std::vector<uint64_t> bucket_counts(this->bucket_upper_bounds.size() + 1, 0);
+    for (const auto& shard: this->shards) {
+        for (size_t i_bucket = 0; i_bucket < bucket_counts.size(); i_bucket++) {
+            bucket_counts[i_bucket] += shard.bucket_counts[i_bucket].load(std::memory_order_relaxed);
+        }
+    }
+    return bucket_counts;
+}
+
+double Histogram::GetSum() const {
+    double sum = 0.0;
+    for (const auto& shard: this->shards) {
+        sum += shard.sum.load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+// ==== MetricsRegistry
+
+MetricsRegistry::MetricsRegistry(const std::string& container_label)
+    : container_label(container_label),
+      label_text(container_label.empty() ? "" : "container=" + FormatLabelValue(container_label)) {}
+
+std::vector<double> MetricsRegistry::GetDefaultDurationBuckets() {
+    return {0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5};
+}
+
+Counter& MetricsRegistry::AddCounter(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(this->registration_mutex);
+    return *this->counters.emplace_back(Family<Counter>{name, help, std::make_unique<Counter>()}).metric;
+}
+
+Gauge& MetricsRegistry::AddGauge(const std::string& name, const std::string& help) {
+    std::lock_guard<std::mutex> lock(this->registration_mutex);
+    return *this->gauges.emplace_back(Family<Gauge>{name, help, std::make_unique<Gauge>()}).metric;
+}
+
+Histogram& MetricsRegistry::AddHistogram(
+    const std::string& name,
+    const std::string& help,
+    std::vector<double> bucket_upper_bounds
+) {
+    std::sort(bucket_upper_bounds.begin(), bucket_upper_bounds.end());
+    std::lock_guard<std::mutex> lock(this->registration_mutex);
+    return *this->histograms.emplace_back(
+        Family<Histogram>{name, help, std::make_unique<Histogram>(std::move(bucket_upper_bounds))}
+    ).metric;
+}
+
+std::string MetricsRegistry::SerializeOpenMetrics() const {
+    return SerializeOpenMetrics({this});
+}
+
+std::string MetricsRegistry::SerializeOpenMetrics(const std::vector<const MetricsRegistry*>& registries) {
+    // samples of all registries grouped by family, families in the order they first turn up
+    std::vector<std::string> family_names;
+    std::unordered_map<std::string, std::ostringstream> family_outputs;
+    auto get_family_output = [&](const std::string& name, const char* type, const std::string& help)
+        -> std::ostringstream& {
+        auto [family_output, inserted] = family_outputs.try_emplace(name);
+        if (inserted) {
+            family_names.push_back(name);
+            family_output->second << std::setprecision(15)
+                                  << "# TYPE " << name << " " << type << "\n"
+                                  << "# HELP " << name << " " << help << "\n";
+        }
+        return family_output->second;
+    };
+    for (const MetricsRegistry* registry: registries) {
+        std::lock_guard<std::mutex> lock(registry->registration_mutex);
+        const std::string label_set = FormatLabelSet(registry->label_text);
+        for (const auto& family: registry->counters) {
+            get_family_output(family.name, "counter", family.help)
+                << family.name << "_total" << label_set << " " << family.metric->Value() << "\n";
+        }
+        for (const auto& family: registry->gauges) {
+            get_family_output(family.name, "gauge", family.help)
+                << family.name << label_set << " " << family.metric->Value() << "\n";
+        }
+        for (const auto& family: registry->histograms) {
+            std::ostringstream& output = get_family_output(family.name, "histogram", family.help);
+            const auto& bucket_upper_bounds = family.metric->GetBucketUpperBounds();
+            const auto bucket_counts = family.metric->GetBucketCounts();
+            uint64_t cumulative_count = 0;
+            for (size_t i_bucket = 0; i_bucket < bucket_counts.size(); i_bucket++) {
+                cumulative_count += bucket_counts[i_bucket];
+                std::ostringstream bound_label_text;
+                bound_label_text << std::setprecision(15) << "le=\"";
+                WriteValue(bound_label_text, i_bucket < bucket_upper_bounds.size()
+                                             ? bucket_upper_bounds[i_bucket]
+                                             : std::numeric_limits<double>::infinity());
+                bound_label_text << "\"";
+                output << family.name << "_bucket" << FormatLabelSet(registry->label_text, bound_label_text.str())
+                       << " " << cumulative_count << "\n";
+            }
+            output << family.name << "_sum" << label_set << " " << family.metric->GetSum() << "\n"
+                   << family.name << "_count" << label_set << " " << cumulative_count << "\n";
+        }
+    }
+    std::string exposition;
+    for (const auto& name: family_names) {
+        exposition += family_outputs[name].str();
+    }
+    exposition += "# EOF\n";
+    return exposition;
+}
+
+// ==== ContainerMetrics
+
+ContainerMetrics ContainerMetrics::Register(MetricsRegistry& registry) {
+    const auto duration_buckets = MetricsRegistry::GetDefaultDurationBuckets();
+    ContainerMetrics metrics;
+    metrics.capture_seconds = &registry.AddHistogram(
+        "smartspectra_frame_capture_seconds", "Time spent grabbing a frame from the video source.", duration_buckets
+    );
+    metrics.conversion_seconds = &registry.AddHistogram(
+        "smartspectra_frame_conversion_seconds", "Time spent converting a frame into a graph-ready buffer.",
+        duration_buckets
+    );
+    metrics.feed_seconds = &registry.AddHistogram(
+        "smartspectra_frame_feed_seconds", "Time spent sending a frame into the graph.", duration_buckets
+    );
+    metrics.output_retrieval_seconds = &registry.AddHistogram(
+        "smartspectra_output_retrieval_seconds",
+        "Time graph output waits between being produced and being handled.", duration_buckets
+    );
+    metrics.callback_seconds = &registry.AddHistogram(
+        "smartspectra_output_callback_seconds", "Time spent handling graph output, including user callbacks.",
+        duration_buckets
+    );
+    metrics.frames_captured = &registry.AddCounter(
+        "smartspectra_frames_captured", "Frames grabbed from the video source."
+    );
+    metrics.frames_fed = &registry.AddCounter("smartspectra_frames_fed", "Frames sent into the graph.");
+    metrics.frames_dropped_from_capture_queue = &registry.AddCounter(
+        "smartspectra_frames_dropped_from_capture_queue", "Frames lost to capture queue overflow."
+    );
+    metrics.frames_dropped_by_graph = &registry.AddCounter(
+        "smartspectra_frames_dropped_by_graph", "Frames the graph did not send through for processing."
+    );
+    metrics.capture_queue_depth = &registry.AddGauge(
+        "smartspectra_capture_queue_depth", "Frames waiting between the capture and the conversion/feed stages."
+    );
+    metrics.output_queue_depth = &registry.AddGauge(
+        "smartspectra_output_queue_depth", "Graph output packets waiting to be handled."
+    );
+    return metrics;
+}
+
+std::string ContainerMetrics::GetNextContainerLabel() {
+    static std::atomic<int> next_container_index = 0;
+    return std::to_string(next_container_index.fetch_add(1, std::memory_order_relaxed));
+}
+
+} // namespace presage::smartspectra::container
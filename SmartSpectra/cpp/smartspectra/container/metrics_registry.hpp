@@ -0,0 +1,173 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+namespace metrics_internal {
+// Counters & histograms are split into shards (each on its own cache line) that threads update independently,
+// so that hot paths on different threads never contend on the same atomic.
+constexpr int kShardCount = 16;
+constexpr size_t kCacheLineSize = 64;
+/** Index of the shard the calling thread updates. */
+int GetThreadShardIndex();
+} // namespace metrics_internal
+
+/** @brief Monotonically increasing count of events. Lock-free. */
+class Counter {
+public:
+    void Increment(uint64_t amount = 1) {
+        this->shards[metrics_internal::GetThreadShardIndex()].value.fetch_add(amount, std::memory_order_relaxed);
+    }
+    uint64_t Value() const;
+private:
+    struct alignas(metrics_internal::kCacheLineSize) Shard {
+        std::atomic<uint64_t> value = 0;
+    };
+    Shard shards[metrics_internal::kShardCount];
+};
+
+/** @brief Current value of something that can go up & down, e.g. a queue depth. Lock-free. */
+class Gauge {
+public:
+    void Set(int64_t value) { this->value.store(value, std::memory_order_relaxed); }
+    int64_t Value() const { return this->value.load(std::memory_order_relaxed); }
+private:
+    std::atomic<int64_t> value = 0;
+};
+
+/** @brief Distribution of observed values over fixed buckets (cumulative on export). Lock-free. */
+class Histogram {
+public:
+    /** @param bucket_upper_bounds inclusive upper bounds of buckets, in increasing order (+Inf is implicit) */
+    explicit Histogram(std::vector<double> bucket_upper_bounds);
+
+    void Observe(double value);
+    /** Observe the time elapsed since start, in seconds. */
+    void ObserveSince(std::chrono::steady_clock::time_point start) {
+        Observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    const std::vector<double>& GetBucketUpperBounds() const { return this->bucket_upper_bounds; }
+    /** Per-bucket (non-cumulative) counts, the last one being the +Inf bucket. */
+    std::vector<uint64_t> GetBucketCounts() const;
+    double GetSum() const;
+
+private:
+    struct alignas(metrics_internal::kCacheLineSize) Shard {
+        std::unique_ptr<std::atomic<uint64_t>[]> bucket_counts;
+        std::atomic<double> sum = 0.0;
+    };
+    const std::vector<double> bucket_upper_bounds;
+    Shard shards[metrics_internal::kShardCount];
+};
+
+/**
+ * @brief Observes the time spent in a scope into a histogram, if one is provided.
+ */
+class ScopedTimer {
+public:
+    /** @param histogram histogram to observe into; if nullptr (e.g., metrics are disabled), the timer does nothing */
+    explicit ScopedTimer(Histogram* histogram)
+        : histogram(histogram),
+          start(histogram != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}) {}
+    ~ScopedTimer() { Stop(); }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /** Observe the time elapsed so far and disarm the timer. */
+    void Stop() {
+        if (this->histogram != nullptr) {
+            this->histogram->ObserveSince(this->start);
+            this->histogram = nullptr;
+        }
+    }
+private:
+    Histogram* histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+/**
+ * @brief Owns named metrics and serializes them in the OpenMetrics text format.
+ *
+ * Metrics are registered up-front and then updated from hot paths without locking. Registered metrics keep their
+ * address for the lifetime of the registry. All metrics of a registry carry its container label (if any), so that
+ * those of several registries can be told apart when exported together.
+ */
+class MetricsRegistry {
+public:
+    /** @param container_label value of the "container" label on all metrics of the registry; none if empty */
+    explicit MetricsRegistry(const std::string& container_label = "");
+
+    /** Default histogram buckets for durations, in seconds (0.5 ms to 2.5 s). */
+    static std::vector<double> GetDefaultDurationBuckets();
+
+    /** @param name metric family name, without the "_total" suffix */
+    Counter& AddCounter(const std::string& name, const std::string& help);
+    Gauge& AddGauge(const std::string& name, const std::string& help);
+    Histogram& AddHistogram(
+        const std::string& name, const std::string& help, std::vector<double> bucket_upper_bounds
+    );
+
+    const std::string& GetContainerLabel() const { return this->container_label; }
+
+    /** Serialize all metrics as an OpenMetrics text exposition, terminated by "# EOF". */
+    std::string SerializeOpenMetrics() const;
+    /** Serialize the metrics of several registries as a single exposition, with same-named metrics in one family. */
+    static std::string SerializeOpenMetrics(const std::vector<const MetricsRegistry*>& registries);
+
+private:
+    template<typename TMetric>
+    struct Family {
+        std::string name;
+        std::string help;
+        std::unique_ptr<TMetric> metric;
+    };
+
+    const std::string container_label;
+    // container label as written into the label set of each sample, e.g. container="0"
+    const std::string label_text;
+    mutable std::mutex registration_mutex;
+    std::deque<Family<Counter>> counters;
+    std::deque<Family<Gauge>> gauges;
+    std::deque<Family<Histogram>> histograms;
+};
+
+/**
+ * @brief Hot-path metrics of a container. All pointers are nullptr if metrics are disabled.
+ */
+struct ContainerMetrics {
+    Histogram* capture_seconds = nullptr;
+    Histogram* conversion_seconds = nullptr;
+    Histogram* feed_seconds = nullptr;
+    Histogram* output_retrieval_seconds = nullptr;
+    Histogram* callback_seconds = nullptr;
+    Counter* frames_captured = nullptr;
+    Counter* frames_fed = nullptr;
+    Counter* frames_dropped_from_capture_queue = nullptr;
+    Counter* frames_dropped_by_graph = nullptr;
+    Gauge* capture_queue_depth = nullptr;
+    Gauge* output_queue_depth = nullptr;
+
+    /** Register all container metrics with the given registry. */
+    static ContainerMetrics Register(MetricsRegistry& registry);
+    /** Next container label of a process-wide sequence ("0", "1", ...), for containers that weren't given one. */
+    static std::string GetNextContainerLabel();
+};
+
+} // namespace presage::smartspectra::container
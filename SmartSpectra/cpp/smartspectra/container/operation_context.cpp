@@ -6,22 +6,20 @@
 // === standard library includes (if any) ===
 // === third-party includes (if any) ===
 #include <absl/status/status.h>
+#include <mediapipe/framework/port/logging.h>
 #include <physiology/graph/stream_and_packet_names.h>
 // === local includes (if any) ===
 #include "operation_context.hpp"
-#include "packet_helpers.hpp"
 
 namespace presage::smartspectra::container {
-namespace ph = packet_helpers;
 namespace pe = physiology::edge;
 
 template<settings::OperationMode TOperationMode>
-absl::Status OperationContext<TOperationMode>::InitializePollers(mediapipe::CalculatorGraph& graph) {
-    return absl::OkStatus();
-}
-
-template<settings::OperationMode TOperationMode>
-absl::Status OperationContext<TOperationMode>::QueryPollers(bool& operation_state_changed, bool verbose) {
+absl::Status OperationContext<TOperationMode>::ObserveOutputStreams(
+    mediapipe::CalculatorGraph& graph,
+    OutputStreamMultiplexer& multiplexer,
+    bool verbose
+) {
     return absl::OkStatus();
 }
 
@@ -37,26 +35,22 @@ void OperationContext<settings::OperationMode::Spot>::Reset() {
     time_left_s = spot_duration_s;
 }
 
-absl::Status OperationContext<settings::OperationMode::Spot>::InitializePollers(mediapipe::CalculatorGraph& graph) {
-    return this->time_left_poller.Initialize(graph, pe::graph::output_streams::spot::kTimeLeft);
-}
-
-
-absl::Status OperationContext<settings::OperationMode::Spot>::QueryPollers(
-    bool& operation_state_changed,
+absl::Status OperationContext<settings::OperationMode::Spot>::ObserveOutputStreams(
+    mediapipe::CalculatorGraph& graph,
+    OutputStreamMultiplexer& multiplexer,
     bool verbose
 ) {
-    double previous_time_left = this->time_left_s;
-    MP_RETURN_IF_ERROR(ph::GetPacketContentsIfAny(
-        this->time_left_s,
-        operation_state_changed,
-        time_left_poller.Get(),
-        pe::graph::output_streams::spot::kTimeLeft,
-        [this, &verbose, &previous_time_left]() {
-            return (this->time_left_s < this->spot_duration_s && this->time_left_s != previous_time_left) || verbose;
+    return multiplexer.Observe(
+        graph, pe::graph::output_streams::spot::kTimeLeft,
+        [this, verbose](const mediapipe::Packet& time_left_packet) {
+            double previous_time_left = this->time_left_s;
+            this->time_left_s = time_left_packet.Get<double>();
+            if ((this->time_left_s < this->spot_duration_s && this->time_left_s != previous_time_left) || verbose) {
+                LOG(INFO) << "Got " << pe::graph::output_streams::spot::kTimeLeft << " packet: " << this->time_left_s;
+            }
+            return absl::OkStatus();
         }
-    ));
-    return absl::OkStatus();
+    );
 }
 // endregion ===========================================================================================================
 
@@ -24,10 +24,9 @@
 #include <mediapipe/framework/calculator_graph.h>
 // === local includes (if any) ===
 #include "settings.hpp"
-#include "output_stream_poller_wrapper.hpp"
+#include "output_stream_multiplexer.hpp"
 
 namespace presage::smartspectra::container {
-namespace poller = output_stream_poller_wrapper;
 
 template<settings::OperationMode TOperationMode>
 /**
@@ -37,10 +36,12 @@ class OperationContext {
 public:
     explicit OperationContext(const settings::OperationSettings<settings::OperationMode::Continuous>& settings) {};
     void Reset(){};
-    /** Initialize pollers required for the given operation mode. */
-    absl::Status InitializePollers(mediapipe::CalculatorGraph& graph);
-    /** Poll graph output streams and update internal state. */
-    absl::Status QueryPollers(bool& operation_state_changed, bool verbose);
+    /** Observe graph output streams specific to the operation mode and update internal state upon their output. */
+    absl::Status ObserveOutputStreams(
+        mediapipe::CalculatorGraph& graph,
+        OutputStreamMultiplexer& multiplexer,
+        bool verbose
+    );
 };
 
 template<>
@@ -50,14 +51,15 @@ public:
     explicit OperationContext(const settings::OperationSettings<settings::OperationMode::Spot>& operation_settings);
     /** Reset internal state to the beginning of a spot run. */
     void Reset();
-    /** Initialize pollers required for spot mode. */
-    absl::Status InitializePollers(mediapipe::CalculatorGraph& graph);
-    /** Poll spot specific streams and update state. */
-    absl::Status QueryPollers(bool& operation_state_changed, bool verbose);
+    /** Observe spot specific streams and update state upon their output. */
+    absl::Status ObserveOutputStreams(
+        mediapipe::CalculatorGraph& graph,
+        OutputStreamMultiplexer& multiplexer,
+        bool verbose
+    );
 private:
     double time_left_s;
     const double spot_duration_s;
-    poller::OutputStreamPollerWrapper time_left_poller;
 };
 
 } // namespace presage::smartspectra::container
@@ -0,0 +1,105 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "output_stream_multiplexer.hpp"
+
+namespace presage::smartspectra::container {
+
+absl::Status OutputStreamMultiplexer::Observe(
+    mediapipe::CalculatorGraph& graph,
+    const std::string& stream_name,
+    PacketHandler handler
+) {
+    if (handler == nullptr) {
+        return absl::InvalidArgumentError("Handler for output stream " + stream_name + " cannot be nullptr.");
+    }
+    const size_t stream_index = this->streams.size();
+    this->streams.push_back(Stream{stream_name, std::move(handler)});
+    return graph.ObserveOutputStream(
+        stream_name,
+        [this, stream_index](const mediapipe::Packet& packet) {
+            if (!packet.IsEmpty()) {
+                auto arrival_time = this->retrieval_seconds != nullptr ? std::chrono::steady_clock::now()
+                                                                       : std::chrono::steady_clock::time_point{};
+                {
+                    std::lock_guard<std::mutex> lock(this->queue_mutex);
+                    this->pending_packets.push_back(TaggedPacket{stream_index, packet, arrival_time});
+                }
+                this->queue_condition.notify_one();
+            }
+            return absl::OkStatus();
+        }
+    );
+}
+
+absl::StatusOr<int> OutputStreamMultiplexer::DispatchPending(std::chrono::milliseconds timeout) {
+    {
+        std::unique_lock<std::mutex> lock(this->queue_mutex);
+        if (this->pending_packets.empty() && timeout.count() > 0) {
+            this->queue_condition.wait_for(lock, timeout, [this] {
+                return !this->pending_packets.empty() || this->wake_up_requested;
+            });
+        }
+        this->wake_up_requested = false;
+        this->dispatched_packets.swap(this->pending_packets);
+    }
+    if (this->pending_packet_count != nullptr) {
+        this->pending_packet_count->Set(static_cast<int64_t>(this->dispatched_packets.size()));
+    }
+    // handlers run without holding the lock, so observers never wait on them
+    absl::Status status = absl::OkStatus();
+    int dispatched_packet_count = 0;
+    for (const auto& tagged_packet: this->dispatched_packets) {
+        if (this->retrieval_seconds != nullptr) {
+            this->retrieval_seconds->ObserveSince(tagged_packet.arrival_time);
+        }
+        ScopedTimer handler_timer(this->handler_seconds);
+        status = this->streams[tagged_packet.stream_index].handler(tagged_packet.packet);
+        if (!status.ok()) {
+            break;
+        }
+        dispatched_packet_count++;
+    }
+    this->dispatched_packets.clear();
+    MP_RETURN_IF_ERROR(status);
+    return dispatched_packet_count;
+}
+
+void OutputStreamMultiplexer::SetMetrics(
+    Histogram* retrieval_seconds,
+    Histogram* handler_seconds,
+    Gauge* pending_packet_count
+) {
+    this->retrieval_seconds = retrieval_seconds;
+    this->handler_seconds = handler_seconds;
+    this->pending_packet_count = pending_packet_count;
+}
+
+void OutputStreamMultiplexer::WakeUp() {
+    {
+        std::lock_guard<std::mutex> lock(this->queue_mutex);
+        this->wake_up_requested = true;
+    }
+    this->queue_condition.notify_one();
+}
+
+size_t OutputStreamMultiplexer::PendingCount() const {
+    std::lock_guard<std::mutex> lock(this->queue_mutex);
+    return this->pending_packets.size();
+}
+
+void OutputStreamMultiplexer::Clear() {
+    std::lock_guard<std::mutex> lock(this->queue_mutex);
+    this->streams.clear();
+    this->pending_packets.clear();
+    this->wake_up_requested = false;
+}
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,96 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/status.h>
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/calculator_graph.h>
+#include <mediapipe/framework/packet.h>
+// === local includes (if any) ===
+#include "metrics_registry.hpp"
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Funnels packets from several graph output streams into a single queue, dispatched on one thread.
+ *
+ * Graph observers (invoked on MediaPipe's threads) only tag each packet with its stream and push it into one
+ * multi-producer / single-consumer queue. The consumer thread calls DispatchPending, which sleeps until packets
+ * arrive, then drains everything that is pending and runs the registered handlers in arrival order. This way, output
+ * is handled as soon as the graph produces it, and handlers that need to run on a particular thread (e.g., GUI) can.
+ */
+class OutputStreamMultiplexer {
+public:
+    typedef std::function<absl::Status(const mediapipe::Packet&)> PacketHandler;
+
+    OutputStreamMultiplexer() = default;
+    OutputStreamMultiplexer(const OutputStreamMultiplexer&) = delete;
+    OutputStreamMultiplexer& operator=(const OutputStreamMultiplexer&) = delete;
+
+    /**
+     * Start observing a graph output stream. Must be called before the graph is started.
+     * @param handler invoked on the dispatching thread for every non-empty packet from the stream
+     */
+    absl::Status Observe(mediapipe::CalculatorGraph& graph, const std::string& stream_name, PacketHandler handler);
+
+    /**
+     * Wait until packets are available (or the timeout expires, or WakeUp is called), then dispatch all packets
+     * pending at that moment to their handlers.
+     * @return number of packets dispatched
+     */
+    absl::StatusOr<int> DispatchPending(std::chrono::milliseconds timeout);
+
+    /**
+     * Collect dispatch metrics. Must be called before observing streams. Any of the metrics may be nullptr.
+     * @param retrieval_seconds time from a packet arriving from the graph to its handler being invoked
+     * @param handler_seconds time spent in a handler
+     * @param pending_packet_count number of packets found pending at each dispatch
+     */
+    void SetMetrics(Histogram* retrieval_seconds, Histogram* handler_seconds, Gauge* pending_packet_count);
+
+    /** Interrupt a dispatcher waiting for packets, e.g. to let it check for shutdown. */
+    void WakeUp();
+
+    /** Number of packets waiting to be dispatched. */
+    size_t PendingCount() const;
+
+    /** Drop all observed streams & pending packets, e.g. before observing streams of a restarted graph. */
+    void Clear();
+
+private:
+    struct TaggedPacket {
+        size_t stream_index;
+        mediapipe::Packet packet;
+        // only set when retrieval time is measured
+        std::chrono::steady_clock::time_point arrival_time;
+    };
+
+    struct Stream {
+        std::string name;
+        PacketHandler handler;
+    };
+
+    std::vector<Stream> streams;
+    mutable std::mutex queue_mutex;
+    std::condition_variable queue_condition;
+    std::vector<TaggedPacket> pending_packets;
+    // swapped with pending_packets on every dispatch, so that its capacity is reused
+    std::vector<TaggedPacket> dispatched_packets;
+    bool wake_up_requested = false;
+    Histogram* retrieval_seconds = nullptr;
+    Histogram* handler_seconds = nullptr;
+    Gauge* pending_packet_count = nullptr;
+};
+
+} // namespace presage::smartspectra::container
@@ -125,4 +125,18 @@ inline absl::Status GetPacketContentsIfAny(
     );
 }
 
+// log contents of a packet that was received by other means than a poller, e.g. via an output stream observer
+template<typename TPacketContentsType>
+inline void LogPacketContentsIf(
+    bool report,
+    const char* stream_name,
+    const TPacketContentsType& contents,
+    mediapipe::Timestamp timestamp
+) {
+    if (report) {
+        LOG(INFO) << "Got " + std::string(stream_name) + " packet: " << contents
+                  << " (timestamp: " << timestamp.Value() << ")";
+    }
+}
+
 } // namespace presage::smartspectra::container::packet_helpers
@@ -122,6 +122,50 @@ std::vector<std::string> GetVideoSinkModeNames() {
     return names;
 }
 
+bool AbslParseFlag(absl::string_view text, FrameQueueOverflowPolicy* policy, std::string* error) {
+    if (text == "drop_oldest" || text == "DROP_OLDEST" || text == "drop-oldest") {
+        *policy = FrameQueueOverflowPolicy::DropOldest;
+        return true;
+    }
+    if (text == "drop_newest" || text == "DROP_NEWEST" || text == "drop-newest") {
+        *policy = FrameQueueOverflowPolicy::DropNewest;
+        return true;
+    }
+    if (text == "block" || text == "BLOCK" || text == "Block") {
+        *policy = FrameQueueOverflowPolicy::Block;
+        return true;
+    }
+    if (text == "auto" || text == "AUTO" || text == "unknown" || text == "unspecified" || text == "") {
+        *policy = FrameQueueOverflowPolicy::Unknown_EnumEnd;
+        return true;
+    }
+    *error = "unknown value for enumeration";
+    return false;
+}
+
+std::string AbslUnparseFlag(FrameQueueOverflowPolicy policy) {
+    switch(policy) {
+        case FrameQueueOverflowPolicy::DropOldest:
+            return "drop_oldest";
+        case FrameQueueOverflowPolicy::DropNewest:
+            return "drop_newest";
+        case FrameQueueOverflowPolicy::Block:
+            return "block";
+        case FrameQueueOverflowPolicy::Unknown_EnumEnd:
+            return "auto";
+        default:
+            return absl::StrCat(policy);
+    }
+}
 
+std::vector<std::string> GetFrameQueueOverflowPolicyNames() {
+    std::vector<std::string> names;
+    for (int policy = static_cast<int>(FrameQueueOverflowPolicy::DropOldest);
+         policy <= static_cast<int>(FrameQueueOverflowPolicy::Unknown_EnumEnd);
+         ++policy) {
+        names.push_back(AbslUnparseFlag(static_cast<FrameQueueOverflowPolicy>(policy)));
+    }
+    return names;
+}
 
 } // namespace presage::smartspectra::container::settings
@@ -106,12 +106,100 @@ struct VideoSinkSettings {
     bool passthrough;
 };
 // endregion ===========================================================================================================
+// region ============================ Frame Buffer Settings ===========================================================
+struct ImageFramePoolSettings {
+    // recycle input frame pixel buffers instead of allocating a new one for every frame
+    bool enabled = true;
+    // maximum number of released buffers kept for reuse per distinct frame size
+    int max_free_buffers_per_size = 8;
+    // size of the hugepage-backed arena to carve pixel buffers from (Linux only); 0 disables the arena
+    int huge_page_arena_size_mb = 0;
+};
+// endregion ===========================================================================================================
+// region ============================ Frame Pipeline Settings =========================================================
+// What to do with a newly captured frame when the frame queue between pipeline stages is full
+enum class FrameQueueOverflowPolicy : int {
+    DropOldest, // evict the oldest queued frame, keeping capture on the sensor cadence
+    DropNewest, // discard the newly captured frame
+    Block, // wait for the downstream stage to catch up (no frames are lost)
+    Unknown_EnumEnd // pick automatically: block for prerecorded/file-stream input, drop oldest for live cameras
+};
+std::vector<std::string> GetFrameQueueOverflowPolicyNames();
+bool AbslParseFlag(absl::string_view text, FrameQueueOverflowPolicy* policy, std::string* error);
+std::string AbslUnparseFlag(FrameQueueOverflowPolicy policy);
+
+struct FramePipelineSettings {
+    // capacity of the queue between the capture stage and the conversion/feed stage
+    int frame_queue_capacity = 4;
+    FrameQueueOverflowPolicy overflow_policy = FrameQueueOverflowPolicy::Unknown_EnumEnd;
+};
+
+struct FramePacingSettings {
+    // maximum frame capture rate; if not positive, frames are paced at 1000 / interframe_delay_ms FPS
+    double target_fps = 0.0;
+    // (prerecorded input only) instead of pacing frames at a frame rate, capture each frame as soon as the graph has
+    // let the previous one through or dropped it; frame timestamps still come from the input
+    bool fast_replay = false;
+    // lower the pacing rate when the graph drops frames, and raise it back up to the target when it keeps up
+    bool adaptive = true;
+    double minimum_fps = 5.0;
+    // number of frame-sent-through reports the drop ratio is computed over before each adjustment
+    int adaptation_window_frame_count = 30;
+    // drop ratio above which the pacing rate is multiplied by backoff_factor
+    double backoff_drop_ratio = 0.1;
+    double backoff_factor = 0.8;
+    // drop ratio at or below which the pacing rate is raised by recovery_step_fps
+    double recovery_drop_ratio = 0.02;
+    double recovery_step_fps = 1.0;
+};
+// endregion ===========================================================================================================
+// region ============================ Graph Executor Settings =========================================================
+struct GraphExecutorSettings {
+    // run graph calculators on a process-wide thread pool shared by all containers that opt in,
+    // instead of on a thread pool of the container's own
+    bool use_shared_pool = false;
+    // worker threads of the shared pool; 0 uses the hardware concurrency (only the container that creates the pool
+    // determines its size)
+    int shared_pool_thread_count = 0;
+    // share of shared pool time given to this container's graph relative to other containers, when the pool is busy
+    double weight = 1.0;
+};
+// endregion ===========================================================================================================
+// region ============================ ROI Crop Settings ===============================================================
+struct RoiCropSettings {
+    // crop frames to the region around the tracked face before sending them into the graph; needs continuous mode
+    // with edge metrics & dense facemesh points on, since the face is tracked through the edge metrics landmarks;
+    // face landmarks of edge & core metrics get mapped back onto the full frames
+    bool enabled = false;
+    // margins added around the bounding box of the face landmarks, in multiples of its width (sides) or height (top,
+    // bottom); the bottom margin is generous to keep the chest in view for breathing measurement
+    float side_margin = 1.0f;
+    float top_margin = 0.5f;
+    float bottom_margin = 2.5f;
+    // go back to full frames when no face landmarks came through for this long
+    int track_timeout_ms = 500;
+    // don't bother cropping when the region would cover more than this share of the frame area
+    float maximum_area_ratio = 0.8f;
+};
+// endregion ===========================================================================================================
+// region ============================ Metrics Settings ================================================================
+struct MetricsSettings {
+    // collect hot-path metrics (stage timings, dropped frames, queue depths)
+    bool enabled = false;
+    // where to serve collected metrics as OpenMetrics text over HTTP: "<host>:<port>", "<port>" (on localhost),
+    // or "unix:<socket path>"; empty to not serve them. Containers of the same process exporting at the same address
+    // share one endpoint.
+    std::string export_address;
+    // value of the "container" label on this container's metrics; if empty, a number unique within the process
+    std::string container_label;
+};
+// endregion ===========================================================================================================
 // region ------------------------------- General Settings -------------------------------------------------------------
 struct GeneralSettings {
     video_source::VideoSourceSettings video_source;
     VideoSinkSettings video_sink; // foreground-container only
     bool headless = false; // foreground-container only
-    int interframe_delay_ms = 20; // foreground-container only
+    int interframe_delay_ms = 20; // foreground-container only, superseded by frame_pacing.target_fps if it's set
     bool start_with_recording_on = false; // foreground-container only
     int start_time_offset_ms = 0; // foreground-container only
     // graph internal settings
@@ -129,6 +217,19 @@ struct GeneralSettings {
     bool print_graph_contents = false;
     bool log_transfer_timing_info = false;
     int verbosity_level = 0;
+    // frame buffer management
+    ImageFramePoolSettings image_frame_pool;
+    FramePipelineSettings frame_pipeline; // foreground-container only
+    FramePacingSettings frame_pacing; // foreground-container only
+    MetricsSettings metrics;
+    GraphExecutorSettings graph_executor;
+    RoiCropSettings roi_crop; // foreground-container only
+    // downscale (3-channel) input frames to the graph's input size with an area filter while bringing them into the
+    // graph, so that the graph's own input scaling has nothing left to do (only applies if scale_input is on); also
+    // lets a foreground container's video source decode compressed frames at a reduced scale (see
+    // VideoSourceSettings::decode_target_width_px). The graph's output video then comes at the downscaled size, while
+    // face landmarks of edge & core metrics get mapped back onto the full-size frames.
+    bool pre_scale_input = false;
 };
 // endregion ===========================================================================================================
 template<OperationMode, IntegrationMode>
@@ -0,0 +1,133 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <limits>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+// === local includes (if any) ===
+#include "shared_executor.hpp"
+
+namespace presage::smartspectra::container {
+
+class SharedExecutorPool::Lease : public mediapipe::Executor {
+public:
+    Lease(std::shared_ptr<SharedExecutorPool> pool, std::shared_ptr<LeaseQueue> lease_queue)
+        : pool(std::move(pool)), lease_queue(std::move(lease_queue)) {}
+
+    ~Lease() override {
+        this->pool->RemoveLease(this->lease_queue);
+    }
+
+    void Schedule(std::function<void()> task) override {
+        this->pool->Schedule(this->lease_queue, std::move(task));
+    }
+
+private:
+    std::shared_ptr<SharedExecutorPool> pool;
+    std::shared_ptr<LeaseQueue> lease_queue;
+};
+
+std::shared_ptr<SharedExecutorPool> SharedExecutorPool::GetInstance(int thread_count) {
+    static std::mutex instance_mutex;
+    // not owning: the pool goes away (and its threads stop) once no container uses it anymore
+    static std::weak_ptr<SharedExecutorPool> instance;
+    std::lock_guard<std::mutex> lock(instance_mutex);
+    std::shared_ptr<SharedExecutorPool> pool = instance.lock();
+    if (pool == nullptr) {
+        if (thread_count <= 0) {
+            thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        pool = std::shared_ptr<SharedExecutorPool>(new SharedExecutorPool(thread_count));
+        instance = pool;
+        LOG(INFO) << "Started shared graph executor pool with " << thread_count << " threads.";
+    } else if (thread_count > 0 && thread_count != pool->GetThreadCount()) {
+        LOG(WARNING) << "Shared graph executor pool already running with " << pool->GetThreadCount()
+                     << " threads, ignoring requested thread count of " << thread_count << ".";
+    }
+    return pool;
+}
+
+SharedExecutorPool::SharedExecutorPool(int thread_count) {
+    this->worker_threads.reserve(thread_count);
+    for (int i_thread = 0; i_thread < thread_count; i_thread++) {
+        this->worker_threads.emplace_back(&SharedExecutorPool::RunWorker, this);
+    }
+}
+
+SharedExecutorPool::~SharedExecutorPool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->task_available.notify_all();
+    for (auto& worker_thread: this->worker_threads) {
+        worker_thread.join();
+    }
+}
+
+std::shared_ptr<mediapipe::Executor> SharedExecutorPool::CreateLease(double weight) {
+    auto lease_queue = std::make_shared<LeaseQueue>();
+    lease_queue->weight = weight > 0.0 ? weight : 1.0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        lease_queue->pass = this->virtual_time;
+        this->lease_queues.push_back(lease_queue);
+    }
+    return std::make_shared<Lease>(shared_from_this(), std::move(lease_queue));
+}
+
+void SharedExecutorPool::Schedule(const std::shared_ptr<LeaseQueue>& lease_queue, std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (lease_queue->tasks.empty()) {
+            // a lease that was idle rejoins at the current virtual time, instead of cashing in on its idle time
+            lease_queue->pass = std::max(lease_queue->pass, this->virtual_time);
+        }
+        lease_queue->tasks.push_back(std::move(task));
+    }
+    this->task_available.notify_one();
+}
+
+void SharedExecutorPool::RemoveLease(const std::shared_ptr<LeaseQueue>& lease_queue) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->lease_queues.erase(
+        std::remove(this->lease_queues.begin(), this->lease_queues.end(), lease_queue), this->lease_queues.end()
+    );
+}
+
+void SharedExecutorPool::RunWorker() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            LeaseQueue* next_lease_queue = nullptr;
+            this->task_available.wait(lock, [this, &next_lease_queue] {
+                next_lease_queue = nullptr;
+                double minimum_pass = std::numeric_limits<double>::infinity();
+                for (const auto& lease_queue: this->lease_queues) {
+                    if (!lease_queue->tasks.empty() && lease_queue->pass < minimum_pass) {
+                        minimum_pass = lease_queue->pass;
+                        next_lease_queue = lease_queue.get();
+                    }
+                }
+                return this->stopping || next_lease_queue != nullptr;
+            });
+            if (next_lease_queue == nullptr) {
+                // stopping, with no tasks left
+                return;
+            }
+            task = std::move(next_lease_queue->tasks.front());
+            next_lease_queue->tasks.pop_front();
+            this->virtual_time = next_lease_queue->pass;
+            next_lease_queue->pass += 1.0 / next_lease_queue->weight;
+        }
+        task();
+    }
+}
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,73 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/executor.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::container {
+
+/**
+ * @brief Process-wide worker thread pool that graphs of many containers can share as their default executor.
+ *
+ * Each container obtains its own lease, i.e. a mediapipe::Executor that queues tasks separately and carries a weight.
+ * When the pool is saturated, worker threads pick tasks across leases by stride scheduling, so every lease gets pool
+ * time proportional to its weight; idle leases don't accumulate credit. This keeps the total number of calculator
+ * threads at the pool size, regardless of how many graphs run in the process.
+ */
+class SharedExecutorPool : public std::enable_shared_from_this<SharedExecutorPool> {
+public:
+    /**
+     * Get the process-wide pool, creating it if no pool is alive.
+     * @param thread_count number of worker threads if the pool gets created; 0 uses the hardware concurrency
+     */
+    static std::shared_ptr<SharedExecutorPool> GetInstance(int thread_count = 0);
+
+    ~SharedExecutorPool();
+    SharedExecutorPool(const SharedExecutorPool&) = delete;
+    SharedExecutorPool& operator=(const SharedExecutorPool&) = delete;
+
+    /**
+     * Create an executor that schedules tasks on this pool. The pool stays alive at least as long as the lease.
+     * @param weight relative share of pool time under contention (must be positive)
+     */
+    std::shared_ptr<mediapipe::Executor> CreateLease(double weight = 1.0);
+
+    int GetThreadCount() const { return static_cast<int>(this->worker_threads.size()); }
+
+private:
+    class Lease;
+    struct LeaseQueue {
+        double weight = 1.0;
+        // stride scheduling "pass": virtual time consumed by this lease so far
+        double pass = 0.0;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    explicit SharedExecutorPool(int thread_count);
+
+    void Schedule(const std::shared_ptr<LeaseQueue>& lease_queue, std::function<void()> task);
+    void RemoveLease(const std::shared_ptr<LeaseQueue>& lease_queue);
+    void RunWorker();
+
+    std::mutex mutex;
+    std::condition_variable task_available;
+    std::vector<std::shared_ptr<LeaseQueue>> lease_queues;
+    double virtual_time = 0.0;
+    bool stopping = false;
+    std::vector<std::thread> worker_threads;
+};
+
+} // namespace presage::smartspectra::container
@@ -0,0 +1,367 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+// === third-party includes (if any) ===
+#include <mediapipe/framework/deps/status_macros.h>
+#include <mediapipe/framework/port/logging.h>
+#include <nlohmann/json.hpp>
+#include <opencv2/videoio/registry.hpp>
+#ifdef __linux__
+#include <physiology/modules/filesystem_absl.h>
+#endif
+// === local includes (if any) ===
+#include "camera_capabilities.hpp"
+#include "camera_opencv.hpp"
+
+namespace presage::camera {
+
+#ifdef __linux__
+namespace {
+
+constexpr int kCacheFormatVersion = 1;
+
+bool IsBackendAvailable(int backend) {
+    const std::vector<cv::VideoCaptureAPIs> backends = cv::videoio_registry::getCameraBackends();
+    return std::find(backends.begin(), backends.end(), static_cast<cv::VideoCaptureAPIs>(backend)) != backends.end();
+}
+
+// region ======================================= V4L2 ENUMERATION ====================================================
+std::string FourccToString(uint32_t fourcc) {
+    return {
+        static_cast<char>(fourcc & 0xFF),
+        static_cast<char>((fourcc >> 8) & 0xFF),
+        static_cast<char>((fourcc >> 16) & 0xFF),
+        static_cast<char>((fourcc >> 24) & 0xFF)
+    };
+}
+
+std::vector<FrameInterval> EnumerateFrameIntervals(int file_descriptor, uint32_t pixel_format, const Resolution& size) {
+    std::vector<FrameInterval> frame_intervals;
+    struct v4l2_frmivalenum frame_interval{};
+    frame_interval.pixel_format = pixel_format;
+    frame_interval.width = static_cast<uint32_t>(size.width);
+    frame_interval.height = static_cast<uint32_t>(size.height);
+    for (frame_interval.index = 0;
+         ioctl(file_descriptor, VIDIOC_ENUM_FRAMEINTERVALS, &frame_interval) == 0;
+         frame_interval.index++) {
+        if (frame_interval.type == V4L2_FRMIVAL_TYPE_DISCRETE) {
+            frame_intervals.push_back({frame_interval.discrete.numerator, frame_interval.discrete.denominator});
+        } else {
+            // stepwise or continuous: only the bounds are of interest
+            frame_intervals.push_back({frame_interval.stepwise.min.numerator, frame_interval.stepwise.min.denominator});
+            frame_intervals.push_back({frame_interval.stepwise.max.numerator, frame_interval.stepwise.max.denominator});
+            break;
+        }
+    }
+    return frame_intervals;
+}
+
+std::vector<FrameSizeCapabilities> EnumerateFrameSizes(int file_descriptor, uint32_t pixel_format) {
+    std::vector<FrameSizeCapabilities> frame_sizes;
+    struct v4l2_frmsizeenum frame_size{};
+    frame_size.pixel_format = pixel_format;
+    for (frame_size.index = 0;
+         ioctl(file_descriptor, VIDIOC_ENUM_FRAMESIZES, &frame_size) == 0;
+         frame_size.index++) {
+        if (frame_size.type == V4L2_FRMSIZE_TYPE_DISCRETE) {
+            frame_sizes.push_back({
+                Resolution{static_cast<int>(frame_size.discrete.width), static_cast<int>(frame_size.discrete.height)},
+                {}
+            });
+        } else {
+            // stepwise or continuous: stand in the common resolutions that fit the advertised grid
+            const auto& stepwise = frame_size.stepwise;
+            const int step_width = static_cast<int>(std::max<uint32_t>(stepwise.step_width, 1));
+            const int step_height = static_cast<int>(std::max<uint32_t>(stepwise.step_height, 1));
+            for (const cv::Size& resolution: opencv::kCommonCameraResolutions) {
+                if (resolution.width >= static_cast<int>(stepwise.min_width) &&
+                    resolution.width <= static_cast<int>(stepwise.max_width) &&
+                    resolution.height >= static_cast<int>(stepwise.min_height) &&
+                    resolution.height <= static_cast<int>(stepwise.max_height) &&
+                    (resolution.width - static_cast<int>(stepwise.min_width)) % step_width == 0 &&
+                    (resolution.height - static_cast<int>(stepwise.min_height)) % step_height == 0) {
+                    frame_sizes.push_back({Resolution{resolution.width, resolution.height}, {}});
+                }
+            }
+            break;
+        }
+    }
+    for (auto& frame_size_capabilities: frame_sizes) {
+        frame_size_capabilities.frame_intervals =
+            EnumerateFrameIntervals(file_descriptor, pixel_format, frame_size_capabilities.resolution);
+    }
+    return frame_sizes;
+}
+
+std::vector<PixelFormatCapabilities> EnumeratePixelFormats(int file_descriptor) {
+    std::vector<PixelFormatCapabilities> pixel_formats;
+    struct v4l2_fmtdesc format_description{};
+    format_description.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    for (format_description.index = 0;
+         ioctl(file_descriptor, VIDIOC_ENUM_FMT, &format_description) == 0;
+         format_description.index++) {
+        pixel_formats.push_back({
+            FourccToString(format_description.pixelformat),
+            EnumerateFrameSizes(file_descriptor, format_description.pixelformat)
+        });
+    }
+    return pixel_formats;
+}
+
+std::vector<v4l2::AutoExposureSetting> EnumerateAutoExposureSettings(int file_descriptor) {
+    std::vector<v4l2::AutoExposureSetting> settings;
+    struct v4l2_queryctrl control{};
+    control.id = V4L2_CID_EXPOSURE_AUTO;
+    if (ioctl(file_descriptor, VIDIOC_QUERYCTRL, &control) == 0 && control.type == V4L2_CTRL_TYPE_MENU) {
+        struct v4l2_querymenu menu{};
+        menu.id = control.id;
+        for (menu.index = control.minimum; menu.index <= static_cast<uint32_t>(control.maximum); menu.index++) {
+            if (ioctl(file_descriptor, VIDIOC_QUERYMENU, &menu) == 0) {
+                settings.push_back({static_cast<int>(menu.index), reinterpret_cast<const char*>(menu.name)});
+            }
+        }
+    }
+    return settings;
+}
+// endregion ===========================================================================================================
+// region ============================================ CACHE ===========================================================
+std::filesystem::path GetCacheFilePath(const std::string& card_name, const std::string& bus_info) {
+    std::filesystem::path cache_directory = GetCameraCapabilityCacheDirectory();
+    if (cache_directory.empty()) {
+        return {};
+    }
+    std::string key = card_name + "@" + bus_info;
+    std::replace_if(
+        key.begin(), key.end(),
+        [](char character) { return !std::isalnum(static_cast<unsigned char>(character)) && character != '-'; }, '_'
+    );
+    return cache_directory / (key + ".json");
+}
+
+nlohmann::json CapabilitiesToJson(const CameraCapabilities& capabilities) {
+    nlohmann::json pixel_formats = nlohmann::json::array();
+    for (const auto& pixel_format: capabilities.pixel_formats) {
+        nlohmann::json frame_sizes = nlohmann::json::array();
+        for (const auto& frame_size: pixel_format.frame_sizes) {
+            nlohmann::json frame_intervals = nlohmann::json::array();
+            for (const auto& frame_interval: frame_size.frame_intervals) {
+                frame_intervals.push_back({frame_interval.numerator, frame_interval.denominator});
+            }
+            frame_sizes.push_back({
+                {"width", frame_size.resolution.width},
+                {"height", frame_size.resolution.height},
+                {"frame_intervals", frame_intervals}
+            });
+        }
+        pixel_formats.push_back({{"fourcc", pixel_format.fourcc}, {"frame_sizes", frame_sizes}});
+    }
+    nlohmann::json auto_exposure_settings = nlohmann::json::array();
+    for (const auto& setting: capabilities.auto_exposure_settings) {
+        auto_exposure_settings.push_back({{"value", setting.value}, {"description", setting.description}});
+    }
+    return {
+        {"version", kCacheFormatVersion},
+        {"card_name", capabilities.card_name},
+        {"bus_info", capabilities.bus_info},
+        {"driver_version", capabilities.driver_version},
+        {"backend", capabilities.backend},
+        {"backend_name", capabilities.backend_name},
+        {"pixel_formats", pixel_formats},
+        {"auto_exposure_settings", auto_exposure_settings}
+    };
+}
+
+absl::StatusOr<CameraCapabilities> CapabilitiesFromJson(const nlohmann::json& json) {
+    CameraCapabilities capabilities;
+    try {
+        if (json.at("version").get<int>() != kCacheFormatVersion) {
+            return absl::UnimplementedError("Unsupported camera capability cache version.");
+        }
+        capabilities.card_name = json.at("card_name").get<std::string>();
+        capabilities.bus_info = json.at("bus_info").get<std::string>();
+        capabilities.driver_version = json.at("driver_version").get<uint32_t>();
+        capabilities.backend = json.at("backend").get<int>();
+        capabilities.backend_name = json.at("backend_name").get<std::string>();
+        for (const auto& pixel_format: json.at("pixel_formats")) {
+            PixelFormatCapabilities& pixel_format_capabilities = capabilities.pixel_formats.emplace_back();
+            pixel_format_capabilities.fourcc = pixel_format.at("fourcc").get<std::string>();
+            for (const auto& frame_size: pixel_format.at("frame_sizes")) {
+                FrameSizeCapabilities& frame_size_capabilities = pixel_format_capabilities.frame_sizes.emplace_back();
+                frame_size_capabilities.resolution = {
+                    frame_size.at("width").get<int>(), frame_size.at("height").get<int>()
+                };
+                for (const auto& frame_interval: frame_size.at("frame_intervals")) {
+                    frame_size_capabilities.frame_intervals.push_back({
+                        frame_interval.at(0).get<uint32_t>(), frame_interval.at(1).get<uint32_t>()
+                    });
+                }
+            }
+        }
+        for (const auto& setting: json.at("auto_exposure_settings")) {
+            capabilities.auto_exposure_settings.push_back({
+                setting.at("value").get<int>(), setting.at("description").get<std::string>()
+            });
+        }
+    } catch (const nlohmann::json::exception& exception) {
+        return absl::DataLossError(std::string("Malformed camera capability cache entry: ") + exception.what());
+    }
+    return capabilities;
+}
+
+std::optional<CameraCapabilities> ReadCachedCapabilities(const std::filesystem::path& cache_file_path) {
+    std::ifstream cache_file(cache_file_path);
+    if (!cache_file) {
+        return std::nullopt;
+    }
+    std::stringstream contents;
+    contents << cache_file.rdbuf();
+    nlohmann::json json = nlohmann::json::parse(contents.str(), nullptr, /*allow_exceptions=*/false);
+    if (json.is_discarded()) {
+        LOG(WARNING) << "Ignoring unreadable camera capability cache entry " << cache_file_path.string() << ".";
+        return std::nullopt;
+    }
+    absl::StatusOr<CameraCapabilities> capabilities = CapabilitiesFromJson(json);
+    if (!capabilities.ok()) {
+        LOG(WARNING) << "Ignoring camera capability cache entry " << cache_file_path.string() << ": "
+                     << capabilities.status().message();
+        return std::nullopt;
+    }
+    return *std::move(capabilities);
+}
+
+void WriteCachedCapabilities(const std::filesystem::path& cache_file_path, const CameraCapabilities& capabilities) {
+    std::error_code error_code;
+    std::filesystem::create_directories(cache_file_path.parent_path(), error_code);
+    // write to a temporary file first, so that concurrent startups never read a partially written entry
+    std::filesystem::path temporary_path = cache_file_path;
+    temporary_path += ".tmp" + std::to_string(static_cast<long>(getpid()));
+    {
+        std::ofstream temporary_file(temporary_path, std::ios::trunc);
+        temporary_file << CapabilitiesToJson(capabilities).dump(2);
+        temporary_file.close();
+        if (!temporary_file) {
+            LOG(WARNING) << "Could not write camera capability cache entry " << temporary_path.string() << ".";
+            std::filesystem::remove(temporary_path, error_code);
+            return;
+        }
+    }
+    std::filesystem::rename(temporary_path, cache_file_path, error_code);
+    if (error_code) {
+        LOG(WARNING) << "Could not write camera capability cache entry " << cache_file_path.string() << ": "
+                     << error_code.message();
+        std::filesystem::remove(temporary_path, error_code);
+    }
+}
+// endregion ===========================================================================================================
+
+} // anonymous namespace
+#endif
+
+absl::StatusOr<CameraCapabilities> GetCameraCapabilities(int camera_device_index, bool refresh_cache) {
+    CameraCapabilities capabilities;
+#ifdef __linux__
+    std::string device_path = "/dev/video" + std::to_string(camera_device_index);
+    MP_ASSIGN_OR_RETURN(int file_descriptor, presage::filesystem::abseil::SafeOpen(device_path.c_str(), O_RDWR));
+    if (file_descriptor == -1) {
+        return absl::NotFoundError("Failed to open video device at " + device_path);
+    }
+    struct v4l2_capability video_capture{};
+    if (ioctl(file_descriptor, VIDIOC_QUERYCAP, &video_capture) == -1) {
+        close(file_descriptor);
+        return absl::UnavailableError("Failed to query video device capabilities.");
+    }
+    capabilities.card_name = reinterpret_cast<const char*>(video_capture.card);
+    capabilities.bus_info = reinterpret_cast<const char*>(video_capture.bus_info);
+    capabilities.driver_version = video_capture.version;
+
+    const std::filesystem::path cache_file_path = GetCacheFilePath(capabilities.card_name, capabilities.bus_info);
+    if (!refresh_cache && !cache_file_path.empty()) {
+        std::optional<CameraCapabilities> cached_capabilities = ReadCachedCapabilities(cache_file_path);
+        // the key is sanitized, so double-check the identity of the camera
+        if (cached_capabilities.has_value() &&
+            cached_capabilities->card_name == capabilities.card_name &&
+            cached_capabilities->bus_info == capabilities.bus_info &&
+            cached_capabilities->driver_version == capabilities.driver_version &&
+            IsBackendAvailable(cached_capabilities->backend)) {
+            close(file_descriptor);
+            cached_capabilities->from_cache = true;
+            return *std::move(cached_capabilities);
+        }
+    }
+
+    capabilities.pixel_formats = EnumeratePixelFormats(file_descriptor);
+    capabilities.auto_exposure_settings = EnumerateAutoExposureSettings(file_descriptor);
+    close(file_descriptor);
+#endif
+    capabilities.backend = opencv::DeterminePreferredBackendForCamera(camera_device_index);
+    capabilities.backend_name = opencv::GetBackendName(capabilities.backend);
+#ifdef __linux__
+    // a camera that doesn't open (e.g. because it is busy) is not worth remembering
+    if (!cache_file_path.empty() && capabilities.backend != -1) {
+        WriteCachedCapabilities(cache_file_path, capabilities);
+    }
+#endif
+    return capabilities;
+}
+
+std::filesystem::path GetCameraCapabilityCacheDirectory() {
+    std::filesystem::path cache_home;
+    const char* xdg_cache_home = std::getenv("XDG_CACHE_HOME");
+    const char* home = std::getenv("HOME");
+    // per the XDG base directory specification, relative paths are to be ignored
+    if (xdg_cache_home != nullptr && std::filesystem::path(xdg_cache_home).is_absolute()) {
+        cache_home = xdg_cache_home;
+    } else if (home != nullptr && home[0] != '\0') {
+        cache_home = std::filesystem::path(home) / ".cache";
+    } else {
+        return {};
+    }
+    return cache_home / "smartspectra" / "camera_capabilities";
+}
+
+std::optional<Resolution> SelectMaximumResolutionFromRange(
+    const CameraCapabilities& capabilities,
+    CaptureCodec codec,
+    CameraResolutionRange range
+) {
+    const std::string codec_fourcc = AbslUnparseFlag(codec);
+    const bool codec_advertised = std::any_of(
+        capabilities.pixel_formats.begin(), capabilities.pixel_formats.end(),
+        [&codec_fourcc](const PixelFormatCapabilities& pixel_format) { return pixel_format.fourcc == codec_fourcc; }
+    );
+    const auto& range_bounds = opencv::kCommonCameraResolutionRanges.at(range);
+    std::optional<Resolution> best_resolution;
+    int64_t best_area = 0;
+    for (const auto& pixel_format: capabilities.pixel_formats) {
+        if (codec_advertised && pixel_format.fourcc != codec_fourcc) continue;
+        for (const auto& frame_size: pixel_format.frame_sizes) {
+            for (int i_resolution = range_bounds.first; i_resolution <= range_bounds.second; i_resolution++) {
+                const cv::Size& resolution = opencv::kCommonCameraResolutions[i_resolution];
+                const int64_t area = static_cast<int64_t>(resolution.width) * resolution.height;
+                if (frame_size.resolution.width == resolution.width &&
+                    frame_size.resolution.height == resolution.height && area > best_area) {
+                    best_area = area;
+                    best_resolution = frame_size.resolution;
+                }
+            }
+        }
+    }
+    return best_resolution;
+}
+
+} // namespace presage::camera
@@ -0,0 +1,86 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+// === local includes (if any) ===
+#include "camera.hpp"
+#include "camera_v4l2.hpp"
+
+namespace presage::camera {
+
+struct FrameInterval {
+    uint32_t numerator;
+    uint32_t denominator;
+};
+
+struct FrameSizeCapabilities {
+    Resolution resolution;
+    std::vector<FrameInterval> frame_intervals;
+};
+
+struct PixelFormatCapabilities {
+    // V4L2 four-character code, e.g. "MJPG"
+    std::string fourcc;
+    std::vector<FrameSizeCapabilities> frame_sizes;
+};
+
+/**
+ * @brief Everything camera startup needs to know about a camera, gathered by a single probe.
+ */
+struct CameraCapabilities {
+    std::string card_name;
+    std::string bus_info;
+    uint32_t driver_version = 0;
+    // preferred OpenCV capture backend, -1 if the camera doesn't open with any
+    int backend = -1;
+    std::string backend_name = "Undefined";
+    std::vector<PixelFormatCapabilities> pixel_formats;
+    std::vector<v4l2::AutoExposureSetting> auto_exposure_settings;
+    // true if read from the on-disk cache rather than probed just now
+    bool from_cache = false;
+};
+
+/**
+ * Probe the capabilities of a camera: preferred OpenCV backend and, where V4L2 is available, the pixel formats, frame
+ * sizes, frame intervals and auto exposure menu it advertises. Frame sizes come from driver enumeration rather than
+ * from trying out resolutions, and each backend is tried (by opening the camera) only once.
+ *
+ * On Linux, results are cached on disk (see GetCameraCapabilityCacheDirectory), keyed by the card name and bus info the
+ * driver reports, so that later startups with the same camera in the same port skip the probe altogether. A cached
+ * entry is discarded if the driver version changes or its backend is no longer available.
+ *
+ * @param camera_device_index index of the camera device, i.e. N in /dev/videoN
+ * @param refresh_cache probe the camera even if cached capabilities exist (and update the cache)
+ */
+absl::StatusOr<CameraCapabilities> GetCameraCapabilities(int camera_device_index, bool refresh_cache = false);
+
+/**
+ * Directory where camera capabilities get cached: $XDG_CACHE_HOME/smartspectra/camera_capabilities, or
+ * ~/.cache/smartspectra/camera_capabilities if XDG_CACHE_HOME is unset.
+ * @return the directory, or an empty path if neither location can be determined (then, nothing gets cached)
+ */
+std::filesystem::path GetCameraCapabilityCacheDirectory();
+
+/**
+ * Pick the largest (by area) of the common camera resolutions in the given range that the camera advertises for the
+ * given codec, or for any pixel format if the codec isn't advertised at all (the capture backend may then convert).
+ * @return the resolution, or std::nullopt if there is none (also when no frame sizes could be enumerated)
+ */
+std::optional<Resolution> SelectMaximumResolutionFromRange(
+    const CameraCapabilities& capabilities,
+    CaptureCodec codec,
+    CameraResolutionRange range
+);
+
+} // namespace presage::camera
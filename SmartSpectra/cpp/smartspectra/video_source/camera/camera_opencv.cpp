@@ -61,7 +61,10 @@ int DeterminePreferredBackendForCamera(int camera_device_index) {
 }
 
 UncertainBool CheckCameraInterfaceSupportsTimestamp(int camera_device_index) {
-    int backend = DeterminePreferredBackendForCamera(camera_device_index);
+    return CheckBackendSupportsTimestamp(DeterminePreferredBackendForCamera(camera_device_index));
+}
+
+UncertainBool CheckBackendSupportsTimestamp(int backend) {
     static std::set<cv::VideoCaptureAPIs> backends_known_to_support_timestamp = {
         //TODO: list is probably incomplete. Test with each new backend encountered and populate this list.
         cv::CAP_V4L2
@@ -87,7 +90,10 @@ UncertainBool CheckCameraInterfaceSupportsTimestamp(int camera_device_index) {
 }
 
 std::string DeterminePreferredBackendNameForCamera(int camera_device_index) {
-    int backend = DeterminePreferredBackendForCamera(camera_device_index);
+    return GetBackendName(DeterminePreferredBackendForCamera(camera_device_index));
+}
+
+std::string GetBackendName(int backend) {
     if (backend == -1) {
         return "Undefined";
     }
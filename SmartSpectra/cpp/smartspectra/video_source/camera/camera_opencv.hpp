@@ -24,6 +24,11 @@ std::string DeterminePreferredBackendNameForCamera(int camera_device_index);
 
 UncertainBool CheckCameraInterfaceSupportsTimestamp(int camera_device_index);
 
+// variants of the above for an already-determined backend, which don't need to open the camera
+UncertainBool CheckBackendSupportsTimestamp(int backend);
+
+std::string GetBackendName(int backend);
+
 // endregion ===========================================================================================================
 // region ========================================= RESOLUTION =========================================================
 
@@ -4,8 +4,8 @@
 //
 
 // === standard library includes (if any) ===
-#include <exception>
-#include <fstream>
+#include <algorithm>
+#include <optional>
 // === third-party includes (if any) ===
 #include <mediapipe/framework/port/ret_check.h>
 #include <mediapipe/framework/port/logging.h>
@@ -16,8 +16,10 @@
 namespace pcam_v4l2 = presage::camera::v4l2;
 #endif
 // @formatter:on
+#include "camera_capabilities.hpp"
 #include "camera_opencv.hpp"
 #include "capture_video_source.hpp"
+#include "frame_timestamp_file.hpp"
 
 
 namespace presage::smartspectra::video_source::capture {
@@ -30,57 +32,230 @@ bool CaptureVideoFileSource::SupportsExactFrameTimestamp() const {
 }
 
 int64_t CaptureVideoFileSource::GetFrameTimestamp() const {
-    return static_cast<int64_t>(this->capture.get(cv::CAP_PROP_POS_MSEC) * 1000.0); // milliseconds -> microseconds;
+    return this->frame_timestamp_us;
+}
+
+CaptureVideoFileSource::~CaptureVideoFileSource() {
+    this->StopDecoder();
 }
 
 absl::Status CaptureVideoFileSource::Initialize(const presage::smartspectra::video_source::VideoSourceSettings& settings) {
+    this->StopDecoder();
     MP_RETURN_IF_ERROR(VideoSource::Initialize(settings));
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+    std::vector<int> open_parameters;
+    if (settings.decode_thread_count > 0) {
+        open_parameters = {cv::CAP_PROP_N_THREADS, settings.decode_thread_count};
+    }
+    capture.open(settings.input_video_path, cv::CAP_ANY, open_parameters);
+#else
     capture.open(settings.input_video_path);
+#endif
     RET_CHECK(capture.isOpened());
+    // cached, since the capture is owned by the decode thread from here on
+    this->width = static_cast<int>(this->capture.get(cv::CAP_PROP_FRAME_WIDTH));
+    this->height = static_cast<int>(this->capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+    this->frame_timestamp_us = 0;
+    this->frame_index = -1;
+    this->next_frame_index = 0;
+
+    this->decoded_frames.clear();
+    this->prefetch_count = static_cast<size_t>(std::max(0, settings.video_file_prefetch_count));
+    this->StartDecoder();
+    return absl::OkStatus();
+}
+
+absl::Status CaptureVideoFileSource::Seek(int64_t timestamp) {
+    return this->SeekToFrame(
+        cv::CAP_PROP_POS_MSEC, static_cast<double>(timestamp) / 1000.0, // microseconds -> milliseconds
+        [timestamp](const DecodedFrame& decoded_frame) { return decoded_frame.timestamp_us >= timestamp; }
+    );
+}
+
+absl::Status CaptureVideoFileSource::SeekToFrame(
+    int capture_property,
+    double capture_position,
+    const std::function<bool(const DecodedFrame&)>& is_reached
+) {
+    RET_CHECK(this->capture.isOpened());
+    this->StopDecoder();
+    DecodedFrame current_frame;
+    current_frame.timestamp_us = this->frame_timestamp_us;
+    current_frame.frame_index = this->frame_index;
+    bool sought_frame_decoded = false;
+    if (!is_reached(current_frame)) {
+        // seeking forward: the sought frame may be among the frames decoded ahead already
+        while (!this->decoded_frames.empty() && !this->decoded_frames.front().frame.empty() &&
+               !is_reached(this->decoded_frames.front())) {
+            this->decoded_frames.pop_front();
+        }
+        sought_frame_decoded = !this->decoded_frames.empty() && !this->decoded_frames.front().frame.empty();
+    }
+    if (!sought_frame_decoded) {
+        if (this->capture.set(capture_property, capture_position)) {
+            this->decoded_frames.clear();
+            this->next_frame_index = static_cast<int64_t>(this->capture.get(cv::CAP_PROP_POS_FRAMES));
+        } else if (is_reached(current_frame)) {
+            this->StartDecoder();
+            if (this->frame_index >= 0) {
+                // frames decoded ahead are left as they were
+                return absl::UnimplementedError(
+                    "The video capture backend can't seek, so it can't go back to an earlier frame."
+                );
+            }
+            // no frame produced yet: the sought frame is the first one, whether decoded ahead already or not
+            return absl::OkStatus();
+        } else if (!this->decoded_frames.empty()) {
+            // all that's left of the frames decoded ahead is the end of file
+            this->StartDecoder();
+            return absl::OutOfRangeError("The sought frame is past the end of the video file.");
+        } else {
+            LOG(WARNING) << "The video capture backend can't seek, decoding forward to the sought frame instead.";
+        }
+        // the backend may land on a keyframe before the sought frame
+        DecodedFrame decoded_frame;
+        do {
+            this->DecodeFrame(decoded_frame);
+        } while (!decoded_frame.frame.empty() && !is_reached(decoded_frame));
+        const bool end_of_file = decoded_frame.frame.empty();
+        this->decoded_frames.push_back(std::move(decoded_frame));
+        if (end_of_file) {
+            return absl::OutOfRangeError("The sought frame is past the end of the video file.");
+        }
+    }
+    this->StartDecoder();
     return absl::OkStatus();
 }
 
 int CaptureVideoFileSource::GetWidth() {
-    return static_cast<int>(this->capture.get(cv::CAP_PROP_FRAME_WIDTH));
+    return this->width;
 }
 
 int CaptureVideoFileSource::GetHeight() {
-    return static_cast<int>(this->capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+    return this->height;
+}
+
+int64_t CaptureVideoFileSource::GetFrameIndex() const {
+    return this->frame_index;
 }
 
 void CaptureVideoFileSource::ProducePreTransformFrame(cv::Mat& frame) {
-    this->capture >> frame;
+    DecodedFrame decoded_frame;
+    bool frame_dequeued = false;
+    {
+        std::unique_lock<std::mutex> lock(this->decoded_frames_mutex);
+        if (this->decode_thread.joinable()) {
+            this->frame_decoded.wait(lock, [this] { return !this->decoded_frames.empty(); });
+        }
+        // without a decode thread, the queue only ever holds the frame found by a seek
+        if (!this->decoded_frames.empty()) {
+            if (this->decoded_frames.front().frame.empty()) {
+                // end of file: leave the empty frame in the queue for subsequent calls
+                frame.release();
+                return;
+            }
+            decoded_frame = std::move(this->decoded_frames.front());
+            this->decoded_frames.pop_front();
+            frame_dequeued = true;
+        }
+    }
+    if (frame_dequeued) {
+        this->frame_consumed.notify_one();
+    } else {
+        this->DecodeFrame(decoded_frame);
+    }
+    frame = std::move(decoded_frame.frame);
+    if (!frame.empty()) {
+        this->frame_timestamp_us = decoded_frame.timestamp_us;
+        this->frame_index = decoded_frame.frame_index;
+    }
 }
 
-std::vector<int64_t> CaptureVideoAndTimeStampFile::ReadTimestampsFromFile(const std::string& filename) {
-    std::vector<int64_t> timestamps;
-    std::ifstream file(filename);
-    std::string line;
-    while (std::getline(file, line)) {
-        try {
-            int64_t timestamp_ms = std::stoll(line);  // Convert string to int64_t
-            int64_t timestamp_us = timestamp_ms * 1000; // want to be in microseconds
-            timestamps.push_back(timestamp_us);
-        } catch (const std::exception& e) {
-            std::cerr << "Error converting line to timestamp: " << e.what() << std::endl;
+void CaptureVideoFileSource::DecodeFrame(DecodedFrame& decoded_frame) {
+    this->capture >> decoded_frame.frame;
+    decoded_frame.timestamp_us =
+        static_cast<int64_t>(this->capture.get(cv::CAP_PROP_POS_MSEC) * 1000.0); // milliseconds -> microseconds
+    decoded_frame.frame_index = this->next_frame_index;
+    if (!decoded_frame.frame.empty()) {
+        this->next_frame_index++;
+    }
+}
+
+void CaptureVideoFileSource::RunDecoder() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(this->decoded_frames_mutex);
+            this->frame_consumed.wait(lock, [this] {
+                return this->stopping || this->decoded_frames.size() < this->prefetch_count;
+            });
+            if (this->stopping) {
+                return;
+            }
         }
+        DecodedFrame decoded_frame;
+        this->DecodeFrame(decoded_frame);
+        const bool end_of_file = decoded_frame.frame.empty();
+        {
+            std::lock_guard<std::mutex> lock(this->decoded_frames_mutex);
+            this->decoded_frames.push_back(std::move(decoded_frame));
+        }
+        this->frame_decoded.notify_one();
+        if (end_of_file) {
+            return;
+        }
+    }
+}
+
+void CaptureVideoFileSource::StartDecoder() {
+    if (this->prefetch_count == 0 ||
+        (!this->decoded_frames.empty() && this->decoded_frames.back().frame.empty())) {
+        // nothing (left) to decode ahead
+        return;
+    }
+    this->stopping = false;
+    this->decode_thread = std::thread(&CaptureVideoFileSource::RunDecoder, this);
+}
+
+void CaptureVideoFileSource::StopDecoder() {
+    if (!this->decode_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->decoded_frames_mutex);
+        this->stopping = true;
     }
-    return timestamps;
+    this->frame_consumed.notify_all();
+    this->decode_thread.join();
 }
 
 absl::Status CaptureVideoAndTimeStampFile::Initialize(const VideoSourceSettings& settings) {
-    timestamps = ReadTimestampsFromFile(settings.input_video_time_path);
+    MP_ASSIGN_OR_RETURN(this->timestamps, ReadFrameTimestampFile(settings.input_video_time_path));
+    if (this->timestamps.empty()) {
+        return absl::InvalidArgumentError("No frame timestamps found in " + settings.input_video_time_path + ".");
+    }
     return CaptureVideoFileSource::Initialize(settings);
 }
 
 int64_t CaptureVideoAndTimeStampFile::GetFrameTimestamp() const {
-    return timestamps[std::max(0, static_cast <int> (this->capture.get(cv::CAP_PROP_POS_FRAMES)) - 1)];
+    // frames beyond the end of the timestamp file keep the last timestamp
+    return this->timestamps[std::clamp<int64_t>(
+        this->GetFrameIndex(), 0, static_cast<int64_t>(this->timestamps.size()) - 1
+    )];
 }
 
 bool CaptureVideoAndTimeStampFile::SupportsExactFrameTimestamp() const {
     return true;
 }
 
+absl::Status CaptureVideoAndTimeStampFile::Seek(int64_t timestamp) {
+    const int64_t frame_index =
+        std::lower_bound(this->timestamps.begin(), this->timestamps.end(), timestamp) - this->timestamps.begin();
+    return this->SeekToFrame(
+        cv::CAP_PROP_POS_FRAMES, static_cast<double>(frame_index),
+        [frame_index](const DecodedFrame& decoded_frame) { return decoded_frame.frame_index >= frame_index; }
+    );
+}
+
 absl::Status CaptureCameraSource::Initialize(const presage::smartspectra::video_source::VideoSourceSettings& settings) {
     MP_RETURN_IF_ERROR(VideoSource::Initialize(settings));
     if (settings.input_transform_mode == InputTransformMode::MirrorHorizontal) {
@@ -91,20 +266,23 @@ absl::Status CaptureCameraSource::Initialize(const presage::smartspectra::video_
     if (settings.input_transform_mode != InputTransformMode::None) {
         LOG(INFO) << "Input transform mode: " << AbslUnparseFlag(settings.input_transform_mode);
     }
-#ifdef __linux__
-    MP_ASSIGN_OR_RETURN(std::string camera_name, pcam_v4l2::GetCameraName(settings.device_index));
-    LOG(INFO) << "Camera name: " << camera_name;
+    // a single (cached) probe provides the backend, auto exposure settings and frame sizes of the camera
     MP_ASSIGN_OR_RETURN(
-        std::vector<pcam_v4l2::AutoExposureSetting> auto_exposure_settings,
-        pcam_v4l2::GetAutoExposureSettings(settings.device_index)
+        pcam::CameraCapabilities camera_capabilities,
+        pcam::GetCameraCapabilities(settings.device_index)
     );
+    if (camera_capabilities.from_cache) {
+        LOG(INFO) << "Using cached camera capabilities from " << pcam::GetCameraCapabilityCacheDirectory().string();
+    }
+#ifdef __linux__
+    LOG(INFO) << "Camera name: " << camera_capabilities.card_name;
     LOG(INFO) << "Auto exposure settings detected by the camera: ";
-    for (const auto& setting: auto_exposure_settings) {
+    for (const auto& setting: camera_capabilities.auto_exposure_settings) {
         LOG(INFO) << "   " << pcam_v4l2::ToString(setting);
     }
     MP_ASSIGN_OR_RETURN(
         auto_exposure_configuration,
-        pcam_v4l2::InferAutoExposureConfigurationFromSettings(auto_exposure_settings)
+        pcam_v4l2::InferAutoExposureConfigurationFromSettings(camera_capabilities.auto_exposure_settings)
     );
 #else
     // Assume C920 values by default...
@@ -113,10 +291,8 @@ absl::Status CaptureCameraSource::Initialize(const presage::smartspectra::video_
         pcam::C920E_AUTO_EXPOSURE_OFF_SETTING
     };
 #endif
-    int backend_to_use = pcam_cv::DeterminePreferredBackendForCamera(settings.device_index);
-    std::string camera_backend_name = pcam_cv::DeterminePreferredBackendNameForCamera(
-        settings.device_index
-    );
+    int backend_to_use = camera_capabilities.backend;
+    const std::string& camera_backend_name = camera_capabilities.backend_name;
     if (backend_to_use == cv::VideoCaptureAPIs::CAP_V4L2) {
         this->UseUptimeTimestampConversion();
     }
@@ -124,9 +300,7 @@ absl::Status CaptureCameraSource::Initialize(const presage::smartspectra::video_
     // region ================================== CHECK PER-FRAME TIMESTAMP SUPPORT =================================
     LOG(INFO) << "Check if frame timestamps are supported by the camera capture interface...";
 
-    pcam::UncertainBool timestamp_supported = pcam_cv::CheckCameraInterfaceSupportsTimestamp(
-        settings.device_index
-    );
+    pcam::UncertainBool timestamp_supported = pcam_cv::CheckBackendSupportsTimestamp(backend_to_use);
     switch (timestamp_supported) {
         case pcam::UncertainBool::False:
             LOG(INFO) << "Frame timestamp are not supported by the camera capture interface. Using wall time instead.";
@@ -173,16 +347,23 @@ absl::Status CaptureCameraSource::Initialize(const presage::smartspectra::video_
                 "No camera resolution range specified with `range` resolution selection mode. Exiting."
             );
         }
-        LOG(INFO) << "Try out different camera resolutions...";
         bool suitable_resolution_found = false;
-        // we check first the mid-range, then the low-range
-        // we avoid higher resolution ranges because those could result in low FPS due to USB bandwidth
-        std::tie(suitable_resolution_found, camera_resolution) =
-            pcam_cv::GetMaximumCameraResolutionFromRange(
-                settings.device_index,
-                settings.resolution_range,
-                backend_to_use
-            );
+        std::optional<pcam::Resolution> enumerated_resolution = pcam::SelectMaximumResolutionFromRange(
+            camera_capabilities, settings.codec, settings.resolution_range
+        );
+        if (enumerated_resolution.has_value()) {
+            suitable_resolution_found = true;
+            camera_resolution = {enumerated_resolution->width, enumerated_resolution->height};
+        } else if (camera_capabilities.pixel_formats.empty()) {
+            // frame sizes could not be enumerated (e.g. no V4L2): fall back to trying resolutions out
+            LOG(INFO) << "Try out different camera resolutions...";
+            std::tie(suitable_resolution_found, camera_resolution) =
+                pcam_cv::GetMaximumCameraResolutionFromRange(
+                    settings.device_index,
+                    settings.resolution_range,
+                    backend_to_use
+                );
+        }
         if (!suitable_resolution_found) {
             return absl::FailedPreconditionError("Failed to find a suitable camera resolution.");
         }
@@ -5,6 +5,11 @@
 
 #pragma once
 // === standard library includes (if any) ===
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 // === third-party includes (if any) ===
 #include <mediapipe/framework/port/opencv_video_inc.h>
 #include <absl/status/status.h>
@@ -15,16 +20,71 @@
 
 namespace presage::smartspectra::video_source::capture {
 
+/**
+ * @brief Video file source.
+ *
+ * Unless VideoSourceSettings::video_file_prefetch_count is 0, frames are decoded on a separate thread, up to that many
+ * frames ahead of the one being consumed. Frame timestamps and positions are recorded as each frame gets decoded.
+ * Seeking repositions the capture at the closest preceding keyframe (as done by the OpenCV backend) and decodes
+ * forward from there; seeks that land among the frames already decoded ahead just drop the ones in between. With a
+ * backend that can't reposition the capture, only forward seeks are possible, decoding (and dropping) every frame up
+ * to the sought one.
+ */
 class CaptureVideoFileSource : public VideoSource{
 public:
+    ~CaptureVideoFileSource() override;
     absl::Status Initialize(const VideoSourceSettings& settings) override;
     bool SupportsExactFrameTimestamp() const override;
     int64_t GetFrameTimestamp() const override;
+    absl::Status Seek(int64_t timestamp) override;
     int GetWidth() override;
     int GetHeight() override;
 protected:
+    struct DecodedFrame {
+        cv::Mat frame;
+        int64_t timestamp_us = 0;
+        int64_t frame_index = -1;
+    };
+
     void ProducePreTransformFrame(cv::Mat& frame) override;
+    /** Position of the current frame in the video file, counting from 0. */
+    int64_t GetFrameIndex() const;
+    /**
+     * Make the first decoded frame that is_reached accepts the next one produced.
+     * @param capture_property position property to reposition the capture with when the frame isn't decoded yet:
+     * cv::CAP_PROP_POS_MSEC or cv::CAP_PROP_POS_FRAMES
+     * @param capture_position value of the position property
+     * @param is_reached true for (non-empty) frames at or past the sought position
+     * @return UnimplementedError for backward seeks when the capture backend can't seek (leaving the position as it
+     * was), OutOfRangeError when the video file ends before the sought frame (leaving the source at the end of file)
+     */
+    absl::Status SeekToFrame(
+        int capture_property,
+        double capture_position,
+        const std::function<bool(const DecodedFrame&)>& is_reached
+    );
     cv::VideoCapture capture;
+private:
+    void DecodeFrame(DecodedFrame& decoded_frame);
+    void RunDecoder();
+    void StartDecoder();
+    void StopDecoder();
+
+    int width = -1;
+    int height = -1;
+    int64_t frame_timestamp_us = 0;
+    int64_t frame_index = -1;
+    // position of the next frame to decode, counted locally instead of queried from the capture
+    int64_t next_frame_index = 0;
+
+    // decode-ahead queue, filled by decode_thread
+    size_t prefetch_count = 0;
+    std::thread decode_thread;
+    std::mutex decoded_frames_mutex;
+    std::condition_variable frame_decoded;
+    std::condition_variable frame_consumed;
+    std::deque<DecodedFrame> decoded_frames;
+    bool stopping = false;
 };
 
 class CaptureVideoAndTimeStampFile : public CaptureVideoFileSource {
@@ -32,8 +92,9 @@ public:
     absl::Status Initialize(const VideoSourceSettings& settings) override;
     int64_t GetFrameTimestamp() const override;
     bool SupportsExactFrameTimestamp() const override;
+    /** Seek by frame position, to the first frame whose timestamp in the timestamp file is at or past the given one. */
+    absl::Status Seek(int64_t timestamp) override;
 private:
-    std::vector<int64_t> ReadTimestampsFromFile(const std::string& filename);
     std::vector<int64_t> timestamps;
 };
 
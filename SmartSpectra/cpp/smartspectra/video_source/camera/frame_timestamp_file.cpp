@@ -0,0 +1,210 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <string>
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <iterator>
+#endif
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+// === local includes (if any) ===
+#include "frame_timestamp_file.hpp"
+
+namespace presage::smartspectra::video_source::capture {
+
+namespace {
+
+// non-text first byte & line ending bytes (as in PNG signatures), so that the sidecar is never taken for text
+constexpr std::string_view kSidecarMagic("\x89" "FTS\r\n\x1a\n", 8);
+constexpr char kSidecarVersion = 1;
+
+uint64_t ZigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t ZigZagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void AppendVarint(std::string& output, uint64_t value) {
+    while (value >= 0x80) {
+        output.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    output.push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(std::string_view& input, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && !input.empty(); shift += 7) {
+        const auto byte = static_cast<uint8_t>(input.front());
+        input.remove_prefix(1);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+absl::StatusOr<std::vector<int64_t>> ParseFrameTimestampContents(std::string_view contents) {
+    if (IsFrameTimestampSidecar(contents)) {
+        return DecodeFrameTimestampSidecar(contents);
+    }
+    return ParseFrameTimestampText(contents);
+}
+
+} // anonymous namespace
+
+absl::StatusOr<std::vector<int64_t>> ReadFrameTimestampFile(const std::filesystem::path& path) {
+#ifdef __linux__
+    const int file_descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file_descriptor == -1) {
+        return absl::NotFoundError(
+            "Could not open frame timestamp file " + path.string() + ": " + std::strerror(errno)
+        );
+    }
+    struct stat file_status{};
+    if (fstat(file_descriptor, &file_status) != 0) {
+        const int error_number = errno;
+        close(file_descriptor);
+        return absl::InternalError(
+            "Could not determine size of frame timestamp file " + path.string() + ": " + std::strerror(error_number)
+        );
+    }
+    const auto size = static_cast<size_t>(file_status.st_size);
+    if (size == 0) {
+        close(file_descriptor);
+        return std::vector<int64_t>();
+    }
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    // close() may overwrite errno
+    const int error_number = errno;
+    close(file_descriptor);
+    if (mapping == MAP_FAILED) {
+        return absl::InternalError(
+            "Could not map frame timestamp file " + path.string() + ": " + std::strerror(error_number)
+        );
+    }
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    auto timestamps = ParseFrameTimestampContents(std::string_view(static_cast<const char*>(mapping), size));
+    munmap(mapping, size);
+    return timestamps;
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return absl::NotFoundError("Could not open frame timestamp file " + path.string() + ".");
+    }
+    const std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return ParseFrameTimestampContents(contents);
+#endif
+}
+
+std::vector<int64_t> ParseFrameTimestampText(std::string_view text) {
+    std::vector<int64_t> timestamps;
+    timestamps.reserve(std::count(text.begin(), text.end(), '\n') + 1);
+    size_t line_number = 0;
+    size_t skipped_line_count = 0;
+    size_t first_skipped_line_number = 0;
+    while (!text.empty()) {
+        const size_t line_end = text.find('\n');
+        std::string_view line = text.substr(0, line_end);
+        text.remove_prefix(line_end == std::string_view::npos ? text.size() : line_end + 1);
+        line_number++;
+
+        // '\r' of CRLF line endings counts as whitespace
+        const size_t line_start = line.find_first_not_of(" \t\r\f\v");
+        if (line_start == std::string_view::npos) {
+            continue;
+        }
+        line.remove_prefix(line_start);
+        if (line.front() == '+') {
+            line.remove_prefix(1);
+        }
+        int64_t timestamp_ms;
+        if (std::from_chars(line.data(), line.data() + line.size(), timestamp_ms).ec != std::errc()) {
+            if (skipped_line_count == 0) {
+                first_skipped_line_number = line_number;
+            }
+            skipped_line_count++;
+            continue;
+        }
+        timestamps.push_back(timestamp_ms * 1000); // milliseconds -> microseconds
+    }
+    if (skipped_line_count > 0) {
+        LOG(WARNING) << "Skipped " << skipped_line_count << " frame timestamp line(s) that don't start with an "
+                     << "integer, starting with line " << first_skipped_line_number << ".";
+    }
+    return timestamps;
+}
+
+absl::Status WriteFrameTimestampSidecar(const std::filesystem::path& path, const std::vector<int64_t>& timestamps) {
+    std::string contents(kSidecarMagic);
+    contents.push_back(kSidecarVersion);
+    AppendVarint(contents, timestamps.size());
+    uint64_t previous_timestamp = 0;
+    for (int64_t timestamp: timestamps) {
+        // unsigned arithmetic wraps around instead of overflowing
+        const auto difference = static_cast<int64_t>(static_cast<uint64_t>(timestamp) - previous_timestamp);
+        AppendVarint(contents, ZigZagEncode(difference));
+        previous_timestamp = static_cast<uint64_t>(timestamp);
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    file.close();
+    if (!file) {
+        return absl::InternalError("Could not write frame timestamp sidecar " + path.string() + ".");
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<int64_t>> DecodeFrameTimestampSidecar(std::string_view contents) {
+    if (!IsFrameTimestampSidecar(contents)) {
+        return absl::InvalidArgumentError("Not a frame timestamp sidecar.");
+    }
+    contents.remove_prefix(kSidecarMagic.size());
+    const char version = contents.front();
+    contents.remove_prefix(1);
+    if (version != kSidecarVersion) {
+        return absl::UnimplementedError(
+            "Unsupported frame timestamp sidecar version: " + std::to_string(static_cast<int>(version)) + "."
+        );
+    }
+    uint64_t timestamp_count;
+    // every timestamp takes up at least a byte
+    if (!ReadVarint(contents, timestamp_count) || timestamp_count > contents.size()) {
+        return absl::DataLossError("Frame timestamp sidecar is truncated or corrupt.");
+    }
+    std::vector<int64_t> timestamps;
+    timestamps.reserve(timestamp_count);
+    uint64_t timestamp = 0;
+    for (uint64_t i_timestamp = 0; i_timestamp < timestamp_count; i_timestamp++) {
+        uint64_t encoded_difference;
+        if (!ReadVarint(contents, encoded_difference)) {
+            return absl::DataLossError("Frame timestamp sidecar is truncated or corrupt.");
+        }
+        timestamp += static_cast<uint64_t>(ZigZagDecode(encoded_difference));
+        timestamps.push_back(static_cast<int64_t>(timestamp));
+    }
+    return timestamps;
+}
+
+bool IsFrameTimestampSidecar(std::string_view contents) {
+    return contents.size() > kSidecarMagic.size() && contents.substr(0, kSidecarMagic.size()) == kSidecarMagic;
+}
+
+} // namespace presage::smartspectra::video_source::capture
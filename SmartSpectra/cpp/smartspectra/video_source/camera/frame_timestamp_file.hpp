@@ -0,0 +1,47 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::video_source::capture {
+
+/**
+ * Read per-frame timestamps of a prerecorded video, in microseconds, from either of:
+ * - a text file holding one timestamp per line, in milliseconds;
+ * - a binary timestamp sidecar, as written by WriteFrameTimestampSidecar (recognized by its leading magic bytes).
+ *
+ * The file is memory-mapped where possible rather than read in line by line.
+ */
+absl::StatusOr<std::vector<int64_t>> ReadFrameTimestampFile(const std::filesystem::path& path);
+
+/**
+ * Parse timestamp text (one timestamp per line, in milliseconds) into timestamps in microseconds.
+ * Blank lines are ignored; lines that don't start with an integer are skipped with a (single) warning.
+ */
+std::vector<int64_t> ParseFrameTimestampText(std::string_view text);
+
+/**
+ * Write frame timestamps, in microseconds, as a binary timestamp sidecar: magic bytes, format version, then the
+ * timestamp count and differences between consecutive timestamps as zigzag-encoded LEB128 varints. At 30 FPS, that
+ * comes down to 3 bytes per frame. The frame_timestamp_converter sample converts timestamp text files this way.
+ */
+absl::Status WriteFrameTimestampSidecar(const std::filesystem::path& path, const std::vector<int64_t>& timestamps);
+
+/** Decode the contents of a binary timestamp sidecar. */
+absl::StatusOr<std::vector<int64_t>> DecodeFrameTimestampSidecar(std::string_view contents);
+
+/** Whether the given file contents are those of a binary timestamp sidecar. */
+bool IsFrameTimestampSidecar(std::string_view contents);
+
+} // namespace presage::smartspectra::video_source::capture
@@ -0,0 +1,200 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+// === third-party includes (if any) ===
+#ifdef WITH_TURBOJPEG
+#include <turbojpeg.h>
+#endif
+#include <mediapipe/framework/port/opencv_imgcodecs_inc.h>
+#include <mediapipe/framework/port/opencv_imgproc_inc.h>
+// === local includes (if any) ===
+#include "mjpeg_decoder.hpp"
+
+namespace presage::smartspectra::video_source::mjpeg {
+
+// ==== MjpegDecoder
+
+MjpegDecoder::MjpegDecoder() {
+#ifdef WITH_TURBOJPEG
+    this->handle = tjInitDecompress();
+#endif
+}
+
+MjpegDecoder::~MjpegDecoder() {
+#ifdef WITH_TURBOJPEG
+    if (this->handle != nullptr) {
+        tjDestroy(this->handle);
+    }
+#endif
+}
+
+int MjpegDecoder::SelectScaleDenominator(
+    int capture_width_px,
+    int capture_height_px,
+    int target_width_px,
+    int target_height_px
+) {
+    if (target_width_px <= 0 || target_height_px <= 0 || capture_width_px <= 0 || capture_height_px <= 0) {
+        return 1;
+    }
+    for (int scale_denominator: {4, 2}) {
+        // decoded dimensions are rounded up
+        int scaled_width = (capture_width_px + scale_denominator - 1) / scale_denominator;
+        int scaled_height = (capture_height_px + scale_denominator - 1) / scale_denominator;
+        if (scaled_width >= target_width_px && scaled_height >= target_height_px) {
+            return scale_denominator;
+        }
+    }
+    return 1;
+}
+
+absl::Status MjpegDecoder::Decode(
+    const uint8_t* data,
+    size_t size,
+    int scale_denominator,
+    DecodedPixelOrder pixel_order,
+    cv::Mat& frame
+) {
+    if (size == 0) {
+        return absl::DataLossError("Empty JPEG frame.");
+    }
+#ifdef WITH_TURBOJPEG
+    if (this->handle == nullptr) {
+        return absl::InternalError("Failed to initialize the JPEG decompressor.");
+    }
+    int width, height, subsampling, colorspace;
+    if (tjDecompressHeader3(this->handle, data, static_cast<unsigned long>(size),
+                            &width, &height, &subsampling, &colorspace) != 0) {
+        return absl::DataLossError(std::string("Failed to read JPEG header: ") + tjGetErrorStr2(this->handle));
+    }
+    const tjscalingfactor scaling_factor{1, scale_denominator};
+    const int scaled_width = TJSCALED(width, scaling_factor);
+    const int scaled_height = TJSCALED(height, scaling_factor);
+    frame.create(scaled_height, scaled_width, CV_8UC3);
+    if (tjDecompress2(this->handle, data, static_cast<unsigned long>(size), frame.data,
+                      scaled_width, static_cast<int>(frame.step[0]), scaled_height,
+                      pixel_order == DecodedPixelOrder::RGB ? TJPF_RGB : TJPF_BGR, 0) != 0 &&
+        tjGetErrorCode(this->handle) == TJERR_FATAL) {
+        // warnings (e.g. a few corrupt bytes at the end of a webcam frame) still produce a usable image
+        return absl::DataLossError(std::string("Failed to decode JPEG frame: ") + tjGetErrorStr2(this->handle));
+    }
+#else
+    int read_flag;
+    switch (scale_denominator) {
+        case 4: read_flag = cv::IMREAD_REDUCED_COLOR_4; break;
+        case 2: read_flag = cv::IMREAD_REDUCED_COLOR_2; break;
+        default: read_flag = cv::IMREAD_COLOR; break;
+    }
+    cv::Mat encoded(1, static_cast<int>(size), CV_8UC1, const_cast<uint8_t*>(data));
+    cv::imdecode(encoded, read_flag, &frame);
+    if (frame.empty()) {
+        return absl::DataLossError("Failed to decode JPEG frame.");
+    }
+    if (pixel_order == DecodedPixelOrder::RGB) {
+        cv::cvtColor(frame, frame, cv::COLOR_BGR2RGB);
+    }
+#endif
+    return absl::OkStatus();
+}
+
+// ==== OrderedMjpegDecodePool
+
+OrderedMjpegDecodePool::OrderedMjpegDecodePool(
+    int worker_count,
+    int scale_denominator,
+    DecodedPixelOrder pixel_order
+) : scale_denominator(scale_denominator), pixel_order(pixel_order) {
+    if (worker_count <= 0) {
+        // leave most cores to the graph
+        worker_count = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) / 4, 1, 3);
+    }
+    this->worker_threads.reserve(worker_count);
+    for (int i_worker = 0; i_worker < worker_count; i_worker++) {
+        this->worker_threads.emplace_back(&OrderedMjpegDecodePool::RunWorker, this);
+    }
+}
+
+OrderedMjpegDecodePool::~OrderedMjpegDecodePool() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->job_available.notify_all();
+    for (auto& worker_thread: this->worker_threads) {
+        worker_thread.join();
+    }
+}
+
+void OrderedMjpegDecodePool::Submit(
+    std::vector<uint8_t> compressed_frame,
+    int64_t timestamp_us,
+    uint32_t sequence_number
+) {
+    auto job = std::make_shared<Job>();
+    job->compressed_frame = std::move(compressed_frame);
+    job->result.timestamp_us = timestamp_us;
+    job->result.sequence_number = sequence_number;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back(std::move(job));
+    }
+    this->job_available.notify_one();
+}
+
+OrderedMjpegDecodePool::DecodedFrame OrderedMjpegDecodePool::Next() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (this->jobs.empty()) {
+        DecodedFrame no_frame;
+        no_frame.status = absl::FailedPreconditionError("No frames submitted for decoding.");
+        return no_frame;
+    }
+    std::shared_ptr<Job> job = this->jobs.front();
+    this->job_done.wait(lock, [&job] { return job->done; });
+    this->jobs.pop_front();
+    return std::move(job->result);
+}
+
+size_t OrderedMjpegDecodePool::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->jobs.size();
+}
+
+void OrderedMjpegDecodePool::RunWorker() {
+    MjpegDecoder decoder;
+    while (true) {
+        std::shared_ptr<Job> job;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->job_available.wait(lock, [this, &job] {
+                for (const auto& pending_job: this->jobs) {
+                    if (!pending_job->claimed) {
+                        job = pending_job;
+                        return true;
+                    }
+                }
+                return this->stopping;
+            });
+            if (job == nullptr) {
+                return;
+            }
+            job->claimed = true;
+        }
+        job->result.status = decoder.Decode(
+            job->compressed_frame.data(), job->compressed_frame.size(), this->scale_denominator, this->pixel_order,
+            job->result.frame
+        );
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            job->compressed_frame = {};
+            job->done = true;
+        }
+        this->job_done.notify_all();
+    }
+}
+
+} // namespace presage::smartspectra::video_source::mjpeg
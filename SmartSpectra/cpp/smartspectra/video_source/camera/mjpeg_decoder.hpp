@@ -0,0 +1,111 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::video_source::mjpeg {
+
+enum class DecodedPixelOrder {
+    BGR,
+    RGB
+};
+
+/**
+ * @brief Decodes (M)JPEG frames straight to packed 8-bit BGR or RGB, optionally downscaling in the DCT domain.
+ *
+ * Uses libjpeg-turbo when built with it (WITH_TURBOJPEG), OpenCV's decoder otherwise. Not thread-safe: use one
+ * decoder per thread.
+ */
+class MjpegDecoder {
+public:
+    MjpegDecoder();
+    ~MjpegDecoder();
+    MjpegDecoder(const MjpegDecoder&) = delete;
+    MjpegDecoder& operator=(const MjpegDecoder&) = delete;
+
+    /**
+     * Pick the DCT scaling denominator (1, 2 or 4) that shrinks the capture size the most while still
+     * covering the target size.
+     * @param target_width_px,target_height_px smallest frame size needed downstream; non-positive means "full size"
+     */
+    static int SelectScaleDenominator(int capture_width_px, int capture_height_px,
+                                      int target_width_px, int target_height_px);
+
+    /**
+     * Decode a JPEG image, at 1/scale_denominator of its encoded size (rounded up).
+     * @param frame receives the decoded image; its buffer is reused when the size matches
+     */
+    absl::Status Decode(const uint8_t* data, size_t size, int scale_denominator, DecodedPixelOrder pixel_order,
+                        cv::Mat& frame);
+private:
+    // libjpeg-turbo decompressor handle (if available)
+    void* handle = nullptr;
+};
+
+/**
+ * @brief Decodes (M)JPEG frames on a small pool of worker threads, delivering them in submission order.
+ */
+class OrderedMjpegDecodePool {
+public:
+    struct DecodedFrame {
+        absl::Status status;
+        cv::Mat frame;
+        int64_t timestamp_us = 0;
+        uint32_t sequence_number = 0;
+    };
+
+    /**
+     * @param worker_count number of decoding threads, 0 picks one based on hardware concurrency
+     */
+    OrderedMjpegDecodePool(int worker_count, int scale_denominator, DecodedPixelOrder pixel_order);
+    ~OrderedMjpegDecodePool();
+    OrderedMjpegDecodePool(const OrderedMjpegDecodePool&) = delete;
+    OrderedMjpegDecodePool& operator=(const OrderedMjpegDecodePool&) = delete;
+
+    void Submit(std::vector<uint8_t> compressed_frame, int64_t timestamp_us, uint32_t sequence_number);
+
+    /** Block until the oldest submitted frame is decoded and return it. Requires a pending frame. */
+    DecodedFrame Next();
+
+    /** Frames submitted, but not yet retrieved with Next(). */
+    size_t GetPendingCount() const;
+
+    int GetWorkerCount() const { return static_cast<int>(this->worker_threads.size()); }
+private:
+    struct Job {
+        std::vector<uint8_t> compressed_frame;
+        DecodedFrame result;
+        bool claimed = false;
+        bool done = false;
+    };
+
+    void RunWorker();
+
+    const int scale_denominator;
+    const DecodedPixelOrder pixel_order;
+
+    mutable std::mutex mutex;
+    std::condition_variable job_available;
+    std::condition_variable job_done;
+    // in submission order; workers claim the oldest unclaimed job, Next() pops from the front
+    std::deque<std::shared_ptr<Job>> jobs;
+    bool stopping = false;
+    std::vector<std::thread> worker_threads;
+};
+
+} // namespace presage::smartspectra::video_source::mjpeg
@@ -0,0 +1,385 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <string>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "synchronized_camera_group.hpp"
+
+namespace presage::smartspectra::video_source::v4l2 {
+
+namespace {
+
+// how often the capture thread checks whether it should stop while no camera has a frame ready
+constexpr int kStopCheckIntervalMs = 100;
+// how long any one camera may go without producing a frame before giving up on the group
+constexpr int kFrameWaitTimeoutMs = 5000;
+// frames of a camera waiting for their counterparts at most, e.g. while another camera is still warming up
+constexpr size_t kMaxUnmatchedFramesPerCamera = 8;
+
+} // anonymous namespace
+
+// region ========================================= STREAM =============================================================
+class SynchronizedCameraGroup::Stream : public VideoSource {
+public:
+    Stream(SynchronizedCameraGroup& group, int camera_index)
+        : group(group), camera(*group.cameras[camera_index]), camera_index(camera_index),
+          decode_scale_denominator(this->camera.source->GetDecodeScaleDenominator()) {}
+
+    bool SupportsExactFrameTimestamp() const override {
+        return true;
+    }
+
+    int64_t GetFrameTimestamp() const override {
+        return this->frame_timestamp_us;
+    }
+
+    absl::Status TurnOnAutoExposure() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->TurnOnAutoExposure();
+    }
+
+    absl::Status TurnOffAutoExposure() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->TurnOffAutoExposure();
+    }
+
+    absl::Status ToggleAutoExposure() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->ToggleAutoExposure();
+    }
+
+    absl::StatusOr<bool> IsAutoExposureOn() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->IsAutoExposureOn();
+    }
+
+    absl::Status IncreaseExposure() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->IncreaseExposure();
+    }
+
+    absl::Status DecreaseExposure() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->DecreaseExposure();
+    }
+
+    bool SupportsExposureControls() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->SupportsExposureControls();
+    }
+
+    int GetWidth() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->GetWidth();
+    }
+
+    int GetHeight() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->GetHeight();
+    }
+
+    InputTransformMode GetDefaultInputTransformMode() override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->GetDefaultInputTransformMode();
+    }
+
+    std::vector<PixelFormat> GetSupportedPixelFormats() const override {
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->GetSupportedPixelFormats();
+    }
+
+    absl::Status SetOutputPixelFormat(PixelFormat pixel_format) override {
+        MP_RETURN_IF_ERROR(VideoSource::SetOutputPixelFormat(pixel_format));
+        std::lock_guard<std::mutex> lock(this->camera.source_mutex);
+        return this->camera.source->SetOutputPixelFormat(pixel_format);
+    }
+
+protected:
+    void ProducePreTransformFrame(cv::Mat& frame) override {
+        while (true) {
+            auto synchronized_frame = this->group.WaitForSynchronizedFrame(this->camera_index);
+            if (!synchronized_frame.has_value()) {
+                frame.release();
+                return;
+            }
+            if (!synchronized_frame->compressed_frame.empty()) {
+                // decode on the consumer's thread, straight to the current output pixel format, into a fresh buffer
+                // (the previous frame may still be in use downstream)
+                cv::Mat decoded_frame;
+                absl::Status decode_status = this->decoder.Decode(
+                    synchronized_frame->compressed_frame.data(), synchronized_frame->compressed_frame.size(),
+                    this->decode_scale_denominator,
+                    this->output_pixel_format == PixelFormat::RGB ? mjpeg::DecodedPixelOrder::RGB
+                                                                  : mjpeg::DecodedPixelOrder::BGR,
+                    decoded_frame
+                );
+                if (!decode_status.ok()) {
+                    LOG(WARNING) << "Skipping camera frame: " << decode_status.message();
+                    continue;
+                }
+                frame = std::move(decoded_frame);
+                this->frame_timestamp_us = synchronized_frame->timestamp_us;
+                return;
+            }
+            // frames captured before the last pixel format switch are of no use anymore
+            if (synchronized_frame->pixel_format == this->output_pixel_format) {
+                frame = std::move(synchronized_frame->frame);
+                this->frame_timestamp_us = synchronized_frame->timestamp_us;
+                return;
+            }
+        }
+    }
+
+private:
+    SynchronizedCameraGroup& group;
+    Camera& camera;
+    const int camera_index;
+    const int decode_scale_denominator;
+    mjpeg::MjpegDecoder decoder;
+    int64_t frame_timestamp_us = 0;
+};
+// endregion ===========================================================================================================
+// region ========================================= GROUP ==============================================================
+SynchronizedCameraGroup::SynchronizedCameraGroup(std::shared_ptr<V4l2DeviceInterface> device)
+    : device(std::move(device)) {}
+
+SynchronizedCameraGroup::~SynchronizedCameraGroup() {
+    this->Stop();
+}
+
+absl::Status SynchronizedCameraGroup::Initialize(const SynchronizedCameraGroupSettings& settings) {
+    if (!this->cameras.empty()) {
+        return absl::FailedPreconditionError(
+            "The synchronized camera group is already initialized; streams taken from it refer to its cameras."
+        );
+    }
+    if (settings.camera_settings.empty()) {
+        return absl::InvalidArgumentError("A synchronized camera group needs at least one camera.");
+    }
+    if (settings.sync_tolerance_us < 0 || settings.stream_queue_capacity < 1) {
+        return absl::InvalidArgumentError(
+            "Synchronization tolerance must be non-negative and stream queue capacity must be positive."
+        );
+    }
+    std::set<int> device_indices;
+    for (const auto& camera_settings: settings.camera_settings) {
+        if (!device_indices.insert(camera_settings.device_index).second) {
+            return absl::InvalidArgumentError(
+                "Camera " + std::to_string(camera_settings.device_index) + " appears in the group more than once."
+            );
+        }
+    }
+    this->sync_tolerance_us = settings.sync_tolerance_us;
+    this->stream_queue_capacity = static_cast<size_t>(settings.stream_queue_capacity);
+
+    // only kept once all cameras are streaming, so that a failed initialization can be retried
+    std::vector<std::unique_ptr<Camera>> cameras;
+    for (const auto& camera_settings: settings.camera_settings) {
+        auto camera = std::make_unique<Camera>();
+        camera->settings = camera_settings;
+        camera->settings.v4l2_streaming = true;
+        camera->source = std::make_unique<V4l2StreamingCameraSource>(this->device);
+        MP_RETURN_IF_ERROR(camera->source->Initialize(camera->settings));
+        cameras.push_back(std::move(camera));
+    }
+    this->cameras = std::move(cameras);
+    LOG(INFO) << "Capturing from " << this->cameras.size() << " cameras, synchronized within "
+              << this->sync_tolerance_us << " us.";
+
+    this->unmatched_frame_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(this->stream_mutex);
+        this->capturing = true;
+    }
+    this->keep_capturing = true;
+    this->capture_thread = std::thread(&SynchronizedCameraGroup::RunCapture, this);
+    return absl::OkStatus();
+}
+
+void SynchronizedCameraGroup::Stop() {
+    this->keep_capturing = false;
+    if (this->capture_thread.joinable()) {
+        this->capture_thread.join();
+    }
+}
+
+absl::StatusOr<std::unique_ptr<VideoSource>> SynchronizedCameraGroup::TakeStream(int camera_index) {
+    if (camera_index < 0 || camera_index >= this->GetCameraCount()) {
+        return absl::OutOfRangeError(
+            "No camera " + std::to_string(camera_index) + " in a group of " + std::to_string(this->GetCameraCount())
+            + " cameras."
+        );
+    }
+    Camera& camera = *this->cameras[camera_index];
+    if (camera.stream_taken) {
+        return absl::FailedPreconditionError(
+            "The stream of camera " + std::to_string(camera_index) + " has already been taken."
+        );
+    }
+    auto stream = std::make_unique<Stream>(*this, camera_index);
+    MP_RETURN_IF_ERROR(stream->Initialize(camera.settings));
+    camera.stream_taken = true;
+    return stream;
+}
+
+int SynchronizedCameraGroup::GetCameraCount() const {
+    return static_cast<int>(this->cameras.size());
+}
+
+int64_t SynchronizedCameraGroup::GetUnmatchedFrameCount() const {
+    return this->unmatched_frame_count;
+}
+
+void SynchronizedCameraGroup::RunCapture() {
+    std::vector<struct pollfd> poll_descriptors;
+    poll_descriptors.reserve(this->cameras.size());
+    for (const auto& camera: this->cameras) {
+        poll_descriptors.push_back({camera->source->GetFileDescriptor(), POLLIN, 0});
+    }
+    absl::Status capture_status;
+    const auto capture_start_time = std::chrono::steady_clock::now();
+    for (auto& camera: this->cameras) {
+        camera->last_frame_time = capture_start_time;
+    }
+    while (this->keep_capturing && capture_status.ok()) {
+        for (auto& poll_descriptor: poll_descriptors) {
+            poll_descriptor.revents = 0;
+        }
+        int wait_result = this->device->WaitForFrames(poll_descriptors, kStopCheckIntervalMs);
+        if (wait_result < 0) {
+            capture_status = absl::UnavailableError(
+                std::string("Failed waiting for camera frames (") + std::strerror(errno) + ")"
+            );
+        } else if (wait_result > 0) {
+            capture_status = this->CaptureReadyFrames(poll_descriptors);
+            this->MatchFrames();
+        }
+        if (capture_status.ok()) {
+            // a single stalled camera would leave the frames of all others unmatched for good
+            capture_status = this->CheckForStalledCameras();
+        }
+    }
+    if (!capture_status.ok()) {
+        LOG(ERROR) << capture_status.message();
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->stream_mutex);
+        this->capturing = false;
+    }
+    this->synchronized_frames_ready.notify_all();
+}
+
+absl::Status SynchronizedCameraGroup::CaptureReadyFrames(const std::vector<struct pollfd>& poll_descriptors) {
+    for (size_t i_camera = 0; i_camera < this->cameras.size(); i_camera++) {
+        if (poll_descriptors[i_camera].revents == 0) {
+            continue;
+        }
+        Camera& camera = *this->cameras[i_camera];
+        TimestampedFrame captured_frame;
+        {
+            std::lock_guard<std::mutex> lock(camera.source_mutex);
+            if (camera.source->DeliversCompressedFrames()) {
+                // just take the frame off the driver, decoding is up to the stream
+                MP_ASSIGN_OR_RETURN(auto compressed_frame, camera.source->ReadCompressedFrame());
+                if (!compressed_frame.has_value()) {
+                    // no frame after all, or one the driver flagged as corrupted
+                    continue;
+                }
+                captured_frame.compressed_frame = std::move(compressed_frame->data);
+                captured_frame.timestamp_us = compressed_frame->timestamp_us;
+            } else {
+                camera.source->ReadPreTransformFrame(captured_frame.frame);
+                captured_frame.timestamp_us = camera.source->GetFrameTimestamp();
+                captured_frame.pixel_format = camera.source->GetOutputPixelFormat();
+            }
+        }
+        if (captured_frame.frame.empty() && captured_frame.compressed_frame.empty()) {
+            return absl::UnavailableError(
+                "Camera " + std::to_string(camera.settings.device_index) + " stopped producing frames."
+            );
+        }
+        camera.last_frame_time = std::chrono::steady_clock::now();
+        camera.unmatched_frames.push_back(std::move(captured_frame));
+        if (camera.unmatched_frames.size() > kMaxUnmatchedFramesPerCamera) {
+            camera.unmatched_frames.pop_front();
+            this->unmatched_frame_count++;
+        }
+    }
+    return absl::OkStatus();
+}
+
+absl::Status SynchronizedCameraGroup::CheckForStalledCameras() const {
+    const auto now = std::chrono::steady_clock::now();
+    for (const auto& camera: this->cameras) {
+        if (now - camera->last_frame_time >= std::chrono::milliseconds(kFrameWaitTimeoutMs)) {
+            return absl::DeadlineExceededError(
+                "Camera " + std::to_string(camera->settings.device_index) + " produced no frames for "
+                + std::to_string(kFrameWaitTimeoutMs) + " ms."
+            );
+        }
+    }
+    return absl::OkStatus();
+}
+
+void SynchronizedCameraGroup::MatchFrames() {
+    auto has_unmatched_frames = [](const std::unique_ptr<Camera>& camera) {
+        return !camera->unmatched_frames.empty();
+    };
+    auto by_oldest_frame = [](const std::unique_ptr<Camera>& a, const std::unique_ptr<Camera>& b) {
+        return a->unmatched_frames.front().timestamp_us < b->unmatched_frames.front().timestamp_us;
+    };
+    bool frames_matched = false;
+    while (std::all_of(this->cameras.begin(), this->cameras.end(), has_unmatched_frames)) {
+        auto [earliest, latest] = std::minmax_element(this->cameras.begin(), this->cameras.end(), by_oldest_frame);
+        if ((*latest)->unmatched_frames.front().timestamp_us - (*earliest)->unmatched_frames.front().timestamp_us >
+            this->sync_tolerance_us) {
+            // every frame the latest camera has left is later still, so the earliest frame can't ever be matched
+            (*earliest)->unmatched_frames.pop_front();
+            this->unmatched_frame_count++;
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(this->stream_mutex);
+        for (auto& camera: this->cameras) {
+            camera->synchronized_frames.push_back(std::move(camera->unmatched_frames.front()));
+            camera->unmatched_frames.pop_front();
+            if (camera->synchronized_frames.size() > this->stream_queue_capacity) {
+                // the consumer of this stream is falling behind, which mustn't hold up the others
+                camera->synchronized_frames.pop_front();
+            }
+        }
+        frames_matched = true;
+    }
+    if (frames_matched) {
+        this->synchronized_frames_ready.notify_all();
+    }
+}
+
+std::optional<SynchronizedCameraGroup::TimestampedFrame>
+SynchronizedCameraGroup::WaitForSynchronizedFrame(int camera_index) {
+    Camera& camera = *this->cameras[camera_index];
+    std::unique_lock<std::mutex> lock(this->stream_mutex);
+    this->synchronized_frames_ready.wait(lock, [this, &camera] {
+        return !camera.synchronized_frames.empty() || !this->capturing;
+    });
+    if (camera.synchronized_frames.empty()) {
+        return std::nullopt;
+    }
+    TimestampedFrame synchronized_frame = std::move(camera.synchronized_frames.front());
+    camera.synchronized_frames.pop_front();
+    return synchronized_frame;
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::video_source::v4l2
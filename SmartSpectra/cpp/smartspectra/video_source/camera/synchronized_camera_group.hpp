@@ -0,0 +1,135 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+#include <smartspectra/video_source/video_source.hpp>
+#include <smartspectra/video_source/settings.hpp>
+#include "v4l2_streaming_source.hpp"
+
+namespace presage::smartspectra::video_source::v4l2 {
+
+/**
+ * @brief Configuration options for constructing a SynchronizedCameraGroup.
+ * \ingroup video_source
+ */
+struct SynchronizedCameraGroupSettings {
+    /**
+     * settings of each camera in the group (device index, resolution, codec, input transform, decoding...), of which
+     * v4l2_streaming is implied
+     */
+    std::vector<VideoSourceSettings> camera_settings;
+    /** frames of different cameras with timestamps at most this far apart (in microseconds) count as simultaneous */
+    int64_t sync_tolerance_us = 10000;
+    /** synchronized frames waiting for the consumer of each stream at most; the oldest get dropped beyond that */
+    int stream_queue_capacity = 2;
+};
+
+/**
+ * @brief Captures from several V4L2 cameras at once and splits the result into one stream per camera, in which every
+ * frame has a counterpart with (nearly) the same timestamp in each of the other streams.
+ *
+ * All cameras are served by a single capture thread, which waits on all of their devices at once and reads from
+ * whichever have a frame ready, so that capture overhead stays flat as cameras get added. Since V4L2 buffer
+ * timestamps all come from the same (monotonic) clock, frames get matched across cameras by timestamp: a frame
+ * that no other camera has a frame close enough to (per sync_tolerance_us) gets dropped. MJPEG frames are taken off
+ * the drivers still compressed and only decoded by each stream, on the thread consuming it: the capture thread never
+ * waits on a decoder, decoding for different cameras runs in parallel, and dropped frames don't get decoded at all.
+ *
+ * Each stream is a VideoSource in its own right, e.g. for a separate container (see
+ * ForegroundContainer::SetVideoSource); a stream whose consumer falls behind drops its oldest frames, without holding
+ * up the other streams. When any camera stops producing frames (or goes silent for more than a few seconds), all
+ * streams end.
+ * \ingroup video_source
+ */
+class SynchronizedCameraGroup {
+public:
+    explicit SynchronizedCameraGroup(std::shared_ptr<V4l2DeviceInterface> device = GetSystemV4l2Device());
+    ~SynchronizedCameraGroup();
+    SynchronizedCameraGroup(const SynchronizedCameraGroup&) = delete;
+    SynchronizedCameraGroup& operator=(const SynchronizedCameraGroup&) = delete;
+
+    /**
+     * Start streaming from all cameras in the group, then start the capture thread. A group can only be initialized
+     * once (successfully), since the streams it hands out refer to its cameras.
+     */
+    absl::Status Initialize(const SynchronizedCameraGroupSettings& settings);
+    /** Stop the capture thread; all streams end once they run out of already synchronized frames. */
+    void Stop();
+
+    /**
+     * Hand out the stream of the given camera (by its position in SynchronizedCameraGroupSettings::camera_settings).
+     * Each stream can only be taken once, and must not outlive the group.
+     */
+    absl::StatusOr<std::unique_ptr<VideoSource>> TakeStream(int camera_index);
+
+    int GetCameraCount() const;
+    /** Number of frames dropped so far because none of the other cameras had a frame close enough in time. */
+    int64_t GetUnmatchedFrameCount() const;
+private:
+    class Stream;
+
+    struct TimestampedFrame {
+        cv::Mat frame;
+        // set instead of frame for compressed frames, which get decoded by the stream
+        std::vector<uint8_t> compressed_frame;
+        int64_t timestamp_us = 0;
+        PixelFormat pixel_format = PixelFormat::BGR;
+    };
+
+    struct Camera {
+        VideoSourceSettings settings;
+        std::unique_ptr<V4l2StreamingCameraSource> source;
+        // held by the capture thread while reading from the source, and by the stream while controlling the camera
+        std::mutex source_mutex;
+        // frames still waiting for a counterpart from each of the other cameras, only accessed by the capture thread
+        std::deque<TimestampedFrame> unmatched_frames;
+        // when the camera last produced a frame (or capture started), only accessed by the capture thread
+        std::chrono::steady_clock::time_point last_frame_time;
+        // frames waiting for the consumer of the stream, guarded by stream_mutex
+        std::deque<TimestampedFrame> synchronized_frames;
+        bool stream_taken = false;
+    };
+
+    /** Capture thread: wait for frames from any of the cameras, read them in and match them up. */
+    void RunCapture();
+    absl::Status CaptureReadyFrames(const std::vector<struct pollfd>& poll_descriptors);
+    /** Hand every complete set of simultaneous frames over to the streams, dropping frames that can't be matched. */
+    void MatchFrames();
+    /** Fail if any one camera has gone too long without producing a frame. */
+    absl::Status CheckForStalledCameras() const;
+    /** @return the next synchronized frame of the given camera, or std::nullopt once capture has stopped */
+    std::optional<TimestampedFrame> WaitForSynchronizedFrame(int camera_index);
+
+    std::shared_ptr<V4l2DeviceInterface> device;
+    int64_t sync_tolerance_us = 0;
+    size_t stream_queue_capacity = 0;
+    std::vector<std::unique_ptr<Camera>> cameras;
+
+    std::mutex stream_mutex;
+    std::condition_variable synchronized_frames_ready;
+    // guarded by stream_mutex
+    bool capturing = false;
+    std::atomic<bool> keep_capturing = false;
+    std::atomic<int64_t> unmatched_frame_count = 0;
+    std::thread capture_thread;
+};
+
+} // namespace presage::smartspectra::video_source::v4l2
@@ -0,0 +1,794 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <linux/videodev2.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+#include <mediapipe/framework/port/opencv_imgproc_inc.h>
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "v4l2_streaming_source.hpp"
+#include "camera_opencv.hpp"
+#include "camera_v4l2.hpp"
+
+namespace presage::smartspectra::video_source::v4l2 {
+
+namespace pcam = presage::camera;
+namespace pcam_cv = presage::camera::opencv;
+namespace pcam_v4l2 = presage::camera::v4l2;
+
+namespace {
+
+constexpr int kRequestedBufferCount = 4;
+// how long to wait for the driver to fill a buffer before giving up on the stream
+constexpr int kFrameWaitTimeoutMs = 5000;
+// how many unusable frames in a row to skip before giving up on the stream
+constexpr int kMaxConsecutiveSkippedFrames = 30;
+
+class SystemV4l2Device : public V4l2DeviceInterface {
+public:
+    int Open(const std::string& device_path, int flags) override {
+        return open(device_path.c_str(), flags);
+    }
+
+    int Close(int file_descriptor) override {
+        return close(file_descriptor);
+    }
+
+    int Ioctl(int file_descriptor, unsigned long request, void* argument) override {
+        int result;
+        do {
+            result = ioctl(file_descriptor, request, argument);
+        } while (result == -1 && errno == EINTR);
+        return result;
+    }
+
+    void* Mmap(size_t length, int protection, int flags, int file_descriptor, off_t offset) override {
+        return mmap(nullptr, length, protection, flags, file_descriptor, offset);
+    }
+
+    int Munmap(void* address, size_t length) override {
+        return munmap(address, length);
+    }
+
+    int WaitForFrame(int file_descriptor, int timeout_ms) override {
+        struct pollfd poll_descriptor{file_descriptor, POLLIN, 0};
+        int result;
+        do {
+            result = poll(&poll_descriptor, 1, timeout_ms);
+        } while (result == -1 && errno == EINTR);
+        return result;
+    }
+
+    int WaitForFrames(std::vector<struct pollfd>& poll_descriptors, int timeout_ms) override {
+        int result;
+        do {
+            result = poll(poll_descriptors.data(), poll_descriptors.size(), timeout_ms);
+        } while (result == -1 && errno == EINTR);
+        return result;
+    }
+};
+
+std::string ErrnoMessage() {
+    return std::string(" (") + std::strerror(errno) + ")";
+}
+
+uint32_t GetPixelFormatForCodec(pcam::CaptureCodec codec) {
+    switch (codec) {
+        case pcam::CaptureCodec::UYVY:
+            return V4L2_PIX_FMT_UYVY;
+        case pcam::CaptureCodec::MJPG:
+        default:
+            return V4L2_PIX_FMT_MJPEG;
+    }
+}
+
+std::string PixelFormatToString(uint32_t pixel_format) {
+    return {
+        static_cast<char>(pixel_format & 0xFF),
+        static_cast<char>((pixel_format >> 8) & 0xFF),
+        static_cast<char>((pixel_format >> 16) & 0xFF),
+        static_cast<char>((pixel_format >> 24) & 0xFF)
+    };
+}
+
+} // anonymous namespace
+
+std::shared_ptr<V4l2DeviceInterface> GetSystemV4l2Device() {
+    static std::shared_ptr<V4l2DeviceInterface> system_device = std::make_shared<SystemV4l2Device>();
+    return system_device;
+}
+
+V4l2StreamingCameraSource::V4l2StreamingCameraSource(std::shared_ptr<V4l2DeviceInterface> device)
+    : device(std::move(device)) {}
+
+V4l2StreamingCameraSource::~V4l2StreamingCameraSource() {
+    this->Close();
+}
+
+absl::Status V4l2StreamingCameraSource::Initialize(const VideoSourceSettings& settings) {
+    MP_RETURN_IF_ERROR(VideoSource::Initialize(settings));
+    if (settings.input_transform_mode != InputTransformMode::None) {
+        LOG(INFO) << "Input transform mode: " << AbslUnparseFlag(settings.input_transform_mode);
+    }
+    this->Close();
+    const std::string device_path = "/dev/video" + std::to_string(settings.device_index);
+    this->file_descriptor = this->device->Open(device_path, O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (this->file_descriptor == -1) {
+        return absl::NotFoundError("Failed to open video device at " + device_path + ErrnoMessage());
+    }
+
+    struct v4l2_capability capability{};
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_QUERYCAP, &capability) == -1) {
+        return absl::UnavailableError("Failed to query video device capabilities" + ErrnoMessage());
+    }
+    uint32_t capabilities = (capability.capabilities & V4L2_CAP_DEVICE_CAPS) ? capability.device_caps
+                                                                            : capability.capabilities;
+    if (!(capabilities & V4L2_CAP_VIDEO_CAPTURE) || !(capabilities & V4L2_CAP_STREAMING)) {
+        return absl::FailedPreconditionError(
+            device_path + " does not support streaming video capture, which V4L2 streaming mode requires."
+        );
+    }
+    LOG(INFO) << "Camera name: " << reinterpret_cast<const char*>(capability.card);
+
+    MP_RETURN_IF_ERROR(this->SetFormat(settings));
+    if (this->DeliversCompressedFrames()) {
+        this->decode_scale_denominator = mjpeg::MjpegDecoder::SelectScaleDenominator(
+            this->capture_width, this->capture_height,
+            settings.decode_target_width_px, settings.decode_target_height_px
+        );
+        // the decode pool gets started along with the first frame read, it's of no use for ReadCompressedFrame
+        this->decode_thread_count = settings.decode_thread_count;
+        // decoded dimensions are rounded up
+        this->width = (this->capture_width + this->decode_scale_denominator - 1) / this->decode_scale_denominator;
+        this->height = (this->capture_height + this->decode_scale_denominator - 1) / this->decode_scale_denominator;
+        LOG(INFO) << "Decoding camera frames at 1/" << this->decode_scale_denominator << " scale (" << this->width
+                  << " x " << this->height << ").";
+    }
+    MP_RETURN_IF_ERROR(this->SetUpBuffers());
+    this->ConfigureExposureControls();
+
+    int buffer_type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_STREAMON, &buffer_type) == -1) {
+        return absl::InternalError("Failed to start streaming from " + device_path + ErrnoMessage());
+    }
+    this->streaming = true;
+    this->first_frame_dequeued = false;
+    this->dropped_frame_count = 0;
+    return absl::OkStatus();
+}
+
+absl::Status V4l2StreamingCameraSource::SetFormat(const VideoSourceSettings& settings) {
+    const uint32_t requested_pixel_format = GetPixelFormatForCodec(settings.codec);
+
+    // region =================================== SELECT CAMERA RESOLUTION =========================================
+    int requested_width = settings.capture_width_px;
+    int requested_height = settings.capture_height_px;
+    bool use_range = settings.resolution_selection_mode == ResolutionSelectionMode::Range;
+    if (settings.resolution_selection_mode == ResolutionSelectionMode::Auto) {
+        use_range = (requested_width < 0 || requested_height < 0) &&
+                    settings.resolution_range != pcam::CameraResolutionRange::Unspecified_EnumEnd;
+        if (!use_range && (requested_width < 0 || requested_height < 0)) {
+            LOG(INFO) << "No camera resolution range specified, while exact resolution is not specified. "
+                         "Will attempt to use the default exact resolution, 1280x720...";
+            requested_width = 1280;
+            requested_height = 720;
+        }
+    }
+    if (use_range) {
+        if (settings.resolution_range == pcam::CameraResolutionRange::Unspecified_EnumEnd) {
+            return absl::FailedPreconditionError(
+                "No camera resolution range specified with `range` resolution selection mode. Exiting."
+            );
+        }
+        // pick the largest frame size the driver advertises among the common resolutions in range
+        const auto& range = pcam_cv::kCommonCameraResolutionRanges.at(settings.resolution_range);
+        struct v4l2_frmsizeenum frame_size{};
+        frame_size.pixel_format = requested_pixel_format;
+        int64_t best_area = 0;
+        for (frame_size.index = 0;
+             this->device->Ioctl(this->file_descriptor, VIDIOC_ENUM_FRAMESIZES, &frame_size) == 0;
+             frame_size.index++) {
+            if (frame_size.type != V4L2_FRMSIZE_TYPE_DISCRETE) continue;
+            for (int i_resolution = range.first; i_resolution <= range.second; i_resolution++) {
+                const auto& resolution = pcam_cv::kCommonCameraResolutions[i_resolution];
+                int64_t area = static_cast<int64_t>(resolution.width) * resolution.height;
+                if (static_cast<int>(frame_size.discrete.width) == resolution.width &&
+                    static_cast<int>(frame_size.discrete.height) == resolution.height && area > best_area) {
+                    best_area = area;
+                    requested_width = resolution.width;
+                    requested_height = resolution.height;
+                }
+            }
+        }
+        if (best_area == 0) {
+            return absl::FailedPreconditionError("Failed to find a suitable camera resolution.");
+        }
+    } else if (requested_width < 0 || requested_height < 0) {
+        return absl::FailedPreconditionError(
+            "Both `capture_width_px` and `capture_height_px` must be set to positive, nonzero values when using "
+            "the `exact` resolution selection mode. Got: " + std::to_string(requested_width)
+            + " x " + std::to_string(requested_height) + ". Exiting."
+        );
+    }
+    // endregion ===================================================================================================
+
+    struct v4l2_format format{};
+    format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    format.fmt.pix.width = static_cast<uint32_t>(requested_width);
+    format.fmt.pix.height = static_cast<uint32_t>(requested_height);
+    format.fmt.pix.pixelformat = requested_pixel_format;
+    format.fmt.pix.field = V4L2_FIELD_NONE;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_S_FMT, &format) == -1) {
+        return absl::InternalError("Failed to set capture format" + ErrnoMessage());
+    }
+    // the driver may adjust the format to the closest one it supports
+    this->pixel_format = format.fmt.pix.pixelformat;
+    this->capture_width = this->width = static_cast<int>(format.fmt.pix.width);
+    this->capture_height = this->height = static_cast<int>(format.fmt.pix.height);
+    this->bytes_per_line = static_cast<int>(format.fmt.pix.bytesperline);
+    switch (this->pixel_format) {
+        case V4L2_PIX_FMT_MJPEG:
+        case V4L2_PIX_FMT_JPEG:
+        case V4L2_PIX_FMT_YUYV:
+        case V4L2_PIX_FMT_UYVY:
+        case V4L2_PIX_FMT_BGR24:
+        case V4L2_PIX_FMT_RGB24:
+            break;
+        default:
+            return absl::UnimplementedError(
+                "Unsupported pixel format negotiated with the camera driver: " + PixelFormatToString(this->pixel_format)
+            );
+    }
+    if (this->pixel_format != requested_pixel_format) {
+        LOG(WARNING) << "Camera driver substituted pixel format " << PixelFormatToString(this->pixel_format)
+                     << " for the requested " << PixelFormatToString(requested_pixel_format) << ".";
+    }
+
+    struct v4l2_streamparm stream_parameters{};
+    stream_parameters.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    stream_parameters.parm.capture.timeperframe.numerator = 1;
+    stream_parameters.parm.capture.timeperframe.denominator = 30;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_S_PARM, &stream_parameters) == -1) {
+        LOG(WARNING) << "Failed to set camera frame rate" << ErrnoMessage();
+    }
+
+    LOG(INFO) << "Camera set to resolution: " << this->width << " x " << this->height
+              << ", pixel format: " << PixelFormatToString(this->pixel_format);
+    return absl::OkStatus();
+}
+
+absl::Status V4l2StreamingCameraSource::SetUpBuffers() {
+    struct v4l2_requestbuffers buffer_request{};
+    buffer_request.count = kRequestedBufferCount;
+    buffer_request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer_request.memory = V4L2_MEMORY_MMAP;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_REQBUFS, &buffer_request) == -1) {
+        return absl::UnavailableError("Camera driver does not support memory-mapped streaming" + ErrnoMessage());
+    }
+    if (buffer_request.count < 2) {
+        return absl::ResourceExhaustedError("Camera driver provided too few capture buffers.");
+    }
+
+    bool dmabuf_export_supported = true;
+    this->buffers.resize(buffer_request.count);
+    for (uint32_t i_buffer = 0; i_buffer < buffer_request.count; i_buffer++) {
+        struct v4l2_buffer buffer{};
+        buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        buffer.memory = V4L2_MEMORY_MMAP;
+        buffer.index = i_buffer;
+        if (this->device->Ioctl(this->file_descriptor, VIDIOC_QUERYBUF, &buffer) == -1) {
+            return absl::InternalError("Failed to query capture buffer " + std::to_string(i_buffer) + ErrnoMessage());
+        }
+        void* start = this->device->Mmap(
+            buffer.length, PROT_READ | PROT_WRITE, MAP_SHARED, this->file_descriptor, buffer.m.offset
+        );
+        if (start == MAP_FAILED) {
+            return absl::InternalError("Failed to map capture buffer " + std::to_string(i_buffer) + ErrnoMessage());
+        }
+        this->buffers[i_buffer].start = start;
+        this->buffers[i_buffer].length = buffer.length;
+
+        if (dmabuf_export_supported) {
+            struct v4l2_exportbuffer export_buffer{};
+            export_buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+            export_buffer.index = i_buffer;
+            export_buffer.flags = O_RDONLY | O_CLOEXEC;
+            if (this->device->Ioctl(this->file_descriptor, VIDIOC_EXPBUF, &export_buffer) == 0) {
+                this->buffers[i_buffer].dmabuf_file_descriptor = export_buffer.fd;
+            } else {
+                dmabuf_export_supported = false;
+            }
+        }
+
+        if (this->device->Ioctl(this->file_descriptor, VIDIOC_QBUF, &buffer) == -1) {
+            return absl::InternalError("Failed to queue capture buffer " + std::to_string(i_buffer) + ErrnoMessage());
+        }
+    }
+    LOG(INFO) << "Streaming through " << this->buffers.size() << " memory-mapped capture buffers"
+              << (dmabuf_export_supported ? ", exported as DMABUF." : ".");
+    return absl::OkStatus();
+}
+
+void V4l2StreamingCameraSource::ConfigureExposureControls() {
+    this->exposure_controls_supported = false;
+    struct v4l2_queryctrl control{};
+    control.id = V4L2_CID_EXPOSURE_AUTO;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_QUERYCTRL, &control) == -1 ||
+        (control.flags & V4L2_CTRL_FLAG_DISABLED)) {
+        LOG(INFO) << "Camera does not expose an auto exposure control.";
+        return;
+    }
+    std::vector<pcam_v4l2::AutoExposureSetting> auto_exposure_settings;
+    if (control.type == V4L2_CTRL_TYPE_MENU) {
+        struct v4l2_querymenu menu{};
+        menu.id = control.id;
+        for (menu.index = control.minimum; static_cast<int>(menu.index) <= control.maximum; menu.index++) {
+            if (this->device->Ioctl(this->file_descriptor, VIDIOC_QUERYMENU, &menu) == 0) {
+                auto_exposure_settings.push_back(
+                    {static_cast<int>(menu.index), reinterpret_cast<const char*>(menu.name)}
+                );
+            }
+        }
+    }
+    LOG(INFO) << "Auto exposure settings detected by the camera: ";
+    for (const auto& setting: auto_exposure_settings) {
+        LOG(INFO) << "   " << pcam_v4l2::ToString(setting);
+    }
+    auto configuration = pcam_v4l2::InferAutoExposureConfigurationFromSettings(auto_exposure_settings);
+    if (configuration.ok()) {
+        this->auto_exposure_on_value = configuration->auto_exposure_on_value;
+        this->auto_exposure_off_value = configuration->auto_exposure_off_value;
+    } else {
+        // Assume C920 values by default...
+        this->auto_exposure_on_value = pcam::C920E_AUTO_EXPOSURE_ON_SETTING;
+        this->auto_exposure_off_value = pcam::C920E_AUTO_EXPOSURE_OFF_SETTING;
+    }
+    this->exposure_controls_supported = true;
+}
+
+void V4l2StreamingCameraSource::Close() {
+    if (this->file_descriptor == -1) {
+        return;
+    }
+    if (this->streaming) {
+        int buffer_type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        this->device->Ioctl(this->file_descriptor, VIDIOC_STREAMOFF, &buffer_type);
+        this->streaming = false;
+    }
+    for (auto& buffer: this->buffers) {
+        if (buffer.dmabuf_file_descriptor != -1) {
+            this->device->Close(buffer.dmabuf_file_descriptor);
+        }
+        if (buffer.start != nullptr) {
+            this->device->Munmap(buffer.start, buffer.length);
+        }
+    }
+    this->buffers.clear();
+    // release the driver's buffers
+    struct v4l2_requestbuffers buffer_request{};
+    buffer_request.count = 0;
+    buffer_request.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer_request.memory = V4L2_MEMORY_MMAP;
+    this->device->Ioctl(this->file_descriptor, VIDIOC_REQBUFS, &buffer_request);
+    this->device->Close(this->file_descriptor);
+    this->file_descriptor = -1;
+    this->frame_buffer_index = -1;
+    this->decode_pool.reset();
+}
+
+void V4l2StreamingCameraSource::ProducePreTransformFrame(cv::Mat& frame) {
+    absl::Status frame_status = absl::UnavailableError("Camera is not streaming.");
+    for (int i_attempt = 0; this->streaming; i_attempt++) {
+        if (i_attempt > kMaxConsecutiveSkippedFrames) {
+            frame_status = absl::DataLossError("Too many unusable frames from the camera in a row.");
+            break;
+        }
+        auto frame_dequeued = this->DeliversCompressedFrames() ? this->DecodeNextFrame(frame)
+                                                               : this->DequeueAndConvertFrame(frame);
+        if (!frame_dequeued.ok()) {
+            frame_status = frame_dequeued.status();
+            break;
+        }
+        if (*frame_dequeued) {
+            return;
+        }
+        // don't end the stream over a single bad frame, just retry with the next one
+    }
+    LOG(ERROR) << frame_status.message();
+    frame.release();
+}
+
+absl::StatusOr<std::optional<V4l2StreamingCameraSource::DequeuedBuffer>>
+V4l2StreamingCameraSource::DequeueBuffer(int timeout_ms) {
+    struct v4l2_buffer buffer{};
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    while (true) {
+        int wait_result = this->device->WaitForFrame(this->file_descriptor, timeout_ms);
+        if (wait_result == 0) {
+            return std::nullopt;
+        } else if (wait_result < 0) {
+            return absl::UnavailableError("Failed waiting for a camera frame" + ErrnoMessage());
+        }
+        if (this->device->Ioctl(this->file_descriptor, VIDIOC_DQBUF, &buffer) == 0) {
+            break;
+        }
+        if (errno != EAGAIN) {
+            return absl::UnavailableError("Failed to dequeue a camera frame" + ErrnoMessage());
+        }
+    }
+    if (this->first_frame_dequeued && buffer.sequence > this->last_dequeued_sequence_number + 1) {
+        this->dropped_frame_count += buffer.sequence - this->last_dequeued_sequence_number - 1;
+    }
+    this->last_dequeued_sequence_number = buffer.sequence;
+    this->first_frame_dequeued = true;
+    return DequeuedBuffer{
+        buffer.index,
+        buffer.bytesused,
+        static_cast<bool>(buffer.flags & V4L2_BUF_FLAG_ERROR),
+        buffer.sequence,
+        // V4L2 buffer timestamps are CLOCK_MONOTONIC for all drivers that set V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC
+        static_cast<int64_t>(buffer.timestamp.tv_sec) * 1000000 + static_cast<int64_t>(buffer.timestamp.tv_usec)
+    };
+}
+
+absl::Status V4l2StreamingCameraSource::RequeueBuffer(uint32_t buffer_index) {
+    struct v4l2_buffer buffer{};
+    buffer.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+    buffer.memory = V4L2_MEMORY_MMAP;
+    buffer.index = buffer_index;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_QBUF, &buffer) == -1) {
+        return absl::InternalError("Failed to requeue capture buffer " + std::to_string(buffer_index) + ErrnoMessage());
+    }
+    return absl::OkStatus();
+}
+
+absl::StatusOr<bool> V4l2StreamingCameraSource::DequeueAndConvertFrame(cv::Mat& frame) {
+    MP_ASSIGN_OR_RETURN(std::optional<DequeuedBuffer> buffer, this->DequeueBuffer(kFrameWaitTimeoutMs));
+    if (!buffer.has_value()) {
+        return absl::DeadlineExceededError("Timed out waiting for a camera frame.");
+    }
+    this->frame_timestamp_us = buffer->timestamp_us;
+    this->frame_sequence_number = buffer->sequence_number;
+    this->frame_buffer_index = static_cast<int>(buffer->index);
+
+    absl::Status conversion_status;
+    if (buffer->corrupted) {
+        conversion_status = absl::DataLossError("Camera driver flagged the frame as corrupted.");
+    } else {
+        conversion_status = this->ConvertToOutputFormat(this->buffers[buffer->index], buffer->bytes_used, frame);
+    }
+    // hand the buffer straight back to the driver, the frame no longer refers to it
+    MP_RETURN_IF_ERROR(this->RequeueBuffer(buffer->index));
+    if (!conversion_status.ok()) {
+        LOG(WARNING) << "Skipping camera frame " << buffer->sequence_number << ": " << conversion_status.message();
+        return false;
+    }
+    return true;
+}
+
+absl::StatusOr<bool> V4l2StreamingCameraSource::DecodeNextFrame(cv::Mat& frame) {
+    if (this->decode_pool == nullptr) {
+        this->ResetDecodePool();
+        LOG(INFO) << "Decoding camera frames on " << this->decode_pool->GetWorkerCount() << " threads.";
+    }
+    // Keep the decoders busy with whatever the driver already has ready, but only wait on the driver when there's
+    // nothing in flight: this way, decoding overlaps with capture without adding latency when the consumer keeps up.
+    const size_t max_frames_in_flight = 2 * static_cast<size_t>(this->decode_pool->GetWorkerCount());
+    while (this->decode_pool->GetPendingCount() < max_frames_in_flight) {
+        const bool nothing_in_flight = this->decode_pool->GetPendingCount() == 0;
+        MP_ASSIGN_OR_RETURN(
+            std::optional<DequeuedBuffer> buffer,
+            this->DequeueBuffer(nothing_in_flight ? kFrameWaitTimeoutMs : 0)
+        );
+        if (!buffer.has_value()) {
+            if (nothing_in_flight) {
+                return absl::DeadlineExceededError("Timed out waiting for a camera frame.");
+            }
+            break;
+        }
+        MP_ASSIGN_OR_RETURN(std::optional<CompressedFrame> compressed_frame, this->TakeCompressedFrame(*buffer));
+        if (compressed_frame.has_value()) {
+            this->decode_pool->Submit(
+                std::move(compressed_frame->data), compressed_frame->timestamp_us, compressed_frame->sequence_number
+            );
+        }
+    }
+    if (this->decode_pool->GetPendingCount() == 0) {
+        return false;
+    }
+    mjpeg::OrderedMjpegDecodePool::DecodedFrame decoded_frame = this->decode_pool->Next();
+    this->frame_timestamp_us = decoded_frame.timestamp_us;
+    this->frame_sequence_number = decoded_frame.sequence_number;
+    // the driver buffer has long been reused by now
+    this->frame_buffer_index = -1;
+    if (!decoded_frame.status.ok()) {
+        LOG(WARNING) << "Skipping camera frame " << decoded_frame.sequence_number << ": "
+                     << decoded_frame.status.message();
+        return false;
+    }
+    frame = std::move(decoded_frame.frame);
+    return true;
+}
+
+absl::StatusOr<std::optional<V4l2StreamingCameraSource::CompressedFrame>>
+V4l2StreamingCameraSource::TakeCompressedFrame(const DequeuedBuffer& buffer) {
+    std::optional<CompressedFrame> compressed_frame;
+    if (buffer.corrupted) {
+        LOG(WARNING) << "Skipping camera frame " << buffer.sequence_number
+                     << ": Camera driver flagged the frame as corrupted.";
+    } else {
+        // copy the compressed data out, so that the buffer can go back to the driver right away
+        const auto* data = static_cast<const uint8_t*>(this->buffers[buffer.index].start);
+        size_t bytes_used = buffer.bytes_used;
+        if (bytes_used == 0 || bytes_used > this->buffers[buffer.index].length) {
+            bytes_used = this->buffers[buffer.index].length;
+        }
+        compressed_frame = CompressedFrame{
+            std::vector<uint8_t>(data, data + bytes_used), buffer.timestamp_us, buffer.sequence_number
+        };
+    }
+    MP_RETURN_IF_ERROR(this->RequeueBuffer(buffer.index));
+    return compressed_frame;
+}
+
+bool V4l2StreamingCameraSource::DeliversCompressedFrames() const {
+    return this->pixel_format == V4L2_PIX_FMT_MJPEG || this->pixel_format == V4L2_PIX_FMT_JPEG;
+}
+
+int V4l2StreamingCameraSource::GetDecodeScaleDenominator() const {
+    return this->decode_scale_denominator;
+}
+
+absl::StatusOr<std::optional<V4l2StreamingCameraSource::CompressedFrame>>
+V4l2StreamingCameraSource::ReadCompressedFrame() {
+    if (!this->streaming) {
+        return absl::UnavailableError("Camera is not streaming.");
+    }
+    if (!this->DeliversCompressedFrames()) {
+        return absl::FailedPreconditionError("Camera doesn't deliver compressed frames.");
+    }
+    MP_ASSIGN_OR_RETURN(std::optional<DequeuedBuffer> buffer, this->DequeueBuffer(0));
+    if (!buffer.has_value()) {
+        return std::nullopt;
+    }
+    this->frame_timestamp_us = buffer->timestamp_us;
+    this->frame_sequence_number = buffer->sequence_number;
+    // the driver buffer gets handed right back
+    this->frame_buffer_index = -1;
+    return this->TakeCompressedFrame(*buffer);
+}
+
+void V4l2StreamingCameraSource::ResetDecodePool() {
+    this->decode_pool = std::make_unique<mjpeg::OrderedMjpegDecodePool>(
+        this->decode_thread_count, this->decode_scale_denominator,
+        this->output_pixel_format == PixelFormat::RGB ? mjpeg::DecodedPixelOrder::RGB : mjpeg::DecodedPixelOrder::BGR
+    );
+}
+
+absl::Status V4l2StreamingCameraSource::ConvertToOutputFormat(
+    const MappedBuffer& buffer,
+    size_t bytes_used,
+    cv::Mat& frame
+) const {
+    auto* data = static_cast<uint8_t*>(buffer.start);
+    if (bytes_used == 0 || bytes_used > buffer.length) {
+        bytes_used = buffer.length;
+    }
+    const size_t step = this->bytes_per_line > 0 ? static_cast<size_t>(this->bytes_per_line) : cv::Mat::AUTO_STEP;
+    switch (this->pixel_format) {
+        case V4L2_PIX_FMT_YUYV:
+        case V4L2_PIX_FMT_UYVY: {
+            if (bytes_used < static_cast<size_t>(this->height) * this->width * 2) {
+                return absl::DataLossError("Incomplete frame.");
+            }
+            cv::Mat packed(this->height, this->width, CV_8UC2, data, step);
+            if (this->output_pixel_format == PixelFormat::YUYV) {
+                // only offered when the driver delivers YUYV
+                packed.copyTo(frame);
+            } else if (this->output_pixel_format == PixelFormat::RGB) {
+                cv::cvtColor(
+                    packed, frame,
+                    this->pixel_format == V4L2_PIX_FMT_YUYV ? cv::COLOR_YUV2RGB_YUYV : cv::COLOR_YUV2RGB_UYVY
+                );
+            } else {
+                cv::cvtColor(
+                    packed, frame,
+                    this->pixel_format == V4L2_PIX_FMT_YUYV ? cv::COLOR_YUV2BGR_YUYV : cv::COLOR_YUV2BGR_UYVY
+                );
+            }
+            break;
+        }
+        case V4L2_PIX_FMT_BGR24:
+        case V4L2_PIX_FMT_RGB24: {
+            if (bytes_used < static_cast<size_t>(this->height) * this->width * 3) {
+                return absl::DataLossError("Incomplete frame.");
+            }
+            cv::Mat packed(this->height, this->width, CV_8UC3, data, step);
+            const PixelFormat packed_pixel_format =
+                this->pixel_format == V4L2_PIX_FMT_RGB24 ? PixelFormat::RGB : PixelFormat::BGR;
+            if (packed_pixel_format == this->output_pixel_format) {
+                packed.copyTo(frame);
+            } else {
+                // the RGB <-> BGR swap is symmetric
+                cv::cvtColor(packed, frame, cv::COLOR_RGB2BGR);
+            }
+            break;
+        }
+        default:
+            return absl::UnimplementedError("Unsupported pixel format: " + PixelFormatToString(this->pixel_format));
+    }
+    return absl::OkStatus();
+}
+
+bool V4l2StreamingCameraSource::SupportsExactFrameTimestamp() const {
+    return true;
+}
+
+int64_t V4l2StreamingCameraSource::GetFrameTimestamp() const {
+    return this->frame_timestamp_us;
+}
+
+uint32_t V4l2StreamingCameraSource::GetFrameSequenceNumber() const {
+    return this->frame_sequence_number;
+}
+
+int64_t V4l2StreamingCameraSource::GetDroppedFrameCount() const {
+    return this->dropped_frame_count;
+}
+
+int V4l2StreamingCameraSource::GetFrameDmaBufFileDescriptor() const {
+    if (this->frame_buffer_index < 0 || this->frame_buffer_index >= static_cast<int>(this->buffers.size())) {
+        return -1;
+    }
+    return this->buffers[this->frame_buffer_index].dmabuf_file_descriptor;
+}
+
+int V4l2StreamingCameraSource::GetFileDescriptor() const {
+    return this->file_descriptor;
+}
+
+int V4l2StreamingCameraSource::GetWidth() {
+    return this->width;
+}
+
+int V4l2StreamingCameraSource::GetHeight() {
+    return this->height;
+}
+
+InputTransformMode V4l2StreamingCameraSource::GetDefaultInputTransformMode() {
+    return InputTransformMode::MirrorHorizontal;
+}
+
+std::vector<PixelFormat> V4l2StreamingCameraSource::GetSupportedPixelFormats() const {
+    switch (this->pixel_format) {
+        case V4L2_PIX_FMT_YUYV:
+            return {PixelFormat::YUYV, PixelFormat::RGB, PixelFormat::BGR};
+        case V4L2_PIX_FMT_BGR24:
+            return {PixelFormat::BGR, PixelFormat::RGB};
+        case V4L2_PIX_FMT_RGB24:
+        case V4L2_PIX_FMT_UYVY:
+        case V4L2_PIX_FMT_MJPEG:
+        case V4L2_PIX_FMT_JPEG:
+            // libjpeg-turbo writes either channel order equally fast
+            return {PixelFormat::RGB, PixelFormat::BGR};
+        default:
+            return {PixelFormat::BGR};
+    }
+}
+
+absl::Status V4l2StreamingCameraSource::SetOutputPixelFormat(PixelFormat pixel_format) {
+    const PixelFormat previous_pixel_format = this->output_pixel_format;
+    MP_RETURN_IF_ERROR(VideoSource::SetOutputPixelFormat(pixel_format));
+    if (this->decode_pool != nullptr && pixel_format != previous_pixel_format) {
+        // the decoders write the channel order directly; frames already in flight are dropped
+        this->ResetDecodePool();
+    }
+    return absl::OkStatus();
+}
+
+// region ========================================= EXPOSURE ===========================================================
+
+absl::StatusOr<int> V4l2StreamingCameraSource::GetControl(uint32_t control_id) const {
+    struct v4l2_control control{};
+    control.id = control_id;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_G_CTRL, &control) == -1) {
+        return absl::UnavailableError("Failed to read camera control" + ErrnoMessage());
+    }
+    return control.value;
+}
+
+absl::Status V4l2StreamingCameraSource::SetControl(uint32_t control_id, int value) {
+    struct v4l2_control control{};
+    control.id = control_id;
+    control.value = value;
+    if (this->device->Ioctl(this->file_descriptor, VIDIOC_S_CTRL, &control) == -1) {
+        return absl::UnavailableError("Failed to set camera control" + ErrnoMessage());
+    }
+    return absl::OkStatus();
+}
+
+bool V4l2StreamingCameraSource::SupportsExposureControls() {
+    return this->exposure_controls_supported;
+}
+
+absl::StatusOr<bool> V4l2StreamingCameraSource::IsAutoExposureOn() {
+    if (!this->exposure_controls_supported) {
+        return absl::UnavailableError(
+            "Failed to retrieve auto exposure mode. The camera does not support auto exposure mode retrieval."
+        );
+    }
+    MP_ASSIGN_OR_RETURN(int auto_exposure_mode, this->GetControl(V4L2_CID_EXPOSURE_AUTO));
+    return auto_exposure_mode == this->auto_exposure_on_value;
+}
+
+absl::Status V4l2StreamingCameraSource::TurnOnAutoExposure() {
+    MP_ASSIGN_OR_RETURN(bool auto_exposure_on, this->IsAutoExposureOn());
+    if (!auto_exposure_on) {
+        MP_RETURN_IF_ERROR(this->SetControl(V4L2_CID_EXPOSURE_AUTO, this->auto_exposure_on_value));
+    }
+    return absl::OkStatus();
+}
+
+absl::Status V4l2StreamingCameraSource::TurnOffAutoExposure() {
+    MP_ASSIGN_OR_RETURN(bool auto_exposure_on, this->IsAutoExposureOn());
+    if (auto_exposure_on) {
+        MP_RETURN_IF_ERROR(this->SetControl(V4L2_CID_EXPOSURE_AUTO, this->auto_exposure_off_value));
+        MP_ASSIGN_OR_RETURN(int current_exposure, this->GetControl(V4L2_CID_EXPOSURE_ABSOLUTE));
+        LOG(INFO) << "Locked exposure at: " << current_exposure;
+    }
+    return absl::OkStatus();
+}
+
+absl::Status V4l2StreamingCameraSource::ToggleAutoExposure() {
+    MP_ASSIGN_OR_RETURN(bool auto_exposure_on, this->IsAutoExposureOn());
+    MP_RETURN_IF_ERROR(this->SetControl(
+        V4L2_CID_EXPOSURE_AUTO, auto_exposure_on ? this->auto_exposure_off_value : this->auto_exposure_on_value
+    ));
+    LOG(INFO) << "Auto exposure: " << (auto_exposure_on ? "off" : "on");
+    return absl::OkStatus();
+}
+
+absl::Status V4l2StreamingCameraSource::IncreaseExposure() {
+    return this->ModifyExposure(this->exposure_step);
+}
+
+absl::Status V4l2StreamingCameraSource::DecreaseExposure() {
+    return this->ModifyExposure(-this->exposure_step);
+}
+
+absl::Status V4l2StreamingCameraSource::ModifyExposure(int by) {
+    if (by == 0) return absl::OkStatus();
+    const std::string action = by > 0 ? "raise" : "lower";
+    MP_ASSIGN_OR_RETURN(bool auto_exposure_on, this->IsAutoExposureOn());
+    if (auto_exposure_on) {
+        LOG(WARNING) << "Unable to change exposure, not in manual exposure mode.";
+        return absl::OkStatus();
+    }
+    MP_ASSIGN_OR_RETURN(int manual_exposure, this->GetControl(V4L2_CID_EXPOSURE_ABSOLUTE));
+    manual_exposure += by;
+    if (this->SetControl(V4L2_CID_EXPOSURE_ABSOLUTE, manual_exposure).ok()) {
+        LOG(INFO) << action << " exposure to: " << manual_exposure;
+    } else {
+        LOG(WARNING) << "Unable to " << action << " exposure to " << manual_exposure
+                     << ", exposure setting not supported or at " << (by > 0 ? "upper" : "lower") << " limit.";
+    }
+    return absl::OkStatus();
+}
+
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::video_source::v4l2
@@ -0,0 +1,179 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/types.h>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+// === local includes (if any) ===
+#include <smartspectra/video_source/video_source.hpp>
+#include <smartspectra/video_source/settings.hpp>
+#include "mjpeg_decoder.hpp"
+
+namespace presage::smartspectra::video_source::v4l2 {
+
+/**
+ * @brief Seam over the kernel calls made by V4l2StreamingCameraSource.
+ *
+ * Mirrors the signatures & error conventions of the corresponding system calls (-1 with errno set on failure,
+ * MAP_FAILED from Mmap), so that a fake device can stand in for a physical camera.
+ */
+class V4l2DeviceInterface {
+public:
+    virtual ~V4l2DeviceInterface() = default;
+    virtual int Open(const std::string& device_path, int flags) = 0;
+    virtual int Close(int file_descriptor) = 0;
+    virtual int Ioctl(int file_descriptor, unsigned long request, void* argument) = 0;
+    virtual void* Mmap(size_t length, int protection, int flags, int file_descriptor, off_t offset) = 0;
+    virtual int Munmap(void* address, size_t length) = 0;
+    /** Wait until the device has a frame ready; returns like poll(2) for a single descriptor. */
+    virtual int WaitForFrame(int file_descriptor, int timeout_ms) = 0;
+    /**
+     * Wait until at least one of several devices has a frame ready; returns like poll(2), with the ready devices flagged
+     * in the revents of their descriptors.
+     */
+    virtual int WaitForFrames(std::vector<struct pollfd>& poll_descriptors, int timeout_ms) = 0;
+};
+
+/** Device interface that forwards to the actual system calls. */
+std::shared_ptr<V4l2DeviceInterface> GetSystemV4l2Device();
+
+/**
+ * @brief Camera source that streams straight from a V4L2 device through memory-mapped driver buffers.
+ *
+ * Uncompressed frames are converted to the output pixel format directly from the dequeued buffer, which is then immediately handed back
+ * to the driver. MJPEG frames are copied out of the buffer and decoded on a small worker pool, in order, downscaled
+ * in the DCT domain when VideoSourceSettings::decode_target_width_px/decode_target_height_px allow it; alternatively,
+ * they can be taken still compressed (ReadCompressedFrame) and decoded elsewhere.
+ * Frame timestamps are the driver's own (CLOCK_MONOTONIC) buffer timestamps, in microseconds, so they reflect the
+ * time of capture rather than the time of retrieval; gaps in the driver's buffer sequence numbers are counted as
+ * dropped frames. Where the driver supports it, every buffer is also exported as a DMABUF file descriptor.
+ * \ingroup video_source
+ */
+class V4l2StreamingCameraSource : public VideoSource {
+public:
+    explicit V4l2StreamingCameraSource(std::shared_ptr<V4l2DeviceInterface> device = GetSystemV4l2Device());
+    ~V4l2StreamingCameraSource() override;
+
+    absl::Status Initialize(const VideoSourceSettings& settings) override;
+    bool SupportsExactFrameTimestamp() const override;
+    int64_t GetFrameTimestamp() const override;
+
+    absl::Status TurnOnAutoExposure() override;
+    absl::Status TurnOffAutoExposure() override;
+    absl::Status ToggleAutoExposure() override;
+    absl::StatusOr<bool> IsAutoExposureOn() override;
+    absl::Status IncreaseExposure() override;
+    absl::Status DecreaseExposure() override;
+    bool SupportsExposureControls() override;
+    InputTransformMode GetDefaultInputTransformMode() override;
+    std::vector<PixelFormat> GetSupportedPixelFormats() const override;
+    absl::Status SetOutputPixelFormat(PixelFormat pixel_format) override;
+
+    int GetWidth() override;
+    int GetHeight() override;
+
+    /** Driver sequence number of the current frame. */
+    uint32_t GetFrameSequenceNumber() const;
+    /** Number of frames the driver skipped (per sequence numbers) since streaming started. */
+    int64_t GetDroppedFrameCount() const;
+    /** DMABUF file descriptor of the buffer holding the current frame, or -1 if buffer export isn't supported. */
+    int GetFrameDmaBufFileDescriptor() const;
+    /** File descriptor of the opened device, e.g. to wait on several cameras at once, or -1 if none is open. */
+    int GetFileDescriptor() const;
+
+    /** A frame as the camera delivered it, still compressed. */
+    struct CompressedFrame {
+        std::vector<uint8_t> data;
+        int64_t timestamp_us = 0;
+        uint32_t sequence_number = 0;
+    };
+    /** Whether the camera delivers compressed (MJPEG) frames. */
+    bool DeliversCompressedFrames() const;
+    /** Scale denominator (see mjpeg::MjpegDecoder::Decode) to decode compressed frames at, for the configured size. */
+    int GetDecodeScaleDenominator() const;
+    /**
+     * Take a compressed frame the driver already has ready, without waiting for one and without decoding it, e.g. so
+     * that a thread serving several cameras can leave decoding to the consumers of the frames. Not to be mixed with
+     * reading frames the usual way.
+     * @return the frame, or std::nullopt if none was ready or the driver flagged it as corrupted
+     */
+    absl::StatusOr<std::optional<CompressedFrame>> ReadCompressedFrame();
+protected:
+    void ProducePreTransformFrame(cv::Mat& frame) override;
+private:
+    struct MappedBuffer {
+        void* start = nullptr;
+        size_t length = 0;
+        int dmabuf_file_descriptor = -1;
+    };
+    struct DequeuedBuffer {
+        uint32_t index;
+        size_t bytes_used;
+        bool corrupted;
+        uint32_t sequence_number;
+        int64_t timestamp_us;
+    };
+
+    absl::Status SetFormat(const VideoSourceSettings& settings);
+    absl::Status SetUpBuffers();
+    void ConfigureExposureControls();
+    /** @return std::nullopt if no frame became ready within the timeout */
+    absl::StatusOr<std::optional<DequeuedBuffer>> DequeueBuffer(int timeout_ms);
+    absl::Status RequeueBuffer(uint32_t buffer_index);
+    /** @return true if a frame was produced, false if the dequeued frame was unusable and got skipped */
+    absl::StatusOr<bool> DequeueAndConvertFrame(cv::Mat& frame);
+    /** @return true if a frame was produced, false if the dequeued frame was unusable and got skipped */
+    absl::StatusOr<bool> DecodeNextFrame(cv::Mat& frame);
+    /**
+     * Copy a dequeued compressed frame out of its buffer & hand the buffer back to the driver.
+     * @return std::nullopt if the driver flagged the frame as corrupted
+     */
+    absl::StatusOr<std::optional<CompressedFrame>> TakeCompressedFrame(const DequeuedBuffer& buffer);
+    void ResetDecodePool();
+    absl::Status ConvertToOutputFormat(const MappedBuffer& buffer, size_t bytes_used, cv::Mat& frame) const;
+    absl::StatusOr<int> GetControl(uint32_t control_id) const;
+    absl::Status SetControl(uint32_t control_id, int value);
+    absl::Status ModifyExposure(int by);
+    void Close();
+
+    std::shared_ptr<V4l2DeviceInterface> device;
+    int file_descriptor = -1;
+    bool streaming = false;
+    std::vector<MappedBuffer> buffers;
+
+    uint32_t pixel_format = 0;
+    int capture_width = -1;
+    int capture_height = -1;
+    // size of the produced frames (differs from capture size if decoding downscales)
+    int width = -1;
+    int height = -1;
+    int bytes_per_line = 0;
+
+    int64_t frame_timestamp_us = 0;
+    uint32_t frame_sequence_number = 0;
+    int frame_buffer_index = -1;
+    bool first_frame_dequeued = false;
+    uint32_t last_dequeued_sequence_number = 0;
+    int64_t dropped_frame_count = 0;
+    std::unique_ptr<mjpeg::OrderedMjpegDecodePool> decode_pool;
+    int decode_scale_denominator = 1;
+    int decode_thread_count = 0;
+
+    bool exposure_controls_supported = false;
+    int auto_exposure_on_value = 0;
+    int auto_exposure_off_value = 0;
+    int exposure_step = 10;
+};
+
+} // namespace presage::smartspectra::video_source::v4l2
@@ -9,6 +9,9 @@
 // === local includes (if any) ===
 #include "factory.hpp"
 #include "camera/capture_video_source.hpp"
+#ifdef __linux__
+#include "camera/v4l2_streaming_source.hpp"
+#endif
 #include "file_stream/file_stream.hpp"
 
 namespace presage::smartspectra::video_source {
@@ -24,6 +27,12 @@ absl::StatusOr<std::unique_ptr<VideoSource>> BuildVideoSource(const VideoSourceS
         }
     } else if (!settings.file_stream_path.empty()) {
         video_source = std::make_unique<file_stream::FileStreamVideoSource>();
+    } else if (settings.v4l2_streaming) {
+#ifdef __linux__
+        video_source = std::make_unique<v4l2::V4l2StreamingCameraSource>();
+#else
+        return absl::UnimplementedError("V4L2 streaming capture is only available on Linux.");
+#endif
     } else {
         video_source = std::make_unique<capture::CaptureCameraSource>();
     }
@@ -0,0 +1,157 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#ifdef __linux__
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "decoded_frame_cache.hpp"
+#include "frame_prefetcher.hpp"
+
+namespace presage::smartspectra::video_source::file_stream {
+
+DecodedFrameCache::~DecodedFrameCache() {
+#ifdef __linux__
+    if (this->spill_mapping != nullptr) {
+        munmap(this->spill_mapping, this->spill_mapping_size);
+    }
+    if (this->spill_file_descriptor != -1) {
+        close(this->spill_file_descriptor);
+    }
+#endif
+}
+
+absl::StatusOr<std::unique_ptr<DecodedFrameCache>> DecodedFrameCache::Build(
+    const std::map<int64_t, std::filesystem::path>& frame_paths,
+    size_t memory_budget_bytes,
+    int decode_thread_count
+) {
+    auto cache = std::unique_ptr<DecodedFrameCache>(new DecodedFrameCache());
+    FramePrefetcher prefetcher(decode_thread_count);
+    const size_t max_frames_in_flight = 2 * static_cast<size_t>(prefetcher.GetWorkerCount());
+    auto next_frame_path = frame_paths.begin();
+    size_t in_memory_frame_capacity = 0;
+    for (size_t i_frame = 0; i_frame < frame_paths.size(); i_frame++) {
+        while (next_frame_path != frame_paths.end() && prefetcher.GetPendingCount() < max_frames_in_flight) {
+            prefetcher.Submit(next_frame_path->first, next_frame_path->second);
+            next_frame_path++;
+        }
+        FramePrefetcher::PrefetchedFrame decoded_frame = prefetcher.Next();
+        const cv::Mat& frame = decoded_frame.frame;
+        if (frame.empty()) {
+            return absl::DataLossError("Could not decode frame file " + decoded_frame.path.string());
+        }
+        if (i_frame == 0) {
+            cache->width = frame.cols;
+            cache->height = frame.rows;
+            cache->type = frame.type();
+            cache->frame_size_bytes = static_cast<size_t>(frame.rows) * frame.cols * frame.elemSize();
+            in_memory_frame_capacity = std::min(frame_paths.size(), memory_budget_bytes / cache->frame_size_bytes);
+            if (in_memory_frame_capacity > 0) {
+                cache->in_memory_frames.reset(new uint8_t[in_memory_frame_capacity * cache->frame_size_bytes]);
+            }
+        } else if (frame.cols != cache->width || frame.rows != cache->height || frame.type() != cache->type) {
+            return absl::InvalidArgumentError(
+                "All frames need to have the same size and type to be cached, but " + decoded_frame.path.string()
+                + " differs from the first frame."
+            );
+        }
+        if (i_frame < in_memory_frame_capacity) {
+            uint8_t* destination = cache->in_memory_frames.get() + i_frame * cache->frame_size_bytes;
+            const size_t row_size_bytes = cache->frame_size_bytes / frame.rows;
+            for (int i_row = 0; i_row < frame.rows; i_row++) {
+                std::memcpy(destination + i_row * row_size_bytes, frame.ptr(i_row), row_size_bytes);
+            }
+            cache->in_memory_frame_count++;
+        } else {
+            MP_RETURN_IF_ERROR(cache->SpillFrame(frame));
+        }
+        cache->timestamps.push_back(decoded_frame.timestamp);
+    }
+    if (cache->GetSpilledFrameCount() > 0) {
+        MP_RETURN_IF_ERROR(cache->MapSpilledFrames());
+    }
+    LOG(INFO) << "Cached " << cache->GetFrameCount() << " decoded frames (" << cache->width << " x " << cache->height
+              << "), " << cache->GetSpilledFrameCount() << " of them spilled to disk.";
+    return cache;
+}
+
+void DecodedFrameCache::CopyFrame(size_t i_frame, cv::Mat& frame) const {
+    const uint8_t* source;
+    if (i_frame < this->in_memory_frame_count) {
+        source = this->in_memory_frames.get() + i_frame * this->frame_size_bytes;
+    } else {
+        source = static_cast<const uint8_t*>(this->spill_mapping) +
+                 (i_frame - this->in_memory_frame_count) * this->frame_size_bytes;
+    }
+    frame.create(this->height, this->width, this->type);
+    const size_t row_size_bytes = this->frame_size_bytes / this->height;
+    for (int i_row = 0; i_row < this->height; i_row++) {
+        std::memcpy(frame.ptr(i_row), source + i_row * row_size_bytes, row_size_bytes);
+    }
+}
+
+absl::Status DecodedFrameCache::SpillFrame(const cv::Mat& frame) {
+#ifdef __linux__
+    if (this->spill_file_descriptor == -1) {
+        std::string spill_file_path = (std::filesystem::temp_directory_path() / "smartspectra_frames_XXXXXX").string();
+        this->spill_file_descriptor = mkstemp(spill_file_path.data());
+        if (this->spill_file_descriptor == -1) {
+            return absl::InternalError(
+                "Could not create a file to spill decoded frames into: " + std::string(std::strerror(errno))
+            );
+        }
+        // the file lives on only as long as the descriptor (and mapping) does
+        unlink(spill_file_path.c_str());
+    }
+    const size_t row_size_bytes = this->frame_size_bytes / frame.rows;
+    for (int i_row = 0; i_row < frame.rows; i_row++) {
+        const uint8_t* row = frame.ptr(i_row);
+        size_t bytes_written = 0;
+        while (bytes_written < row_size_bytes) {
+            ssize_t result = write(this->spill_file_descriptor, row + bytes_written, row_size_bytes - bytes_written);
+            if (result == -1) {
+                if (errno == EINTR) continue;
+                return absl::InternalError("Could not spill decoded frame to disk: " + std::string(std::strerror(errno)));
+            }
+            bytes_written += static_cast<size_t>(result);
+        }
+    }
+    return absl::OkStatus();
+#else
+    return absl::ResourceExhaustedError(
+        "Decoded frames exceed the frame cache memory budget, and spilling them to disk is only supported on Linux."
+    );
+#endif
+}
+
+absl::Status DecodedFrameCache::MapSpilledFrames() {
+#ifdef __linux__
+    this->spill_mapping_size = this->GetSpilledFrameCount() * this->frame_size_bytes;
+    void* mapping = mmap(nullptr, this->spill_mapping_size, PROT_READ, MAP_SHARED, this->spill_file_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        return absl::InternalError("Could not map spilled decoded frames: " + std::string(std::strerror(errno)));
+    }
+    this->spill_mapping = mapping;
+    // frames are replayed in order
+    madvise(this->spill_mapping, this->spill_mapping_size, MADV_SEQUENTIAL);
+    return absl::OkStatus();
+#else
+    return absl::UnimplementedError("Spilled frames can only be mapped on Linux.");
+#endif
+}
+
+} // namespace presage::smartspectra::video_source::file_stream
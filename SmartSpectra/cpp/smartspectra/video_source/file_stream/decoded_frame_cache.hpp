@@ -0,0 +1,75 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::video_source::file_stream {
+
+/**
+ * @brief Decoded frames of a (looped) file stream, packed back to back in raw form.
+ *
+ * Frames are kept in one contiguous in-memory block as long as they fit within the memory budget; the rest spill into
+ * an anonymous (already unlinked) temporary file that is memory-mapped read-only. All frames need to have the same
+ * size and type.
+ */
+class DecodedFrameCache {
+public:
+    ~DecodedFrameCache();
+    DecodedFrameCache(const DecodedFrameCache&) = delete;
+    DecodedFrameCache& operator=(const DecodedFrameCache&) = delete;
+
+    /**
+     * Decode all the given frame files (on decode_thread_count threads) into a new cache.
+     * @param frame_paths frame files by timestamp
+     * @param memory_budget_bytes most memory to take up with frames; frames beyond that get spilled to disk
+     * @param decode_thread_count number of decoding threads, 0 picks one based on hardware concurrency
+     */
+    static absl::StatusOr<std::unique_ptr<DecodedFrameCache>> Build(
+        const std::map<int64_t, std::filesystem::path>& frame_paths,
+        size_t memory_budget_bytes,
+        int decode_thread_count
+    );
+
+    size_t GetFrameCount() const { return this->timestamps.size(); }
+    size_t GetSpilledFrameCount() const { return this->timestamps.size() - this->in_memory_frame_count; }
+    int64_t GetFrameTimestamp(size_t i_frame) const { return this->timestamps[i_frame]; }
+    int GetWidth() const { return this->width; }
+    int GetHeight() const { return this->height; }
+
+    /** Copy the frame with the given index out of the cache, reusing the destination's buffer where possible. */
+    void CopyFrame(size_t i_frame, cv::Mat& frame) const;
+private:
+    DecodedFrameCache() = default;
+
+    absl::Status SpillFrame(const cv::Mat& frame);
+    absl::Status MapSpilledFrames();
+
+    int width = 0;
+    int height = 0;
+    int type = 0;
+    size_t frame_size_bytes = 0;
+    std::vector<int64_t> timestamps;
+
+    std::unique_ptr<uint8_t[]> in_memory_frames;
+    size_t in_memory_frame_count = 0;
+
+    int spill_file_descriptor = -1;
+    void* spill_mapping = nullptr;
+    size_t spill_mapping_size = 0;
+};
+
+} // namespace presage::smartspectra::video_source::file_stream
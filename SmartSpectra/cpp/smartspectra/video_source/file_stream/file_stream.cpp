@@ -4,8 +4,10 @@
 //
 
 // === standard library includes (if any) ===
+#include <algorithm>
 #include <exception>
 #include <filesystem>
+#include <limits>
 #include <map>
 #include <string>
 #include <thread>
@@ -24,6 +26,10 @@ void FileStreamVideoSource::ProducePreTransformFrame(cv::Mat& frame) {
             frame = cv::Mat();
             return;
         }
+        if (this->frame_cache != nullptr) {
+            this->ProduceCachedFrame(frame);
+            return;
+        }
         frame = cv::imread(current_frame_data->second.string(), cv::IMREAD_UNCHANGED);
         auto next_frame_data = std::next(current_frame_data);
         if (next_frame_data == this->loop_frame_filenames.end()) {
@@ -34,81 +40,138 @@ void FileStreamVideoSource::ProducePreTransformFrame(cv::Mat& frame) {
         this->current_frame_timestamp = this->current_frame_data->first;
         std::this_thread::sleep_for(std::chrono::milliseconds(this->retry_delay_ms));
     } else {
-        bool confirmed_next_frame_or_end_of_stream_written = false;
-
-        while (!confirmed_next_frame_or_end_of_stream_written) {
-            std::map<int64_t, std::filesystem::path> file_paths = this->ScanInputDirectory();
-            int64_t latest_frame_present_timestamp = -1;
-            if (file_paths.empty() || (this->current_frame_timestamp == kTimestampNotYetSet && file_paths.size() == 1)) {
-                // folder empty or only the first frame being written, wait and retry
-                std::this_thread::sleep_for(std::chrono::milliseconds(this->retry_delay_ms));
-            } else {
-                latest_frame_present_timestamp = std::prev(file_paths.end())->first;
-                std::map<int64_t, std::filesystem::path>::iterator frame_data_pair;
-
-                if (this->current_frame_timestamp == kTimestampNotYetSet) {
-                    // just began processing, first frame not guaranteed to have 0 timestamp,
-                    // start with first frame found -- so long as there is more than one frame written
-                    frame_data_pair = file_paths.begin();
-                } else {
-                    frame_data_pair = std::next(file_paths.find(this->current_frame_timestamp));
-                }
-
-                if (frame_data_pair != file_paths.end()) {
-                    // If we have frames left, it's safe to assume the current one was written entirely
-                    // and can be read. Likewise for end_of_stream token, which is assumed to have been written after all
-                    // the frames (if any).
-                    if (latest_frame_present_timestamp > frame_data_pair->first || end_of_stream_encountered) {
-                        this->current_frame_timestamp = frame_data_pair->first;
-                        frame = cv::imread(frame_data_pair->second.string(), cv::IMREAD_UNCHANGED);
-                        confirmed_next_frame_or_end_of_stream_written = true;
-                    } else {
-                        // need to wait to read current frame.
-                        std::this_thread::sleep_for(std::chrono::milliseconds(this->retry_delay_ms));
-                    }
-                } else if (end_of_stream_encountered) {
-                    // no more frames left, but end_of_stream token:
-                    // write empty cv::Mat to signify end of stream, erase the token file.
-                    frame = cv::Mat();
-                    // have to max out the current timestamp for erasure to work correctly
-                    this->current_frame_timestamp = std::numeric_limits<int64_t>::max();
-                    if (this->erase_read_files) {
-                        // erase end-of-stream marker for good measure
-                        std::filesystem::remove(this->end_of_stream_path);
-                    }
-                    confirmed_next_frame_or_end_of_stream_written = true;
-                } else {
-                    // no frames or end-of-stream token in folder yet
-                    std::this_thread::sleep_for(std::chrono::milliseconds(this->retry_delay_ms));
-                }
-
+        while (true) {
+            this->PrefetchReadableFrames();
+            if (this->frame_prefetcher->GetPendingCount() > 0) {
+                // decoded frames are delivered in timestamp order
+                FramePrefetcher::PrefetchedFrame prefetched_frame = this->frame_prefetcher->Next();
+                this->current_frame_timestamp = prefetched_frame.timestamp;
+                frame = std::move(prefetched_frame.frame);
+                break;
+            }
+            if (this->frame_index.IsEndOfStreamEncountered()) {
+                // no more frames left, but end_of_stream token:
+                // write empty cv::Mat to signify end of stream, erase the token file.
+                frame = cv::Mat();
+                // have to max out the current timestamp for erasure to work correctly
+                this->current_frame_timestamp = std::numeric_limits<int64_t>::max();
                 if (this->erase_read_files) {
-                    // erase everything up to the current frame
-                    for (auto frame_data_pair = file_paths.begin();
-                         frame_data_pair != file_paths.end() && frame_data_pair->first < this->current_frame_timestamp;
-                         frame_data_pair++) {
-                        std::filesystem::remove(frame_data_pair->second);
-                    }
+                    // erase end-of-stream marker for good measure
+                    std::filesystem::remove(this->end_of_stream_path);
                 }
+                break;
             }
+            // no (complete) next frame or end-of-stream token in folder yet
+            this->frame_index.Update(this->frame_index.IsWatching() ? kWatchTimeoutMs : this->retry_delay_ms);
+        }
+
+        if (this->erase_read_files) {
+            // erase everything up to the current frame; all of it has been decoded already
+            this->frame_prefetcher->EraseInBackground(
+                this->frame_index.ReleaseFramesBefore(this->current_frame_timestamp)
+            );
+        }
+        if (!frame.empty()) {
+            // get the next frames decoding while this one is being processed
+            if (this->frame_index.IsWatching()) {
+                this->frame_index.Update(0);
+            }
+            this->PrefetchReadableFrames();
         }
     }
 }
 
-absl::StatusOr<std::regex> FileStreamVideoSource::BuildFrameFileNameRegex(const std::string& wildcard_filename_mask) {
-    std::regex wildcard_mask_parse("([^0-9]+)?([0-9]+)([^0-9]+)?[.](.+)");
-    std::cmatch match;
-    if (!std::regex_match(wildcard_filename_mask.c_str(), match, wildcard_mask_parse)) {
-        return absl::InvalidArgumentError(
-            "Invalid wildcard filename mask: " + wildcard_filename_mask +
-            ". Expected the filename mask to be in following form: <optional_prefix>0[0...]<optional_postfix>.<extension>"
-        );
+void FileStreamVideoSource::ProduceCachedFrame(cv::Mat& frame) {
+    const size_t frame_count = this->frame_cache->GetFrameCount();
+    if (frame_count == 0) {
+        frame = cv::Mat();
+        return;
+    }
+    if (this->replay_frame_interval.count() > 0) {
+        // keep to a fixed schedule, so that time spent downstream doesn't slow the replay rate
+        auto now = std::chrono::steady_clock::now();
+        if (!this->next_replay_time.has_value()) {
+            this->next_replay_time = now;
+        }
+        std::this_thread::sleep_until(*this->next_replay_time);
+        *this->next_replay_time += this->replay_frame_interval;
+        if (*this->next_replay_time < now) {
+            // fell behind, don't try to catch up in a burst
+            this->next_replay_time = now + this->replay_frame_interval;
+        }
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(this->retry_delay_ms));
+    }
+    this->frame_cache->CopyFrame(this->i_cached_frame, frame);
+    this->current_frame_timestamp = this->frame_cache->GetFrameTimestamp(this->i_cached_frame) +
+                                    this->loop_timestamp_offset;
+    this->i_cached_frame++;
+    if (this->i_cached_frame == frame_count) {
+        // the next pass starts one (average) frame interval after this one ends
+        const int64_t first_timestamp = this->frame_cache->GetFrameTimestamp(0);
+        const int64_t last_timestamp = this->frame_cache->GetFrameTimestamp(frame_count - 1);
+        const int64_t frame_interval =
+            frame_count > 1 ? (last_timestamp - first_timestamp) / static_cast<int64_t>(frame_count - 1) : 33333;
+        this->loop_timestamp_offset += last_timestamp - first_timestamp + frame_interval;
+        this->i_cached_frame = 0;
+    }
+}
+
+void FileStreamVideoSource::PrefetchReadableFrames() {
+    const FrameFileIndex::FrameMap& frame_files = this->frame_index.GetFrames();
+    // first frame not guaranteed to have 0 timestamp, so start with the first frame found
+    for (auto frame_file = frame_files.upper_bound(this->last_prefetched_frame_timestamp);
+         frame_file != frame_files.end() &&
+         this->frame_prefetcher->GetPendingCount() < static_cast<size_t>(this->prefetch_count);
+         frame_file++) {
+        // A frame can be read once its writer is known to have closed it. Otherwise, if we have frames after
+        // it, it's safe to assume it was written entirely. Likewise for end_of_stream token, which is assumed to
+        // have been written after all the frames (if any).
+        if (!frame_file->second.complete && std::next(frame_file) == frame_files.end() &&
+            !this->frame_index.IsEndOfStreamEncountered()) {
+            break;
+        }
+        this->frame_prefetcher->Submit(frame_file->first, frame_file->second.path);
+        this->last_prefetched_frame_timestamp = frame_file->first;
     }
-    std::string prefix = match[1].str();
-    size_t number_of_digits = match[2].str().size();
-    std::string postfix = match[3].str();
-    std::string extension = match[4].str();
-    return std::regex(prefix + "([0-9]{" + std::to_string(number_of_digits) + "})" + postfix + "[.]" + extension);
+}
+
+absl::Status FileStreamVideoSource::Seek(int64_t timestamp) {
+    if (this->loop) {
+        if (this->frame_cache != nullptr) {
+            // binary search for the first cached frame at or past the timestamp (within the current pass)
+            size_t i_first = 0;
+            size_t i_last = this->frame_cache->GetFrameCount();
+            while (i_first < i_last) {
+                size_t i_middle = i_first + (i_last - i_first) / 2;
+                if (this->frame_cache->GetFrameTimestamp(i_middle) + this->loop_timestamp_offset < timestamp) {
+                    i_first = i_middle + 1;
+                } else {
+                    i_last = i_middle;
+                }
+            }
+            if (i_first == this->frame_cache->GetFrameCount()) {
+                return absl::OutOfRangeError("No looped frame at or past timestamp " + std::to_string(timestamp) + ".");
+            }
+            this->i_cached_frame = i_first;
+        } else {
+            auto frame_data = this->loop_frame_filenames.lower_bound(timestamp);
+            if (frame_data == this->loop_frame_filenames.end()) {
+                return absl::OutOfRangeError("No looped frame at or past timestamp " + std::to_string(timestamp) + ".");
+            }
+            this->current_frame_data = frame_data;
+        }
+        return absl::OkStatus();
+    }
+    // drop whatever got queued up for decoding already and resume prefetching from the sought frame
+    while (this->frame_prefetcher->GetPendingCount() > 0) {
+        this->frame_prefetcher->Next();
+    }
+    this->last_prefetched_frame_timestamp = std::max(timestamp, std::numeric_limits<int64_t>::min() + 1) - 1;
+    if (this->erase_read_files) {
+        this->frame_prefetcher->EraseInBackground(this->frame_index.ReleaseFramesBefore(timestamp));
+    }
+    return absl::OkStatus();
 }
 
 bool FileStreamVideoSource::SupportsExactFrameTimestamp() const {
@@ -122,8 +185,8 @@ int64_t FileStreamVideoSource::GetFrameTimestamp() const {
 absl::Status FileStreamVideoSource::Initialize(const VideoSourceSettings& settings) {
     MP_RETURN_IF_ERROR(VideoSource::Initialize(settings));
     MP_ASSIGN_OR_RETURN(
-        this->frame_filename_regex,
-        BuildFrameFileNameRegex(std::filesystem::path(settings.file_stream_path).filename())
+        this->frame_filename_pattern,
+        FrameFileNamePattern::Parse(std::filesystem::path(settings.file_stream_path).filename())
     );
     this->directory = std::filesystem::path(settings.file_stream_path).parent_path();
     this->end_of_stream_filename = settings.end_of_stream_filename;
@@ -139,13 +202,33 @@ absl::Status FileStreamVideoSource::Initialize(const VideoSourceSettings& settin
     if (loop) {
         this->loop_frame_filenames = ScanInputDirectory();
         this->current_frame_data = this->loop_frame_filenames.begin();
-        if (!this->loop_frame_filenames.empty()) {
+        if (settings.loop_cache_decoded_frames) {
+            MP_ASSIGN_OR_RETURN(
+                this->frame_cache,
+                DecodedFrameCache::Build(
+                    this->loop_frame_filenames,
+                    static_cast<size_t>(std::max(settings.loop_cache_memory_budget_mb, 0)) * 1024 * 1024,
+                    settings.decode_thread_count
+                )
+            );
+            if (settings.loop_replay_fps > 0) {
+                this->replay_frame_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(1.0 / settings.loop_replay_fps)
+                );
+            }
+            this->first_frame_width = this->frame_cache->GetWidth();
+            this->first_frame_height = this->frame_cache->GetHeight();
+        } else if (!this->loop_frame_filenames.empty()) {
             first_frame_path = this->loop_frame_filenames.begin()->second;
         }
     } else {
-        auto file_paths = ScanInputDirectory();
-        if (!file_paths.empty()) {
-            first_frame_path = file_paths.begin()->second;
+        MP_RETURN_IF_ERROR(
+            this->frame_index.Start(this->directory, this->frame_filename_pattern, this->end_of_stream_filename)
+        );
+        this->prefetch_count = std::max(settings.file_stream_prefetch_count, 1);
+        this->frame_prefetcher = std::make_unique<FramePrefetcher>(settings.decode_thread_count);
+        if (!this->frame_index.GetFrames().empty()) {
+            first_frame_path = this->frame_index.GetFrames().begin()->second.path;
         }
     }
 
@@ -163,15 +246,16 @@ std::map<int64_t, std::filesystem::path> FileStreamVideoSource::ScanInputDirecto
     // Iterate over files in directory,
     // guarantee frame sorting by frame timestamp & check for end of stream token via map
     for (auto const& entry: std::filesystem::directory_iterator{this->directory}) {
-        std::smatch match;
         std::string filename = entry.path().filename().string();
         if (!this->end_of_stream_encountered && filename == this->end_of_stream_filename) {
             this->end_of_stream_encountered = true;
             continue;
         }
-        if (entry.is_regular_file() && std::regex_match(filename, match, this->frame_filename_regex)) {
-            int64_t i_frame = std::stoll(match[1].str());
-            file_paths[i_frame] = entry.path();
+        if (!entry.is_regular_file()) {
+            continue;
+        }
+        if (std::optional<int64_t> timestamp = this->frame_filename_pattern.Match(filename); timestamp.has_value()) {
+            file_paths[*timestamp] = entry.path();
         }
     }
     return file_paths;
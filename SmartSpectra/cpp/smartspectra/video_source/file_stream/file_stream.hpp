@@ -6,15 +6,21 @@
 #pragma once
 // === standard library includes (if any) ===
 #include <string>
-#include <regex>
 #include <filesystem>
+#include <chrono>
 #include <map>
+#include <memory>
+#include <optional>
 // === third-party includes (if any) ===
 #include <absl/status/statusor.h>
 #include <mediapipe/framework/port/opencv_core_inc.h>
 #include <mediapipe/framework/port/opencv_imgcodecs_inc.h>
 // === local includes (if any) ===
 #include <smartspectra/video_source/video_source.hpp>
+#include "decoded_frame_cache.hpp"
+#include "frame_file_index.hpp"
+#include "frame_file_name_pattern.hpp"
+#include "frame_prefetcher.hpp"
 
 
 namespace presage::smartspectra::video_source::file_stream {
@@ -27,33 +33,53 @@ public:
 
     [[nodiscard]] int64_t GetFrameTimestamp() const override;
 
+    /**
+     * Jump to the first frame file with a timestamp at or past the given one. In loop mode, seeking goes no further
+     * than the current pass. While streaming, frames that have yet to arrive are skipped as well if they are earlier.
+     */
+    absl::Status Seek(int64_t timestamp) override;
+
     int GetWidth() override;
     int GetHeight() override;
 protected:
     void ProducePreTransformFrame(cv::Mat& frame) override;
 private:
     const int64_t kTimestampNotYetSet = -1;
-
-    // static
-    static absl::StatusOr<std::regex> BuildFrameFileNameRegex(const std::string& wildcard_filename_mask);
+    // when watching the directory, changes cut the wait short
+    const int kWatchTimeoutMs = 100;
 
     std::map<int64_t, std::filesystem::path> ScanInputDirectory();
+    /** Queue up decoding of the readable frames following the last one queued, up to prefetch_count at once. */
+    void PrefetchReadableFrames();
+    void ProduceCachedFrame(cv::Mat& frame);
 
     // parameters
-    std::regex frame_filename_regex;
+    FrameFileNamePattern frame_filename_pattern;
     std::filesystem::path directory;
     std::string end_of_stream_filename;
     int retry_delay_ms = 10;
     bool erase_read_files;
     bool loop;
+    int prefetch_count = 1;
 
     // state
     int64_t  i_frame = 0;
     int64_t current_frame_timestamp = kTimestampNotYetSet;
     bool end_of_stream_encountered = false;
+    // only used in streaming (non-loop) mode
+    FrameFileIndex frame_index;
+    std::unique_ptr<FramePrefetcher> frame_prefetcher;
+    int64_t last_prefetched_frame_timestamp = kTimestampNotYetSet;
     // only used in loop mode
     std::map<int64_t, std::filesystem::path> loop_frame_filenames;
     std::map<int64_t, std::filesystem::path>::iterator current_frame_data;
+    // only used in loop mode with decoded frame caching
+    std::unique_ptr<DecodedFrameCache> frame_cache;
+    size_t i_cached_frame = 0;
+    // added to cached frame timestamps, so that they keep increasing across passes
+    int64_t loop_timestamp_offset = 0;
+    std::chrono::steady_clock::duration replay_frame_interval{0};
+    std::optional<std::chrono::steady_clock::time_point> next_replay_time;
     std::filesystem::path end_of_stream_path;
 
     int first_frame_width = -1;
@@ -0,0 +1,173 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <chrono>
+#include <thread>
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+// === local includes (if any) ===
+#include "frame_file_index.hpp"
+
+namespace presage::smartspectra::video_source::file_stream {
+
+FrameFileIndex::~FrameFileIndex() {
+    this->StopWatching();
+}
+
+absl::Status FrameFileIndex::Start(
+    const std::filesystem::path& directory,
+    const FrameFileNamePattern& frame_filename_pattern,
+    const std::string& end_of_stream_filename
+) {
+    this->StopWatching();
+    this->directory = directory;
+    this->frame_filename_pattern = frame_filename_pattern;
+    this->end_of_stream_filename = end_of_stream_filename;
+    this->frames.clear();
+    this->end_of_stream_encountered = false;
+#ifdef __linux__
+    this->inotify_file_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->inotify_file_descriptor != -1) {
+        this->watch_descriptor = inotify_add_watch(
+            this->inotify_file_descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE
+        );
+        if (this->watch_descriptor == -1) {
+            this->StopWatching();
+        }
+    }
+    if (this->inotify_file_descriptor == -1) {
+        LOG(WARNING) << "Could not watch " << directory.string() << " for new frames (" << std::strerror(errno)
+                     << "), falling back to rescanning it.";
+    }
+#endif
+    // the watch is set up first, so that no file written in the meantime gets missed
+    this->Rescan();
+    return absl::OkStatus();
+}
+
+void FrameFileIndex::Update(int timeout_ms) {
+#ifdef __linux__
+    if (this->inotify_file_descriptor != -1) {
+        struct pollfd poll_descriptor{this->inotify_file_descriptor, POLLIN, 0};
+        if (poll(&poll_descriptor, 1, timeout_ms) > 0) {
+            this->ApplyEvents();
+        }
+        return;
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    this->Rescan();
+}
+
+std::vector<std::filesystem::path> FrameFileIndex::ReleaseFramesBefore(int64_t timestamp) {
+    std::vector<std::filesystem::path> paths;
+    auto end = this->frames.lower_bound(timestamp);
+    for (auto frame = this->frames.begin(); frame != end; frame++) {
+        paths.push_back(std::move(frame->second.path));
+    }
+    this->frames.erase(this->frames.begin(), end);
+    return paths;
+}
+
+void FrameFileIndex::Rescan() {
+    FrameMap previous_frames;
+    previous_frames.swap(this->frames);
+    std::error_code error_code;
+    for (auto const& entry: std::filesystem::directory_iterator{this->directory, error_code}) {
+        // files may vanish while iterating
+        std::error_code entry_error_code;
+        if (entry.is_regular_file(entry_error_code)) {
+            this->Add(entry.path().filename().string(), /*complete=*/false);
+        }
+    }
+    // keep what was already known about the files that are still there
+    for (auto& [timestamp, frame_file]: this->frames) {
+        auto previous_frame = previous_frames.find(timestamp);
+        if (previous_frame != previous_frames.end() && previous_frame->second.path == frame_file.path) {
+            frame_file.complete = previous_frame->second.complete;
+        }
+    }
+}
+
+void FrameFileIndex::ApplyEvents() {
+#ifdef __linux__
+    alignas(struct inotify_event) char buffer[16 * 1024];
+    while (true) {
+        ssize_t length = read(this->inotify_file_descriptor, buffer, sizeof(buffer));
+        if (length <= 0) {
+            if (length == -1 && errno == EINTR) continue;
+            // EAGAIN: all pending events consumed
+            break;
+        }
+        for (ssize_t offset = 0; offset < length;) {
+            const auto* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+            offset += static_cast<ssize_t>(sizeof(struct inotify_event) + event->len);
+            if (event->mask & IN_Q_OVERFLOW) {
+                LOG(WARNING) << "Missed changes in " << this->directory.string() << ", rescanning it.";
+                this->Rescan();
+            } else if (event->mask & IN_IGNORED) {
+                // the directory itself went away or got unmounted
+                LOG(WARNING) << "Lost the watch on " << this->directory.string() << ", falling back to rescanning it.";
+                this->StopWatching();
+                this->Rescan();
+                return;
+            } else if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO)) {
+                    this->Add(event->name, /*complete=*/true);
+                } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    this->Remove(event->name);
+                }
+            }
+        }
+    }
+#endif
+}
+
+void FrameFileIndex::Add(const std::string& filename, bool complete) {
+    if (filename == this->end_of_stream_filename) {
+        this->end_of_stream_encountered = true;
+        return;
+    }
+    std::optional<int64_t> timestamp = this->frame_filename_pattern.Match(filename);
+    if (!timestamp.has_value()) {
+        return;
+    }
+    FrameFile& frame_file = this->frames[*timestamp];
+    frame_file.path = this->directory / filename;
+    frame_file.complete = frame_file.complete || complete;
+}
+
+void FrameFileIndex::Remove(const std::string& filename) {
+    // the end-of-stream token stays "encountered" even once erased
+    std::optional<int64_t> timestamp = this->frame_filename_pattern.Match(filename);
+    if (!timestamp.has_value()) {
+        return;
+    }
+    auto frame = this->frames.find(*timestamp);
+    if (frame != this->frames.end() && frame->second.path.filename() == filename) {
+        this->frames.erase(frame);
+    }
+}
+
+void FrameFileIndex::StopWatching() {
+#ifdef __linux__
+    if (this->inotify_file_descriptor != -1) {
+        close(this->inotify_file_descriptor);
+    }
+#endif
+    this->inotify_file_descriptor = -1;
+    this->watch_descriptor = -1;
+}
+
+} // namespace presage::smartspectra::video_source::file_stream
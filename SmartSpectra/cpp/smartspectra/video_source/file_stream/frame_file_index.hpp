@@ -0,0 +1,88 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/status.h>
+// === local includes (if any) ===
+#include "frame_file_name_pattern.hpp"
+
+namespace presage::smartspectra::video_source::file_stream {
+
+/**
+ * @brief Ordered index of the frame files (and end-of-stream token) in a file stream directory.
+ *
+ * On Linux, the index is kept current incrementally through inotify: a frame is added once the writer closes it
+ * (IN_CLOSE_WRITE) or moves it into the directory (IN_MOVED_TO), so that it can be read right away, and removed when it
+ * gets deleted or moved out. Elsewhere, or if inotify is unavailable, the directory is rescanned on every update.
+ */
+class FrameFileIndex {
+public:
+    struct FrameFile {
+        std::filesystem::path path;
+        // true if the file is known to be completely written
+        bool complete = false;
+    };
+    using FrameMap = std::map<int64_t, FrameFile>;
+
+    FrameFileIndex() = default;
+    ~FrameFileIndex();
+    FrameFileIndex(const FrameFileIndex&) = delete;
+    FrameFileIndex& operator=(const FrameFileIndex&) = delete;
+
+    /**
+     * Start watching the directory (if possible) and index the files already present in it.
+     */
+    absl::Status Start(
+        const std::filesystem::path& directory,
+        const FrameFileNamePattern& frame_filename_pattern,
+        const std::string& end_of_stream_filename
+    );
+
+    /**
+     * Bring the index up to date, waiting up to timeout_ms for the directory to change if it hasn't yet.
+     * @param timeout_ms longest wait for a change when watching, delay before the rescan otherwise
+     */
+    void Update(int timeout_ms);
+
+    const FrameMap& GetFrames() const { return this->frames; }
+
+    bool IsEndOfStreamEncountered() const { return this->end_of_stream_encountered; }
+
+    /** True if the directory is watched for changes, false if it has to be rescanned. */
+    bool IsWatching() const { return this->inotify_file_descriptor != -1; }
+
+    /**
+     * Drop all frames with timestamps below the given one from the index.
+     * @return paths of the dropped frame files
+     */
+    std::vector<std::filesystem::path> ReleaseFramesBefore(int64_t timestamp);
+
+private:
+    void Rescan();
+    void ApplyEvents();
+    void Add(const std::string& filename, bool complete);
+    void Remove(const std::string& filename);
+    void StopWatching();
+
+    std::filesystem::path directory;
+    FrameFileNamePattern frame_filename_pattern;
+    std::string end_of_stream_filename;
+
+    FrameMap frames;
+    bool end_of_stream_encountered = false;
+
+    int inotify_file_descriptor = -1;
+    int watch_descriptor = -1;
+};
+
+} // namespace presage::smartspectra::video_source::file_stream
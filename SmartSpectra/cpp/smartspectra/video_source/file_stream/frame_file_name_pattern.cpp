@@ -0,0 +1,55 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <charconv>
+#include <regex>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "frame_file_name_pattern.hpp"
+
+namespace presage::smartspectra::video_source::file_stream {
+
+absl::StatusOr<FrameFileNamePattern> FrameFileNamePattern::Parse(const std::string& wildcard_filename_mask) {
+    std::regex wildcard_mask_parse("([^0-9]+)?([0-9]+)([^0-9]+)?[.](.+)");
+    std::cmatch match;
+    if (!std::regex_match(wildcard_filename_mask.c_str(), match, wildcard_mask_parse)) {
+        return absl::InvalidArgumentError(
+            "Invalid wildcard filename mask: " + wildcard_filename_mask +
+            ". Expected the filename mask to be in following form: <optional_prefix>0[0...]<optional_postfix>.<extension>"
+        );
+    }
+    FrameFileNamePattern pattern;
+    pattern.prefix = match[1].str();
+    pattern.digit_count = match[2].str().size();
+    pattern.suffix = match[3].str() + "." + match[4].str();
+    return pattern;
+}
+
+std::optional<int64_t> FrameFileNamePattern::Match(std::string_view filename) const {
+    if (this->digit_count == 0 ||
+        filename.size() != this->prefix.size() + this->digit_count + this->suffix.size() ||
+        filename.compare(0, this->prefix.size(), this->prefix) != 0 ||
+        filename.compare(filename.size() - this->suffix.size(), this->suffix.size(), this->suffix) != 0) {
+        return std::nullopt;
+    }
+    const char* digits_begin = filename.data() + this->prefix.size();
+    const char* digits_end = digits_begin + this->digit_count;
+    for (const char* digit = digits_begin; digit != digits_end; digit++) {
+        if (*digit < '0' || *digit > '9') {
+            return std::nullopt;
+        }
+    }
+    int64_t timestamp;
+    auto [parse_end, error] = std::from_chars(digits_begin, digits_end, timestamp);
+    if (error != std::errc() || parse_end != digits_end) {
+        // e.g. too many digits to fit
+        return std::nullopt;
+    }
+    return timestamp;
+}
+
+} // namespace presage::smartspectra::video_source::file_stream
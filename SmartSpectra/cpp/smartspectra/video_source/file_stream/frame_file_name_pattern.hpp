@@ -0,0 +1,43 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::video_source::file_stream {
+
+/**
+ * @brief Matches frame file names of the form <prefix><fixed-width timestamp><postfix>.<extension> and extracts the
+ * timestamp, without going through a regex.
+ */
+class FrameFileNamePattern {
+public:
+    FrameFileNamePattern() = default;
+
+    /**
+     * Build the pattern from a wildcard file name mask, e.g. "frame0000000000000.png", where the zero padding
+     * determines the digit count.
+     */
+    static absl::StatusOr<FrameFileNamePattern> Parse(const std::string& wildcard_filename_mask);
+
+    /** @return the frame timestamp if the file name fits the pattern, std::nullopt otherwise */
+    std::optional<int64_t> Match(std::string_view filename) const;
+private:
+    std::string prefix;
+    size_t digit_count = 0;
+    // postfix, dot & extension
+    std::string suffix;
+};
+
+} // namespace presage::smartspectra::video_source::file_stream
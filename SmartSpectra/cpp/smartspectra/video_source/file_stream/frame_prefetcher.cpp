@@ -0,0 +1,118 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/opencv_imgcodecs_inc.h>
+// === local includes (if any) ===
+#include "frame_prefetcher.hpp"
+
+namespace presage::smartspectra::video_source::file_stream {
+
+FramePrefetcher::FramePrefetcher(int worker_count) {
+    if (worker_count <= 0) {
+        // leave most cores to the graph
+        worker_count = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) / 4, 1, 3);
+    }
+    this->worker_threads.reserve(worker_count);
+    for (int i_worker = 0; i_worker < worker_count; i_worker++) {
+        this->worker_threads.emplace_back(&FramePrefetcher::RunWorker, this);
+    }
+}
+
+FramePrefetcher::~FramePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->work_available.notify_all();
+    for (auto& worker_thread: this->worker_threads) {
+        worker_thread.join();
+    }
+}
+
+void FramePrefetcher::Submit(int64_t timestamp, std::filesystem::path path) {
+    auto job = std::make_shared<Job>();
+    job->result.timestamp = timestamp;
+    job->result.path = std::move(path);
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->jobs.push_back(std::move(job));
+    }
+    this->work_available.notify_one();
+}
+
+FramePrefetcher::PrefetchedFrame FramePrefetcher::Next() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    if (this->jobs.empty()) {
+        return {};
+    }
+    std::shared_ptr<Job> job = this->jobs.front();
+    this->job_done.wait(lock, [&job] { return job->done; });
+    this->jobs.pop_front();
+    return std::move(job->result);
+}
+
+size_t FramePrefetcher::GetPendingCount() const {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->jobs.size();
+}
+
+void FramePrefetcher::EraseInBackground(std::vector<std::filesystem::path> paths) {
+    if (paths.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->paths_to_erase.insert(
+            this->paths_to_erase.end(), std::make_move_iterator(paths.begin()), std::make_move_iterator(paths.end())
+        );
+    }
+    this->work_available.notify_one();
+}
+
+void FramePrefetcher::RunWorker() {
+    while (true) {
+        std::shared_ptr<Job> job;
+        std::vector<std::filesystem::path> paths;
+        {
+            std::unique_lock<std::mutex> lock(this->mutex);
+            this->work_available.wait(lock, [this, &job] {
+                for (const auto& pending_job: this->jobs) {
+                    if (!pending_job->claimed) {
+                        job = pending_job;
+                        return true;
+                    }
+                }
+                return !this->paths_to_erase.empty() || this->stopping;
+            });
+            if (job != nullptr) {
+                // decoding takes precedence over erasure
+                job->claimed = true;
+            } else if (!this->paths_to_erase.empty()) {
+                paths.swap(this->paths_to_erase);
+            } else {
+                return;
+            }
+        }
+        if (job != nullptr) {
+            job->result.frame = cv::imread(job->result.path.string(), cv::IMREAD_UNCHANGED);
+            {
+                std::lock_guard<std::mutex> lock(this->mutex);
+                job->done = true;
+            }
+            this->job_done.notify_all();
+        } else {
+            for (const auto& path: paths) {
+                std::error_code error_code;
+                std::filesystem::remove(path, error_code);
+            }
+        }
+    }
+}
+
+} // namespace presage::smartspectra::video_source::file_stream
@@ -0,0 +1,76 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+
+namespace presage::smartspectra::video_source::file_stream {
+
+/**
+ * @brief Decodes frame image files ahead of time on a small pool of worker threads, delivering them in submission
+ * order. The same workers delete files that have been read in, whenever they have no decoding to do.
+ */
+class FramePrefetcher {
+public:
+    struct PrefetchedFrame {
+        int64_t timestamp = 0;
+        std::filesystem::path path;
+        // empty if the file couldn't be decoded
+        cv::Mat frame;
+    };
+
+    /**
+     * @param worker_count number of decoding threads, 0 picks one based on hardware concurrency
+     */
+    explicit FramePrefetcher(int worker_count);
+    /** Waits for any requested file erasure to finish. */
+    ~FramePrefetcher();
+    FramePrefetcher(const FramePrefetcher&) = delete;
+    FramePrefetcher& operator=(const FramePrefetcher&) = delete;
+
+    void Submit(int64_t timestamp, std::filesystem::path path);
+
+    /** Block until the oldest submitted frame is decoded and return it. Requires a pending frame. */
+    PrefetchedFrame Next();
+
+    /** Frames submitted, but not yet retrieved with Next(). */
+    size_t GetPendingCount() const;
+
+    /** Delete the given files in the background. Their frames must have been retrieved already. */
+    void EraseInBackground(std::vector<std::filesystem::path> paths);
+
+    int GetWorkerCount() const { return static_cast<int>(this->worker_threads.size()); }
+private:
+    struct Job {
+        PrefetchedFrame result;
+        bool claimed = false;
+        bool done = false;
+    };
+
+    void RunWorker();
+
+    mutable std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable job_done;
+    // in submission order; workers claim the oldest unclaimed job, Next() pops from the front
+    std::deque<std::shared_ptr<Job>> jobs;
+    std::vector<std::filesystem::path> paths_to_erase;
+    bool stopping = false;
+    std::vector<std::thread> worker_threads;
+};
+
+} // namespace presage::smartspectra::video_source::file_stream
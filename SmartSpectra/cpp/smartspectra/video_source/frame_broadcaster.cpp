@@ -0,0 +1,298 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/logging.h>
+#include <mediapipe/framework/port/status_macros.h>
+// === local includes (if any) ===
+#include "frame_broadcaster.hpp"
+#include "factory.hpp"
+#include "input_transform_kernels.hpp"
+
+namespace presage::smartspectra::video_source {
+
+// region ========================================= CONSUMER ===========================================================
+class FrameBroadcaster::Consumer : public VideoSource {
+public:
+    Consumer(FrameBroadcaster& broadcaster, std::shared_ptr<ConsumerQueue> queue)
+        : broadcaster(broadcaster), queue(std::move(queue)) {
+        // frames arrive transformed & converted already
+        this->output_pixel_format = PixelFormat::RGB;
+    }
+
+    ~Consumer() override {
+        this->broadcaster.CloseConsumer(*this->queue);
+    }
+
+    bool SupportsExactFrameTimestamp() const override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->SupportsExactFrameTimestamp();
+    }
+
+    int64_t GetFrameTimestamp() const override {
+        return this->frame_timestamp_us;
+    }
+
+    absl::Status TurnOnAutoExposure() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->TurnOnAutoExposure();
+    }
+
+    absl::Status TurnOffAutoExposure() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->TurnOffAutoExposure();
+    }
+
+    absl::Status ToggleAutoExposure() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->ToggleAutoExposure();
+    }
+
+    absl::StatusOr<bool> IsAutoExposureOn() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->IsAutoExposureOn();
+    }
+
+    absl::Status IncreaseExposure() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->IncreaseExposure();
+    }
+
+    absl::Status DecreaseExposure() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->DecreaseExposure();
+    }
+
+    bool SupportsExposureControls() override {
+        std::lock_guard<std::mutex> lock(this->broadcaster.source_mutex);
+        return this->broadcaster.source->SupportsExposureControls();
+    }
+
+    int GetWidth() override {
+        return this->broadcaster.frame_size.width;
+    }
+
+    int GetHeight() override {
+        return this->broadcaster.frame_size.height;
+    }
+
+    std::vector<PixelFormat> GetSupportedPixelFormats() const override {
+        return {PixelFormat::RGB};
+    }
+
+protected:
+    void ProducePreTransformFrame(cv::Mat& frame) override {
+        this->broadcaster.StartCapture();
+        BroadcastFrame broadcast_frame = this->broadcaster.WaitForFrame(*this->queue);
+        // shares the buffer with the other consumers
+        frame = broadcast_frame.frame;
+        this->frame_timestamp_us = broadcast_frame.timestamp_us;
+    }
+
+private:
+    FrameBroadcaster& broadcaster;
+    std::shared_ptr<ConsumerQueue> queue;
+    int64_t frame_timestamp_us = 0;
+};
+// endregion ===========================================================================================================
+// region ========================================= BROADCASTER ========================================================
+FrameBroadcaster::~FrameBroadcaster() {
+    this->Stop();
+}
+
+absl::Status FrameBroadcaster::Initialize(const VideoSourceSettings& settings, int consumer_queue_capacity) {
+    // before building the new source, which may well need the camera the previous one still has open
+    MP_RETURN_IF_ERROR(this->PrepareForInitialization(consumer_queue_capacity));
+    if (!settings.input_video_path.empty() || !settings.file_stream_path.empty()) {
+        LOG(WARNING) << "Consumers of a broadcast video file or file stream drop frames whenever they fall behind.";
+    }
+    MP_ASSIGN_OR_RETURN(std::unique_ptr<VideoSource> source, BuildVideoSource(settings));
+    return this->Initialize(std::move(source), consumer_queue_capacity);
+}
+
+absl::Status FrameBroadcaster::Initialize(std::unique_ptr<VideoSource> source, int consumer_queue_capacity) {
+    MP_RETURN_IF_ERROR(this->PrepareForInitialization(consumer_queue_capacity));
+    if (source == nullptr) {
+        return absl::InvalidArgumentError("The frame broadcaster needs a video source.");
+    }
+    this->consumer_queue_capacity = static_cast<size_t>(consumer_queue_capacity);
+
+    std::lock_guard<std::mutex> lock(this->source_mutex);
+    this->source = std::move(source);
+    // where the source can produce RGB itself, frames only need to be transformed (if at all) before going out
+    auto supported_pixel_formats = this->source->GetSupportedPixelFormats();
+    if (std::find(supported_pixel_formats.begin(), supported_pixel_formats.end(), PixelFormat::RGB) !=
+        supported_pixel_formats.end()) {
+        MP_RETURN_IF_ERROR(this->source->SetOutputPixelFormat(PixelFormat::RGB));
+    } else if (this->source->GetOutputPixelFormat() != PixelFormat::BGR) {
+        MP_RETURN_IF_ERROR(this->source->SetOutputPixelFormat(PixelFormat::BGR));
+    }
+    this->source_is_bgr = this->source->GetOutputPixelFormat() == PixelFormat::BGR;
+    this->input_transform = this->source->GetInputTransformMode();
+    if (this->source->HasFrameDimensions()) {
+        this->frame_size = GetTransformedFrameSize(
+            cv::Size(this->source->GetWidth(), this->source->GetHeight()), this->input_transform
+        );
+    } else {
+        this->frame_size = cv::Size(-1, -1);
+    }
+    return absl::OkStatus();
+}
+
+absl::Status FrameBroadcaster::PrepareForInitialization(int consumer_queue_capacity) {
+    if (consumer_queue_capacity < 1) {
+        return absl::InvalidArgumentError("Consumer queue capacity must be positive.");
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->consumer_mutex);
+        if (!this->consumer_queues.empty()) {
+            return absl::FailedPreconditionError(
+                "The frame broadcaster still has consumers, which would never get another frame if it were "
+                "initialized again."
+            );
+        }
+    }
+    this->Stop();
+    {
+        std::lock_guard<std::mutex> lock(this->source_mutex);
+        this->source = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->consumer_mutex);
+        this->capture_started = false;
+        this->capture_finished = false;
+    }
+    this->captured_frame_count = 0;
+    return absl::OkStatus();
+}
+
+absl::StatusOr<std::unique_ptr<VideoSource>> FrameBroadcaster::AddConsumer() {
+    if (this->source == nullptr) {
+        return absl::FailedPreconditionError("The frame broadcaster needs to be initialized before adding consumers.");
+    }
+    auto queue = std::make_shared<ConsumerQueue>();
+    {
+        std::lock_guard<std::mutex> lock(this->consumer_mutex);
+        this->consumer_queues.push_back(queue);
+    }
+    return std::make_unique<Consumer>(*this, std::move(queue));
+}
+
+void FrameBroadcaster::Stop() {
+    {
+        // no (re)starting capture past this point
+        std::lock_guard<std::mutex> lock(this->consumer_mutex);
+        this->capture_started = true;
+    }
+    this->keep_capturing = false;
+    if (this->capture_thread.joinable()) {
+        this->capture_thread.join();
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->consumer_mutex);
+        this->capture_finished = true;
+    }
+    this->frame_ready.notify_all();
+}
+
+int64_t FrameBroadcaster::GetCapturedFrameCount() const {
+    return this->captured_frame_count;
+}
+
+size_t FrameBroadcaster::GetConsumerCount() const {
+    std::lock_guard<std::mutex> lock(this->consumer_mutex);
+    return this->consumer_queues.size();
+}
+
+void FrameBroadcaster::StartCapture() {
+    std::lock_guard<std::mutex> lock(this->consumer_mutex);
+    if (this->capture_started) {
+        return;
+    }
+    this->capture_started = true;
+    this->keep_capturing = true;
+    this->capture_thread = std::thread(&FrameBroadcaster::RunCapture, this);
+}
+
+void FrameBroadcaster::RunCapture() {
+    while (this->keep_capturing) {
+        auto broadcast_frame = this->CaptureFrame();
+        if (!broadcast_frame.ok()) {
+            LOG(ERROR) << "Stopping frame broadcast: " << broadcast_frame.status().message();
+            break;
+        }
+        if (broadcast_frame->frame.empty()) {
+            break;
+        }
+        this->captured_frame_count++;
+        {
+            std::lock_guard<std::mutex> lock(this->consumer_mutex);
+            for (auto& queue: this->consumer_queues) {
+                queue->frames.push_back(*broadcast_frame);
+                if (queue->frames.size() > this->consumer_queue_capacity) {
+                    // this consumer is falling behind, which mustn't hold up capture or the others
+                    queue->frames.pop_front();
+                }
+            }
+        }
+        this->frame_ready.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->consumer_mutex);
+        this->capture_finished = true;
+    }
+    this->frame_ready.notify_all();
+}
+
+absl::StatusOr<FrameBroadcaster::BroadcastFrame> FrameBroadcaster::CaptureFrame() {
+    BroadcastFrame broadcast_frame;
+    cv::Mat captured_frame;
+    {
+        std::lock_guard<std::mutex> lock(this->source_mutex);
+        this->source->ReadPreTransformFrame(captured_frame);
+        broadcast_frame.timestamp_us = this->source->GetFrameTimestamp();
+    }
+    if (captured_frame.empty()) {
+        // end of stream
+        return broadcast_frame;
+    }
+    if (!this->source_is_bgr && this->input_transform == InputTransformMode::None) {
+        broadcast_frame.frame = captured_frame;
+        return broadcast_frame;
+    }
+    // a fresh buffer for every frame, since consumers may hold on to earlier ones for a while
+    cv::Size transformed_size = GetTransformedFrameSize(captured_frame.size(), this->input_transform);
+    broadcast_frame.frame.create(transformed_size.height, transformed_size.width, CV_8UC3);
+    MP_RETURN_IF_ERROR(TransformAndSwizzleFrame(
+        captured_frame, this->input_transform, this->source_is_bgr, broadcast_frame.frame
+    ));
+    return broadcast_frame;
+}
+
+FrameBroadcaster::BroadcastFrame FrameBroadcaster::WaitForFrame(ConsumerQueue& queue) {
+    std::unique_lock<std::mutex> lock(this->consumer_mutex);
+    this->frame_ready.wait(lock, [this, &queue] {
+        return !queue.frames.empty() || this->capture_finished;
+    });
+    if (queue.frames.empty()) {
+        return {};
+    }
+    BroadcastFrame broadcast_frame = std::move(queue.frames.front());
+    queue.frames.pop_front();
+    return broadcast_frame;
+}
+
+void FrameBroadcaster::CloseConsumer(const ConsumerQueue& queue) {
+    std::lock_guard<std::mutex> lock(this->consumer_mutex);
+    std::erase_if(this->consumer_queues, [&queue](const std::shared_ptr<ConsumerQueue>& consumer_queue) {
+        return consumer_queue.get() == &queue;
+    });
+}
+// endregion ===========================================================================================================
+
+} // namespace presage::smartspectra::video_source
@@ -0,0 +1,113 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/statusor.h>
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+#include "video_source.hpp"
+#include "settings.hpp"
+
+namespace presage::smartspectra::video_source {
+
+/**
+ * @brief Captures from a single video source on behalf of several consumers, e.g. a spot and a continuous container
+ * running off the same camera, which can only be opened once.
+ *
+ * Every frame is captured, transformed and converted to RGB once, into a buffer that all consumers share (by
+ * reference count) and must treat as read-only. Consumers are VideoSource instances producing those RGB frames, which
+ * containers hand to their graphs without copying (see ForegroundContainer::SetVideoSource).
+ *
+ * Each consumer has its own queue: one that falls behind drops its oldest frames, without holding up capture or the
+ * other consumers. Hence, the broadcaster is meant for live cameras rather than for video files, where every frame
+ * should be processed. Exposure controls act on the shared source, i.e. on behalf of all consumers at once.
+ * \ingroup video_source
+ */
+class FrameBroadcaster {
+public:
+    FrameBroadcaster() = default;
+    ~FrameBroadcaster();
+    FrameBroadcaster(const FrameBroadcaster&) = delete;
+    FrameBroadcaster& operator=(const FrameBroadcaster&) = delete;
+
+    /**
+     * Build the shared video source from the provided settings. A broadcaster can only be initialized again once all
+     * consumers of its previous source are gone.
+     * @param consumer_queue_capacity frames waiting for each consumer at most; the oldest get dropped beyond that
+     */
+    absl::Status Initialize(const VideoSourceSettings& settings, int consumer_queue_capacity = 2);
+    /** Broadcast from an already initialized video source instead. */
+    absl::Status Initialize(std::unique_ptr<VideoSource> source, int consumer_queue_capacity = 2);
+
+    /**
+     * Add a consumer, which receives every frame captured from then on (capture starts with the first frame any
+     * consumer asks for). Consumers must not outlive the broadcaster.
+     */
+    absl::StatusOr<std::unique_ptr<VideoSource>> AddConsumer();
+
+    /** Stop capturing; consumers produce no more frames once they've run out of already captured ones. */
+    void Stop();
+
+    /** Number of frames captured from the shared source so far. */
+    int64_t GetCapturedFrameCount() const;
+    /** Number of consumers currently registered. */
+    size_t GetConsumerCount() const;
+private:
+    class Consumer;
+
+    struct BroadcastFrame {
+        // shared by all consumers, never written to after capture
+        cv::Mat frame;
+        int64_t timestamp_us = 0;
+    };
+
+    struct ConsumerQueue {
+        std::deque<BroadcastFrame> frames;
+    };
+
+    /** Stop capture and let go of the previous source, unless it still has consumers. */
+    absl::Status PrepareForInitialization(int consumer_queue_capacity);
+    /** Start the capture thread, unless it's already running (or has already finished). */
+    void StartCapture();
+    /** Capture thread: grab frames from the shared source, convert them once and hand them to every consumer. */
+    void RunCapture();
+    absl::StatusOr<BroadcastFrame> CaptureFrame();
+    /** @return the next frame for the given consumer, or an empty frame once capture has ended */
+    BroadcastFrame WaitForFrame(ConsumerQueue& queue);
+    /** Unregister the consumer of the given queue. */
+    void CloseConsumer(const ConsumerQueue& queue);
+
+    std::unique_ptr<VideoSource> source = nullptr;
+    // held by the capture thread while reading from the source, and by consumers while controlling it
+    std::mutex source_mutex;
+    bool source_is_bgr = true;
+    InputTransformMode input_transform = InputTransformMode::None;
+    cv::Size frame_size;
+    size_t consumer_queue_capacity = 0;
+
+    mutable std::mutex consumer_mutex;
+    std::condition_variable frame_ready;
+    // guarded by consumer_mutex
+    std::vector<std::shared_ptr<ConsumerQueue>> consumer_queues;
+    bool capture_started = false;
+    bool capture_finished = false;
+
+    std::atomic<bool> keep_capturing = false;
+    std::atomic<int64_t> captured_frame_count = 0;
+    std::thread capture_thread;
+};
+
+} // namespace presage::smartspectra::video_source
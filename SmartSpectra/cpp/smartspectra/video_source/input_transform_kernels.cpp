@@ -0,0 +1,601 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+// === third-party includes (if any) ===
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define WITH_X86_KERNELS
+#include <immintrin.h>
+#endif
+#if defined(__ARM_NEON)
+#define WITH_NEON_KERNELS
+#include <arm_neon.h>
+#endif
+// === local includes (if any) ===
+#include "input_transform_kernels.hpp"
+
+namespace presage::smartspectra::video_source {
+
+namespace {
+
+// Frames are traversed in square tiles when rotating, so that both the rows read and the rows written stay in cache.
+constexpr int kRotationTileSize = 64;
+
+struct KernelTable {
+    // flip_horizontal & flip_vertical together make up a 180-degree rotation
+    void (* copy_rows)(const cv::Mat& source, cv::Mat& destination, bool flip_horizontal, bool flip_vertical,
+                       bool swap_red_and_blue);
+    void (* rotate)(const cv::Mat& source, cv::Mat& destination, bool clockwise, bool swap_red_and_blue);
+};
+
+// region ========================================== SCALAR ===========================================================
+
+/** Write destination pixels [begin, end) of a row from the source row, mirrored if requested. */
+void CopyRowPixelsScalar(
+    const uint8_t* source_row, uint8_t* destination_row, int width, int begin, int end, bool reverse,
+    bool swap_red_and_blue
+) {
+    const int first_channel = swap_red_and_blue ? 2 : 0;
+    for (int x = begin; x < end; x++) {
+        const uint8_t* source_pixel = source_row + 3 * (reverse ? width - 1 - x : x);
+        uint8_t* destination_pixel = destination_row + 3 * x;
+        destination_pixel[0] = source_pixel[first_channel];
+        destination_pixel[1] = source_pixel[1];
+        destination_pixel[2] = source_pixel[2 - first_channel];
+    }
+}
+
+/** Rotate the source pixels in rows [row_begin, row_end) and columns [column_begin, column_end) into place. */
+void RotateBlockScalar(
+    const cv::Mat& source, cv::Mat& destination, int row_begin, int row_end, int column_begin, int column_end,
+    bool clockwise, bool swap_red_and_blue
+) {
+    const int first_channel = swap_red_and_blue ? 2 : 0;
+    for (int i_row = row_begin; i_row < row_end; i_row++) {
+        const uint8_t* source_pixel = source.ptr<uint8_t>(i_row) + 3 * column_begin;
+        for (int i_column = column_begin; i_column < column_end; i_column++, source_pixel += 3) {
+            // clockwise: (row, column) -> (column, height - 1 - row); counterclockwise: -> (width - 1 - column, row)
+            uint8_t* destination_pixel = clockwise ?
+                                         destination.ptr<uint8_t>(i_column) + 3 * (source.rows - 1 - i_row) :
+                                         destination.ptr<uint8_t>(source.cols - 1 - i_column) + 3 * i_row;
+            destination_pixel[0] = source_pixel[first_channel];
+            destination_pixel[1] = source_pixel[1];
+            destination_pixel[2] = source_pixel[2 - first_channel];
+        }
+    }
+}
+
+void CopyRowsScalar(
+    const cv::Mat& source, cv::Mat& destination, bool flip_horizontal, bool flip_vertical, bool swap_red_and_blue
+) {
+    for (int i_row = 0; i_row < destination.rows; i_row++) {
+        CopyRowPixelsScalar(
+            source.ptr<uint8_t>(flip_vertical ? source.rows - 1 - i_row : i_row), destination.ptr<uint8_t>(i_row),
+            source.cols, 0, source.cols, flip_horizontal, swap_red_and_blue
+        );
+    }
+}
+
+void RotateScalar(const cv::Mat& source, cv::Mat& destination, bool clockwise, bool swap_red_and_blue) {
+    for (int tile_row = 0; tile_row < source.rows; tile_row += kRotationTileSize) {
+        for (int tile_column = 0; tile_column < source.cols; tile_column += kRotationTileSize) {
+            RotateBlockScalar(
+                source, destination,
+                tile_row, std::min(tile_row + kRotationTileSize, source.rows),
+                tile_column, std::min(tile_column + kRotationTileSize, source.cols),
+                clockwise, swap_red_and_blue
+            );
+        }
+    }
+}
+
+/**
+ * Rotate a frame in blocks of block_height x block_width source pixels with the given block kernel, covering the
+ * remaining rows and columns with the scalar one.
+ */
+template<int block_height, int block_width, typename TBlockKernel>
+void RotateInBlocks(
+    const cv::Mat& source, cv::Mat& destination, bool clockwise, bool swap_red_and_blue,
+    TBlockKernel&& rotate_block
+) {
+    const int block_row_end = source.rows - source.rows % block_height;
+    const int block_column_end = source.cols - source.cols % block_width;
+    for (int tile_row = 0; tile_row < block_row_end; tile_row += kRotationTileSize) {
+        const int tile_row_end = std::min(tile_row + kRotationTileSize, block_row_end);
+        for (int tile_column = 0; tile_column < block_column_end; tile_column += kRotationTileSize) {
+            const int tile_column_end = std::min(tile_column + kRotationTileSize, block_column_end);
+            for (int i_row = tile_row; i_row < tile_row_end; i_row += block_height) {
+                for (int i_column = tile_column; i_column < tile_column_end; i_column += block_width) {
+                    rotate_block(i_row, i_column);
+                }
+            }
+        }
+    }
+    RotateBlockScalar(
+        source, destination, 0, block_row_end, block_column_end, source.cols, clockwise, swap_red_and_blue
+    );
+    RotateBlockScalar(
+        source, destination, block_row_end, source.rows, 0, source.cols, clockwise, swap_red_and_blue
+    );
+}
+
+constexpr KernelTable kScalarKernels{CopyRowsScalar, RotateScalar};
+
+// endregion ===========================================================================================================
+#ifdef WITH_X86_KERNELS
+// region ====================================== SSE4.1 & AVX2 ========================================================
+// Functions are compiled for their instruction set via target attributes, so that the rest of the library doesn't
+// depend on it; which ones run is decided at runtime.
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+
+constexpr int8_t kZero = -1; // shuffle index that zeroes the byte
+
+// Shuffles for rows of 4 pixels that take up 12 bytes. Row kernels load 16 bytes to get the 12 they need and store
+// 16 bytes, the 4 extra ones getting overwritten by the next store.
+TARGET_SSE41 __m128i GetForwardRowShuffle(bool swap_red_and_blue) {
+    return swap_red_and_blue ?
+           _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, kZero, kZero, kZero, kZero) :
+           _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, kZero, kZero, kZero, kZero);
+}
+
+// for mirrored rows, the 4 source pixels are loaded into the upper 12 bytes, so that the load starts before them
+TARGET_SSE41 __m128i GetReverseRowShuffle(bool swap_red_and_blue) {
+    return swap_red_and_blue ?
+           _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, kZero, kZero, kZero, kZero) :
+           _mm_setr_epi8(13, 14, 15, 10, 11, 12, 7, 8, 9, 4, 5, 6, kZero, kZero, kZero, kZero);
+}
+
+// Shuffles that spread 4 packed pixels out into 32-bit lanes (for transposing) and pack them back, in order or reversed
+TARGET_SSE41 __m128i GetExpandShuffle(bool swap_red_and_blue) {
+    return swap_red_and_blue ?
+           _mm_setr_epi8(2, 1, 0, kZero, 5, 4, 3, kZero, 8, 7, 6, kZero, 11, 10, 9, kZero) :
+           _mm_setr_epi8(0, 1, 2, kZero, 3, 4, 5, kZero, 6, 7, 8, kZero, 9, 10, 11, kZero);
+}
+
+TARGET_SSE41 __m128i GetPackShuffle(bool reverse) {
+    return reverse ?
+           _mm_setr_epi8(12, 13, 14, 8, 9, 10, 4, 5, 6, 0, 1, 2, kZero, kZero, kZero, kZero) :
+           _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, kZero, kZero, kZero, kZero);
+}
+
+// exactly 12 bytes (4 pixels) are read or written, so that blocks at the frame edges never go out of bounds
+TARGET_SSE41 __m128i Load12(const uint8_t* source) {
+    int32_t last_word;
+    std::memcpy(&last_word, source + 8, sizeof(last_word));
+    return _mm_insert_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)), last_word, 2);
+}
+
+TARGET_SSE41 void Store12(uint8_t* destination, __m128i pixels) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), pixels);
+    const int32_t last_word = _mm_extract_epi32(pixels, 2);
+    std::memcpy(destination + 8, &last_word, sizeof(last_word));
+}
+
+TARGET_SSE41 void CopyRowsSse41(
+    const cv::Mat& source, cv::Mat& destination, bool flip_horizontal, bool flip_vertical, bool swap_red_and_blue
+) {
+    const __m128i shuffle = flip_horizontal ? GetReverseRowShuffle(swap_red_and_blue)
+                                            : GetForwardRowShuffle(swap_red_and_blue);
+    const int width = source.cols;
+    for (int i_row = 0; i_row < destination.rows; i_row++) {
+        const uint8_t* source_row = source.ptr<uint8_t>(flip_vertical ? source.rows - 1 - i_row : i_row);
+        uint8_t* destination_row = destination.ptr<uint8_t>(i_row);
+        int x = 0;
+        // 16-byte loads & stores stay within the row while 6 pixels (18 bytes) remain
+        for (; x + 6 <= width; x += 4) {
+            const uint8_t* load_address = flip_horizontal ? source_row + 3 * (width - 4 - x) - 4 : source_row + 3 * x;
+            const __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(load_address));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(destination_row + 3 * x), _mm_shuffle_epi8(pixels, shuffle));
+        }
+        CopyRowPixelsScalar(source_row, destination_row, width, x, width, flip_horizontal, swap_red_and_blue);
+    }
+}
+
+/**
+ * Transpose a 4x4 block of pixels held in 32-bit lanes: on return, rows[k] holds column k of the block.
+ */
+TARGET_SSE41 void Transpose4x4(__m128i rows[4]) {
+    const __m128i low_01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+    const __m128i low_23 = _mm_unpacklo_epi32(rows[2], rows[3]);
+    const __m128i high_01 = _mm_unpackhi_epi32(rows[0], rows[1]);
+    const __m128i high_23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+    rows[0] = _mm_unpacklo_epi64(low_01, low_23);
+    rows[1] = _mm_unpackhi_epi64(low_01, low_23);
+    rows[2] = _mm_unpacklo_epi64(high_01, high_23);
+    rows[3] = _mm_unpackhi_epi64(high_01, high_23);
+}
+
+TARGET_SSE41 void RotateSse41(const cv::Mat& source, cv::Mat& destination, bool clockwise, bool swap_red_and_blue) {
+    const __m128i expand_shuffle = GetExpandShuffle(swap_red_and_blue);
+    // rotating clockwise, source rows end up in reverse order along the destination rows
+    const __m128i pack_shuffle = GetPackShuffle(/*reverse=*/clockwise);
+    RotateInBlocks<4, 4>(
+        source, destination, clockwise, swap_red_and_blue,
+        [&](int i_row, int i_column) TARGET_SSE41 {
+            __m128i block[4];
+            for (int k = 0; k < 4; k++) {
+                block[k] = _mm_shuffle_epi8(Load12(source.ptr<uint8_t>(i_row + k) + 3 * i_column), expand_shuffle);
+            }
+            Transpose4x4(block);
+            for (int k = 0; k < 4; k++) {
+                uint8_t* destination_pixels =
+                    clockwise ? destination.ptr<uint8_t>(i_column + k) + 3 * (source.rows - 4 - i_row)
+                              : destination.ptr<uint8_t>(source.cols - 1 - i_column - k) + 3 * i_row;
+                Store12(destination_pixels, _mm_shuffle_epi8(block[k], pack_shuffle));
+            }
+        }
+    );
+}
+
+TARGET_AVX2 __m256i Broadcast128(__m128i value) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(value), value, 1);
+}
+
+// gathers the 12 meaningful bytes of each 128-bit lane into the lower 24 bytes
+TARGET_AVX2 __m256i GetLanePackPermutation(bool swap_lanes) {
+    return swap_lanes ? _mm256_setr_epi32(4, 5, 6, 0, 1, 2, 3, 7) : _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+}
+
+TARGET_AVX2 void Store24(uint8_t* destination, __m256i pixels) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm256_castsi256_si128(pixels));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + 16), _mm256_extracti128_si256(pixels, 1));
+}
+
+TARGET_AVX2 void CopyRowsAvx2(
+    const cv::Mat& source, cv::Mat& destination, bool flip_horizontal, bool flip_vertical, bool swap_red_and_blue
+) {
+    // each lane handles 4 pixels, same as with SSE4.1
+    const __m256i shuffle = Broadcast128(
+        flip_horizontal ? GetReverseRowShuffle(swap_red_and_blue) : GetForwardRowShuffle(swap_red_and_blue)
+    );
+    const __m256i lane_pack_permutation = GetLanePackPermutation(/*swap_lanes=*/false);
+    const int width = source.cols;
+    for (int i_row = 0; i_row < destination.rows; i_row++) {
+        const uint8_t* source_row = source.ptr<uint8_t>(flip_vertical ? source.rows - 1 - i_row : i_row);
+        uint8_t* destination_row = destination.ptr<uint8_t>(i_row);
+        int x = 0;
+        // the second 16-byte load and the 32-byte store stay within the row while 11 pixels (33 bytes) remain
+        for (; x + 11 <= width; x += 8) {
+            const uint8_t* low_address;
+            const uint8_t* high_address;
+            if (flip_horizontal) {
+                low_address = source_row + 3 * (width - 4 - x) - 4;
+                high_address = source_row + 3 * (width - 8 - x) - 4;
+            } else {
+                low_address = source_row + 3 * x;
+                high_address = low_address + 12;
+            }
+            const __m256i pixels = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(low_address))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_address)), 1
+            );
+            _mm256_storeu_si256(
+                reinterpret_cast<__m256i*>(destination_row + 3 * x),
+                _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(pixels, shuffle), lane_pack_permutation)
+            );
+        }
+        CopyRowPixelsScalar(source_row, destination_row, width, x, width, flip_horizontal, swap_red_and_blue);
+    }
+}
+
+TARGET_AVX2 void RotateAvx2(const cv::Mat& source, cv::Mat& destination, bool clockwise, bool swap_red_and_blue) {
+    const __m256i expand_shuffle = Broadcast128(GetExpandShuffle(swap_red_and_blue));
+    const __m256i pack_shuffle = Broadcast128(GetPackShuffle(/*reverse=*/clockwise));
+    const __m256i lane_pack_permutation = GetLanePackPermutation(/*swap_lanes=*/clockwise);
+    // 8 source rows x 4 source columns at a time: rows i..i+3 in the lower lanes, rows i+4..i+7 in the upper ones, so
+    // that the in-lane transpose yields 8 consecutive destination pixels per source column
+    RotateInBlocks<8, 4>(
+        source, destination, clockwise, swap_red_and_blue,
+        [&](int i_row, int i_column) TARGET_AVX2 {
+            __m256i block[4];
+            for (int k = 0; k < 4; k++) {
+                block[k] = _mm256_shuffle_epi8(
+                    _mm256_inserti128_si256(
+                        _mm256_castsi128_si256(Load12(source.ptr<uint8_t>(i_row + k) + 3 * i_column)),
+                        Load12(source.ptr<uint8_t>(i_row + 4 + k) + 3 * i_column), 1
+                    ),
+                    expand_shuffle
+                );
+            }
+            const __m256i low_01 = _mm256_unpacklo_epi32(block[0], block[1]);
+            const __m256i low_23 = _mm256_unpacklo_epi32(block[2], block[3]);
+            const __m256i high_01 = _mm256_unpackhi_epi32(block[0], block[1]);
+            const __m256i high_23 = _mm256_unpackhi_epi32(block[2], block[3]);
+            block[0] = _mm256_unpacklo_epi64(low_01, low_23);
+            block[1] = _mm256_unpackhi_epi64(low_01, low_23);
+            block[2] = _mm256_unpacklo_epi64(high_01, high_23);
+            block[3] = _mm256_unpackhi_epi64(high_01, high_23);
+            for (int k = 0; k < 4; k++) {
+                uint8_t* destination_pixels =
+                    clockwise ? destination.ptr<uint8_t>(i_column + k) + 3 * (source.rows - 8 - i_row)
+                              : destination.ptr<uint8_t>(source.cols - 1 - i_column - k) + 3 * i_row;
+                Store24(
+                    destination_pixels,
+                    _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(block[k], pack_shuffle), lane_pack_permutation)
+                );
+            }
+        }
+    );
+}
+
+#undef TARGET_SSE41
+#undef TARGET_AVX2
+
+constexpr KernelTable kSse41Kernels{CopyRowsSse41, RotateSse41};
+constexpr KernelTable kAvx2Kernels{CopyRowsAvx2, RotateAvx2};
+
+// endregion ===========================================================================================================
+#endif // WITH_X86_KERNELS
+#ifdef WITH_NEON_KERNELS
+// region =========================================== NEON ============================================================
+// NEON loads & stores deinterleave & interleave channels, so the channel swap is just a matter of register order.
+
+uint8x16_t Reverse16(uint8x16_t bytes) {
+    const uint8x16_t reversed_halves = vrev64q_u8(bytes);
+    return vextq_u8(reversed_halves, reversed_halves, 8);
+}
+
+void CopyRowsNeon(
+    const cv::Mat& source, cv::Mat& destination, bool flip_horizontal, bool flip_vertical, bool swap_red_and_blue
+) {
+    const int width = source.cols;
+    for (int i_row = 0; i_row < destination.rows; i_row++) {
+        const uint8_t* source_row = source.ptr<uint8_t>(flip_vertical ? source.rows - 1 - i_row : i_row);
+        uint8_t* destination_row = destination.ptr<uint8_t>(i_row);
+        int x = 0;
+        for (; x + 16 <= width; x += 16) {
+            uint8x16x3_t pixels = vld3q_u8(source_row + 3 * (flip_horizontal ? width - 16 - x : x));
+            if (flip_horizontal) {
+                for (auto& channel: pixels.val) {
+                    channel = Reverse16(channel);
+                }
+            }
+            if (swap_red_and_blue) {
+                std::swap(pixels.val[0], pixels.val[2]);
+            }
+            vst3q_u8(destination_row + 3 * x, pixels);
+        }
+        CopyRowPixelsScalar(source_row, destination_row, width, x, width, flip_horizontal, swap_red_and_blue);
+    }
+}
+
+uint8x8x2_t Transpose16(uint8x8_t first, uint8x8_t second) {
+    const uint16x4x2_t transposed = vtrn_u16(vreinterpret_u16_u8(first), vreinterpret_u16_u8(second));
+    return {{vreinterpret_u8_u16(transposed.val[0]), vreinterpret_u8_u16(transposed.val[1])}};
+}
+
+uint8x8x2_t Transpose32(uint8x8_t first, uint8x8_t second) {
+    const uint32x2x2_t transposed = vtrn_u32(vreinterpret_u32_u8(first), vreinterpret_u32_u8(second));
+    return {{vreinterpret_u8_u32(transposed.val[0]), vreinterpret_u8_u32(transposed.val[1])}};
+}
+
+/** Transpose an 8x8 block of bytes: on return, rows[k] holds column k of the block. */
+void Transpose8x8(uint8x8_t rows[8]) {
+    const uint8x8x2_t rows_01 = vtrn_u8(rows[0], rows[1]);
+    const uint8x8x2_t rows_23 = vtrn_u8(rows[2], rows[3]);
+    const uint8x8x2_t rows_45 = vtrn_u8(rows[4], rows[5]);
+    const uint8x8x2_t rows_67 = vtrn_u8(rows[6], rows[7]);
+    // columns {0, 4}, {2, 6}, {1, 5} and {3, 7} of rows 0-3, then of rows 4-7
+    const uint8x8x2_t upper_even = Transpose16(rows_01.val[0], rows_23.val[0]);
+    const uint8x8x2_t upper_odd = Transpose16(rows_01.val[1], rows_23.val[1]);
+    const uint8x8x2_t lower_even = Transpose16(rows_45.val[0], rows_67.val[0]);
+    const uint8x8x2_t lower_odd = Transpose16(rows_45.val[1], rows_67.val[1]);
+    const uint8x8x2_t columns_04 = Transpose32(upper_even.val[0], lower_even.val[0]);
+    const uint8x8x2_t columns_15 = Transpose32(upper_odd.val[0], lower_odd.val[0]);
+    const uint8x8x2_t columns_26 = Transpose32(upper_even.val[1], lower_even.val[1]);
+    const uint8x8x2_t columns_37 = Transpose32(upper_odd.val[1], lower_odd.val[1]);
+    rows[0] = columns_04.val[0];
+    rows[1] = columns_15.val[0];
+    rows[2] = columns_26.val[0];
+    rows[3] = columns_37.val[0];
+    rows[4] = columns_04.val[1];
+    rows[5] = columns_15.val[1];
+    rows[6] = columns_26.val[1];
+    rows[7] = columns_37.val[1];
+}
+
+void RotateNeon(const cv::Mat& source, cv::Mat& destination, bool clockwise, bool swap_red_and_blue) {
+    RotateInBlocks<8, 8>(
+        source, destination, clockwise, swap_red_and_blue,
+        [&](int i_row, int i_column) {
+            // per channel, 8 source rows of 8 pixels each
+            uint8x8_t channels[3][8];
+            for (int k = 0; k < 8; k++) {
+                const uint8x8x3_t pixels = vld3_u8(source.ptr<uint8_t>(i_row + k) + 3 * i_column);
+                for (int i_channel = 0; i_channel < 3; i_channel++) {
+                    channels[i_channel][k] = pixels.val[i_channel];
+                }
+            }
+            for (auto& channel: channels) {
+                Transpose8x8(channel);
+            }
+            const int first_channel = swap_red_and_blue ? 2 : 0;
+            for (int k = 0; k < 8; k++) {
+                uint8x8x3_t pixels{{channels[first_channel][k], channels[1][k], channels[2 - first_channel][k]}};
+                uint8_t* destination_pixels;
+                if (clockwise) {
+                    for (auto& channel: pixels.val) {
+                        channel = vrev64_u8(channel);
+                    }
+                    destination_pixels = destination.ptr<uint8_t>(i_column + k) + 3 * (source.rows - 8 - i_row);
+                } else {
+                    destination_pixels = destination.ptr<uint8_t>(source.cols - 1 - i_column - k) + 3 * i_row;
+                }
+                vst3_u8(destination_pixels, pixels);
+            }
+        }
+    );
+}
+
+constexpr KernelTable kNeonKernels{CopyRowsNeon, RotateNeon};
+
+// endregion ===========================================================================================================
+#endif // WITH_NEON_KERNELS
+
+bool IsInstructionSetSupported(KernelInstructionSet instruction_set) {
+    switch (instruction_set) {
+        case KernelInstructionSet::Scalar:
+            return true;
+#ifdef WITH_X86_KERNELS
+        case KernelInstructionSet::Sse41:
+            return __builtin_cpu_supports("sse4.1");
+        case KernelInstructionSet::Avx2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef WITH_NEON_KERNELS
+        case KernelInstructionSet::Neon:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+const KernelTable& GetKernelTable(KernelInstructionSet instruction_set) {
+    switch (instruction_set) {
+#ifdef WITH_X86_KERNELS
+        case KernelInstructionSet::Sse41:
+            return kSse41Kernels;
+        case KernelInstructionSet::Avx2:
+            return kAvx2Kernels;
+#endif
+#ifdef WITH_NEON_KERNELS
+        case KernelInstructionSet::Neon:
+            return kNeonKernels;
+#endif
+        default:
+            return kScalarKernels;
+    }
+}
+
+} // anonymous namespace
+
+std::string AbslUnparseFlag(KernelInstructionSet instruction_set) {
+    switch (instruction_set) {
+        case KernelInstructionSet::Scalar:
+            return "scalar";
+        case KernelInstructionSet::Sse41:
+            return "sse4.1";
+        case KernelInstructionSet::Avx2:
+            return "avx2";
+        case KernelInstructionSet::Neon:
+            return "neon";
+        default:
+            return "unknown";
+    }
+}
+
+std::vector<KernelInstructionSet> GetSupportedKernelInstructionSets() {
+    std::vector<KernelInstructionSet> instruction_sets;
+    for (KernelInstructionSet instruction_set: {KernelInstructionSet::Scalar, KernelInstructionSet::Sse41,
+                                                KernelInstructionSet::Avx2, KernelInstructionSet::Neon}) {
+        if (IsInstructionSetSupported(instruction_set)) {
+            instruction_sets.push_back(instruction_set);
+        }
+    }
+    return instruction_sets;
+}
+
+KernelInstructionSet GetSelectedKernelInstructionSet() {
+    static const KernelInstructionSet selected_instruction_set = GetSupportedKernelInstructionSets().back();
+    return selected_instruction_set;
+}
+
+cv::Size GetTransformedFrameSize(const cv::Size& frame_size, InputTransformMode mode) {
+    if (mode == InputTransformMode::Clockwise90 || mode == InputTransformMode::Counterclockwise90) {
+        return {frame_size.height, frame_size.width};
+    }
+    return frame_size;
+}
+
+cv::Rect GetUntransformedRect(const cv::Rect& rect, const cv::Size& frame_size, InputTransformMode mode) {
+    switch (mode) {
+        case InputTransformMode::Clockwise90:
+            // columns of the transformed frame are the source rows, bottom to top
+            return {rect.y, frame_size.height - rect.x - rect.width, rect.height, rect.width};
+        case InputTransformMode::Counterclockwise90:
+            // rows of the transformed frame are the source columns, right to left
+            return {frame_size.width - rect.y - rect.height, rect.x, rect.height, rect.width};
+        case InputTransformMode::Rotate180:
+            return {frame_size.width - rect.x - rect.width, frame_size.height - rect.y - rect.height,
+                    rect.width, rect.height};
+        case InputTransformMode::MirrorHorizontal:
+            return {frame_size.width - rect.x - rect.width, rect.y, rect.width, rect.height};
+        case InputTransformMode::MirrorVertical:
+            return {rect.x, frame_size.height - rect.y - rect.height, rect.width, rect.height};
+        default:
+            return rect;
+    }
+}
+
+absl::Status TransformAndSwizzleFrame(
+    const cv::Mat& source,
+    InputTransformMode mode,
+    bool swap_red_and_blue,
+    cv::Mat& destination
+) {
+    return TransformAndSwizzleFrame(source, mode, swap_red_and_blue, destination, GetSelectedKernelInstructionSet());
+}
+
+absl::Status TransformAndSwizzleFrame(
+    const cv::Mat& source,
+    InputTransformMode mode,
+    bool swap_red_and_blue,
+    cv::Mat& destination,
+    KernelInstructionSet instruction_set
+) {
+    if (source.empty()) {
+        return absl::InvalidArgumentError("Cannot transform an empty frame.");
+    }
+    if (source.type() != CV_8UC3 || destination.type() != CV_8UC3) {
+        return absl::InvalidArgumentError("Only 8-bit, 3-channel frames can be transformed and swizzled in one pass.");
+    }
+    if (destination.size() != GetTransformedFrameSize(source.size(), mode)) {
+        return absl::InvalidArgumentError("Destination frame must have the size of the transformed source frame.");
+    }
+    const uint8_t* source_begin = source.ptr<uint8_t>(0);
+    const uint8_t* source_end = source.ptr<uint8_t>(source.rows - 1) + 3 * source.cols;
+    const uint8_t* destination_begin = destination.ptr<uint8_t>(0);
+    const uint8_t* destination_end = destination.ptr<uint8_t>(destination.rows - 1) + 3 * destination.cols;
+    if (source_begin < destination_end && destination_begin < source_end) {
+        return absl::InvalidArgumentError("Source and destination frames must not overlap.");
+    }
+    if (!IsInstructionSetSupported(instruction_set)) {
+        return absl::FailedPreconditionError(
+            "Input transform kernels for " + AbslUnparseFlag(instruction_set) + " are not supported on this CPU."
+        );
+    }
+    const KernelTable& kernels = GetKernelTable(instruction_set);
+    switch (mode) {
+        case InputTransformMode::None:
+            kernels.copy_rows(source, destination, false, false, swap_red_and_blue);
+            break;
+        case InputTransformMode::MirrorHorizontal:
+            kernels.copy_rows(source, destination, true, false, swap_red_and_blue);
+            break;
+        case InputTransformMode::MirrorVertical:
+            kernels.copy_rows(source, destination, false, true, swap_red_and_blue);
+            break;
+        case InputTransformMode::Rotate180:
+            kernels.copy_rows(source, destination, true, true, swap_red_and_blue);
+            break;
+        case InputTransformMode::Clockwise90:
+            kernels.rotate(source, destination, true, swap_red_and_blue);
+            break;
+        case InputTransformMode::Counterclockwise90:
+            kernels.rotate(source, destination, false, swap_red_and_blue);
+            break;
+        default:
+            return absl::InvalidArgumentError("Unsupported input transform mode: " + AbslUnparseFlag(mode));
+    }
+    return absl::OkStatus();
+}
+
+} // namespace presage::smartspectra::video_source
@@ -0,0 +1,88 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+#include <absl/status/status.h>
+#include <mediapipe/framework/port/opencv_core_inc.h>
+// === local includes (if any) ===
+#include "input_transform.hpp"
+
+namespace presage::smartspectra::video_source {
+
+/**
+ * @brief Instruction sets the fused input transform kernels are implemented for.
+ * \ingroup video_source
+ */
+enum class KernelInstructionSet : int {
+    Scalar,
+    Sse41,
+    Avx2,
+    Neon,
+    Unknown_EnumEnd
+};
+
+/** Convert a kernel instruction set to a string, e.g. for logging.
+ *  \ingroup video_source
+ */
+std::string AbslUnparseFlag(KernelInstructionSet instruction_set);
+
+/** Instruction sets of the kernels that can run on this CPU, from the most portable (scalar) to the fastest.
+ *  \ingroup video_source
+ */
+std::vector<KernelInstructionSet> GetSupportedKernelInstructionSets();
+
+/** Instruction set of the kernels TransformAndSwizzleFrame picks at runtime, i.e. the fastest supported one.
+ *  \ingroup video_source
+ */
+KernelInstructionSet GetSelectedKernelInstructionSet();
+
+/** Size of a frame of the given size after applying the input transform to it.
+ *  \ingroup video_source
+ */
+cv::Size GetTransformedFrameSize(const cv::Size& frame_size, InputTransformMode mode);
+
+/** Region of a frame that ends up as the given region of the frame after applying the input transform to it, e.g. to
+ *  crop a frame before transforming it rather than after.
+ *  @param rect region of the transformed frame
+ *  @param frame_size size of the frame before the transform
+ *  \ingroup video_source
+ */
+cv::Rect GetUntransformedRect(const cv::Rect& rect, const cv::Size& frame_size, InputTransformMode mode);
+
+/**
+ * @brief Apply the input transform to an 8-bit, 3-channel frame and, optionally, swap its first and third channels
+ * (BGR <-> RGB), in a single pass that writes straight into the destination.
+ * @details Produces exactly what cv::rotate / cv::flip followed by cv::cvtColor(..., cv::COLOR_BGR2RGB) would, without
+ * the intermediate frames.
+ * @param source frame to transform, CV_8UC3
+ * @param destination preallocated CV_8UC3 frame of GetTransformedFrameSize (any row stride), not overlapping the source
+ * \ingroup video_source
+ */
+absl::Status TransformAndSwizzleFrame(
+    const cv::Mat& source,
+    InputTransformMode mode,
+    bool swap_red_and_blue,
+    cv::Mat& destination
+);
+
+/**
+ * @brief Same as above, with the kernels for the given (supported) instruction set, e.g. to check them against each
+ * other.
+ * \ingroup video_source
+ */
+absl::Status TransformAndSwizzleFrame(
+    const cv::Mat& source,
+    InputTransformMode mode,
+    bool swap_red_and_blue,
+    cv::Mat& destination,
+    KernelInstructionSet instruction_set
+);
+
+} // namespace presage::smartspectra::video_source
@@ -13,7 +13,7 @@
 namespace presage::smartspectra::video_source {
 
 
-cv::Mat InputTransformer::apply(cv::Mat& frame) const {
+cv::Mat InputTransformer::apply(const cv::Mat& frame) const {
     if (frame.empty()) {
         return frame;
     }
@@ -15,7 +15,7 @@ namespace presage::smartspectra::video_source {
 
 struct InputTransformer{
     InputTransformMode mode = InputTransformMode::None;
-    cv::Mat apply(cv::Mat& frame) const;
+    cv::Mat apply(const cv::Mat& frame) const;
 };
 
 } // namespace presage::smartspectra::video_source
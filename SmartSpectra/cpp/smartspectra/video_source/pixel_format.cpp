@@ -0,0 +1,36 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+// === third-party includes (if any) ===
+#include <absl/strings/str_cat.h>
+// === local includes (if any) ===
+#include "pixel_format.hpp"
+
+namespace presage::smartspectra::video_source {
+
+std::string AbslUnparseFlag(PixelFormat pixel_format) {
+    switch (pixel_format) {
+        case PixelFormat::BGR:
+            return "bgr";
+        case PixelFormat::RGB:
+            return "rgb";
+        case PixelFormat::YUYV:
+            return "yuyv";
+        case PixelFormat::NV12:
+            return "nv12";
+        case PixelFormat::Unknown_EnumEnd:
+            return "Unknown_EnumEnd";
+        default:
+            return absl::StrCat(static_cast<int>(pixel_format));
+    }
+}
+
+bool IsPackedPerPixel(PixelFormat pixel_format) {
+    return pixel_format == PixelFormat::BGR || pixel_format == PixelFormat::RGB;
+}
+
+} // namespace presage::smartspectra::video_source
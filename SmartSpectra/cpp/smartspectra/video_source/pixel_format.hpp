@@ -0,0 +1,41 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+#pragma once
+// === standard library includes (if any) ===
+#include <string>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+
+namespace presage::smartspectra::video_source {
+
+/**
+ * @brief Memory layout of the frames a VideoSource produces.
+ * \ingroup video_source
+ */
+enum class PixelFormat : int {
+    /** packed 8-bit, 3 channels (CV_8UC3), blue first -- OpenCV's default */
+    BGR,
+    /** packed 8-bit, 3 channels (CV_8UC3), red first -- what the graph consumes */
+    RGB,
+    /** packed 4:2:2 (CV_8UC2, width x height), Y0 U Y1 V */
+    YUYV,
+    /** planar 4:2:0 (CV_8UC1, width x height * 3 / 2), Y plane followed by an interleaved UV plane */
+    NV12,
+    Unknown_EnumEnd
+};
+
+/** Convert a pixel format to a string, e.g. for logging.
+ *  \ingroup video_source
+ */
+std::string AbslUnparseFlag(PixelFormat pixel_format);
+
+/** True for formats that store one whole pixel per matrix element, i.e. ones that can be rotated or mirrored as is.
+ *  \ingroup video_source
+ */
+bool IsPackedPerPixel(PixelFormat pixel_format);
+
+} // namespace presage::smartspectra::video_source
@@ -46,6 +46,10 @@ struct VideoSourceSettings {
 
     // === video file, priority #1, unless path empty
     std::string input_video_path;
+    /**
+     * per-frame timestamps of the video file: text with one timestamp (in milliseconds) per line, or a binary sidecar
+     * written by capture::WriteFrameTimestampSidecar
+     */
     std::string input_video_time_path;
     // === file stream, priority #2, unless path empty
     /**
@@ -58,6 +62,10 @@ struct VideoSourceSettings {
     std::string file_stream_path;
 
     std::string end_of_stream_filename = "end_of_stream";
+    /**
+     * delay between directory rescans while waiting for new frames -- only used where the directory can't be watched
+     * for changes (i.e. without inotify support), or in loop mode
+     */
     int rescan_retry_delay_ms = 10;
     /**
      * erase file(s) that have already been read in as soon as a newer file appears
@@ -68,6 +76,43 @@ struct VideoSourceSettings {
      * @details loop=true is incompatible with erase_read_files=true argument.
      */
     bool loop = false;
+    /**
+     * number of frames decoded ahead of time (on decode_thread_count threads), while earlier frames are processed
+     * -- not used in loop mode
+     */
+    int file_stream_prefetch_count = 4;
+    /**
+     * (loop mode only) decode the looped frames once, up front, and replay them from memory rather than from disk.
+     * @details Replayed frame timestamps keep increasing from one pass to the next.
+     */
+    bool loop_cache_decoded_frames = false;
+    /** (loop mode only) memory taken up by cached frames at most; frames beyond it get spilled to a mapped file */
+    int loop_cache_memory_budget_mb = 1024;
+    /** (loop mode only) rate at which cached frames are replayed; non-positive values wait rescan_retry_delay_ms */
+    double loop_replay_fps = 30.0;
+
+    // === decoding of compressed frames (V4L2 streaming capture, file streams, video files)
+    /**
+     * smallest frame size needed downstream, e.g. the graph's input size. When both are positive, compressed camera
+     * frames get downscaled by 1/2 or 1/4 during decoding, as long as the result still covers this size. When left
+     * unset, a foreground container with pre_scale_input on fills in the graph's input size.
+     */
+    int decode_target_width_px = -1;
+    int decode_target_height_px = -1;
+    /**
+     * number of threads decoding compressed camera or file stream frames in parallel, or threads used by the video file
+     * codec; 0 picks one automatically
+     */
+    int decode_thread_count = 0;
+    /** number of video file frames decoded ahead of time on a separate thread; 0 decodes each frame on request */
+    int video_file_prefetch_count = 8;
+
+    // === webcam / camera stream capture backend
+    /**
+     * (Linux only) capture through V4L2 memory-mapped streaming directly, rather than through OpenCV, using the
+     * driver's per-frame (monotonic clock) timestamps.
+     */
+    bool v4l2_streaming = false;
 };
 
 } // namespace presage::smartspectra::video_source
@@ -4,6 +4,7 @@
 //
 
 // === standard library includes (if any) ===
+#include <algorithm>
 // === third-party includes (if any) ===
 #include <absl/status/statusor.h>
 // === local includes (if any) ===
@@ -58,6 +59,15 @@ VideoSource& VideoSource::operator>>(cv::Mat& frame) {
     return *this;
 }
 
+VideoSource& VideoSource::ReadPreTransformFrame(cv::Mat& frame) {
+    this->ProducePreTransformFrame(frame);
+    return *this;
+}
+
+InputTransformMode VideoSource::GetInputTransformMode() const {
+    return this->input_transformer.mode;
+}
+
 absl::Status VideoSource::Initialize(const VideoSourceSettings& settings) {
     if (settings.input_transform_mode == InputTransformMode::Unspecified_EnumEnd) {
         this->input_transformer.mode = this->GetDefaultInputTransformMode();
@@ -71,4 +81,34 @@ InputTransformMode VideoSource::GetDefaultInputTransformMode() {
     return InputTransformMode::None;
 }
 
+absl::Status VideoSource::Seek(int64_t timestamp) {
+    return absl::UnimplementedError("Seeking is not supported by this VideoSource.");
+}
+
+std::vector<PixelFormat> VideoSource::GetSupportedPixelFormats() const {
+    return {PixelFormat::BGR};
+}
+
+absl::Status VideoSource::SetOutputPixelFormat(PixelFormat pixel_format) {
+    auto supported_pixel_formats = this->GetSupportedPixelFormats();
+    if (std::find(supported_pixel_formats.begin(), supported_pixel_formats.end(), pixel_format) ==
+        supported_pixel_formats.end()) {
+        return absl::InvalidArgumentError(
+            "Pixel format " + AbslUnparseFlag(pixel_format) + " is not supported by this VideoSource."
+        );
+    }
+    if (!IsPackedPerPixel(pixel_format) && this->input_transformer.mode != InputTransformMode::None) {
+        return absl::FailedPreconditionError(
+            "Pixel format " + AbslUnparseFlag(pixel_format) + " cannot be used together with input transform mode "
+            + AbslUnparseFlag(this->input_transformer.mode) + "."
+        );
+    }
+    this->output_pixel_format = pixel_format;
+    return absl::OkStatus();
+}
+
+PixelFormat VideoSource::GetOutputPixelFormat() const {
+    return this->output_pixel_format;
+}
+
 } // namespace presage::smartspectra::video_source
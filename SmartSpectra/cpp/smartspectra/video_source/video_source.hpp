@@ -22,12 +22,14 @@
 // === standard library includes (if any) ===
 #include <cstdint>
 #include <chrono>
+#include <vector>
 // === third-party includes (if any) ===
 #include <mediapipe/framework/port/opencv_core_inc.h>
 #include <absl/status/statusor.h>
 // === local includes (if any) ===
 #include "settings.hpp"
 #include "input_transformer.hpp"
+#include "pixel_format.hpp"
 
 /**
  * @defgroup video_source Video Sources
@@ -52,6 +54,15 @@ public:
     /** Grab the next frame from the source. */
     VideoSource& operator>>(cv::Mat& frame);
 
+    /**
+     * Grab the next frame from the source without applying the input transform, for consumers that fuse the
+     * transform with later processing (see GetInputTransformMode).
+     */
+    VideoSource& ReadPreTransformFrame(cv::Mat& frame);
+
+    /** Input transform applied to frames grabbed via operator>>. */
+    InputTransformMode GetInputTransformMode() const;
+
     /** Configure the source with provided settings. */
     virtual absl::Status Initialize(const VideoSourceSettings& settings);
 
@@ -65,6 +76,13 @@ public:
      */
     virtual int64_t GetFrameTimestamp() const = 0;
 
+    /**
+     * Reposition the source, so that the next frame produced is the first one with a timestamp at or past the given
+     * one (in microseconds, on the same scale as GetFrameTimestamp).
+     * @return absl::UnimplementedError for sources that can't seek, e.g. cameras
+     */
+    virtual absl::Status Seek(int64_t timestamp);
+
     // These have definitions here, technically making this not a true interface.
     // Ignore this for now, maybe redesign later, (e.g. using C++20 concepts?).
     // == exposure controls
@@ -90,8 +108,24 @@ public:
 
     /** Check if the source has valid frame dimension information. */
     bool HasFrameDimensions();
+
+    // == pixel format negotiation
+    /**
+     * Pixel formats the source can produce, cheapest to produce first. Frames are BGR unless another format is
+     * selected via SetOutputPixelFormat.
+     */
+    virtual std::vector<PixelFormat> GetSupportedPixelFormats() const;
+
+    /**
+     * Select the pixel format of frames produced from here on. Formats that don't store one whole pixel per element
+     * (e.g. YUYV, NV12) can only be selected when no input transform is applied.
+     */
+    virtual absl::Status SetOutputPixelFormat(PixelFormat pixel_format);
+
+    PixelFormat GetOutputPixelFormat() const;
 protected:
     InputTransformer input_transformer;
+    PixelFormat output_pixel_format = PixelFormat::BGR;
     virtual void ProducePreTransformFrame(cv::Mat& frame) = 0;
 };
 
@@ -0,0 +1,117 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <cstdint>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/container/face_roi_tracker.hpp>
+
+namespace container = presage::smartspectra::container;
+namespace physiology = presage::physiology;
+
+namespace {
+
+const cv::Size kFrameSize(1920, 1080);
+const cv::Rect kFullFrame(0, 0, 1920, 1080);
+constexpr int64_t kFrameIntervalUs = 33333;
+
+/** Edge metrics with a single set of landmarks at the corners of the given face box. */
+physiology::Metrics MakeEdgeMetrics(float x_min, float y_min, float x_max, float y_max) {
+    physiology::Metrics edge_metrics;
+    auto* landmarks = edge_metrics.mutable_face()->add_landmarks();
+    auto* point = landmarks->add_value();
+    point->set_x(x_min);
+    point->set_y(y_min);
+    point = landmarks->add_value();
+    point->set_x(x_max);
+    point->set_y(y_max);
+    return edge_metrics;
+}
+
+container::settings::RoiCropSettings MakeSettings() {
+    container::settings::RoiCropSettings settings;
+    settings.enabled = true;
+    return settings;
+}
+
+} // anonymous namespace
+
+TEST_CASE("FaceRoiTracker sends full frames until it finds a face") {
+    container::FaceRoiTracker tracker(MakeSettings());
+    REQUIRE(tracker.GetCrop(kFrameSize, 0) == kFullFrame);
+    // no landmarks at all
+    tracker.HandleEdgeMetrics(physiology::Metrics(), 0);
+    REQUIRE(tracker.GetCrop(kFrameSize, kFrameIntervalUs) == kFullFrame);
+}
+
+TEST_CASE("FaceRoiTracker grows the face box by the margins") {
+    container::FaceRoiTracker tracker(MakeSettings());
+    // 100x120 face: 1x the width on either side, 0.5x the height above and 2.5x below
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(900, 300, 1000, 420), 0);
+    REQUIRE(tracker.GetCrop(kFrameSize, kFrameIntervalUs) == cv::Rect(800, 240, 300, 480));
+
+    // odd coordinates get snapped outwards to even ones
+    tracker.Reset();
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(901, 301, 1001, 421), 2 * kFrameIntervalUs);
+    const cv::Rect odd_crop = tracker.GetCrop(kFrameSize, 3 * kFrameIntervalUs);
+    REQUIRE(odd_crop == cv::Rect(800, 240, 302, 482));
+
+    // clamped to the frame
+    tracker.Reset();
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(10, 900, 110, 1000), 4 * kFrameIntervalUs);
+    REQUIRE(tracker.GetCrop(kFrameSize, 5 * kFrameIntervalUs) == cv::Rect(0, 850, 210, 230));
+}
+
+TEST_CASE("FaceRoiTracker keeps the crop steady through small movements") {
+    container::FaceRoiTracker tracker(MakeSettings());
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(900, 300, 1000, 420), 0);
+    const cv::Rect crop = tracker.GetCrop(kFrameSize, kFrameIntervalUs);
+    REQUIRE(crop == cv::Rect(800, 240, 300, 480));
+
+    // a few pixels off: the face still has more than half of the margins around it
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(910, 305, 1010, 425), kFrameIntervalUs);
+    REQUIRE(tracker.GetCrop(kFrameSize, 2 * kFrameIntervalUs) == crop);
+
+    // far enough off that the face is about to leave the crop: the crop follows
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(1040, 300, 1140, 420), 2 * kFrameIntervalUs);
+    REQUIRE(tracker.GetCrop(kFrameSize, 3 * kFrameIntervalUs) == cv::Rect(940, 240, 300, 480));
+
+    // the face moving away from the camera leaves the crop much too large: it shrinks
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(1070, 330, 1110, 378), 3 * kFrameIntervalUs);
+    REQUIRE(tracker.GetCrop(kFrameSize, 4 * kFrameIntervalUs) == cv::Rect(1030, 306, 120, 192));
+}
+
+TEST_CASE("FaceRoiTracker skips cropping when the region would cover most of the frame") {
+    container::FaceRoiTracker tracker(MakeSettings());
+    tracker.HandleEdgeMetrics(MakeEdgeMetrics(100, 100, 1800, 900), 0);
+    REQUIRE(tracker.GetCrop(kFrameSize, kFrameIntervalUs) == kFullFrame);
+}
+
+TEST_CASE("FaceRoiTracker goes back to full frames when the track times out or gets reset") {
+    container::settings::RoiCropSettings settings = MakeSettings();
+    settings.track_timeout_ms = 500;
+    container::FaceRoiTracker tracker(settings);
+    const physiology::Metrics edge_metrics = MakeEdgeMetrics(900, 300, 1000, 420);
+    const cv::Rect crop(800, 240, 300, 480);
+
+    SECTION("timeout") {
+        tracker.HandleEdgeMetrics(edge_metrics, 0);
+        REQUIRE(tracker.GetCrop(kFrameSize, 500000) == crop);
+        REQUIRE(tracker.GetCrop(kFrameSize, 500001) == kFullFrame);
+        // and stays that way until the face turns up again
+        REQUIRE(tracker.GetCrop(kFrameSize, 533334) == kFullFrame);
+        tracker.HandleEdgeMetrics(edge_metrics, 533334);
+        REQUIRE(tracker.GetCrop(kFrameSize, 566667) == crop);
+    }
+    SECTION("reset") {
+        tracker.HandleEdgeMetrics(edge_metrics, 0);
+        REQUIRE(tracker.GetCrop(kFrameSize, kFrameIntervalUs) == crop);
+        tracker.Reset();
+        REQUIRE(tracker.GetCrop(kFrameSize, 2 * kFrameIntervalUs) == kFullFrame);
+    }
+}
@@ -0,0 +1,255 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/video_source/frame_broadcaster.hpp>
+
+namespace vs = presage::smartspectra::video_source;
+
+namespace {
+
+constexpr int kFrameWidth = 32;
+constexpr int kFrameHeight = 24;
+constexpr int64_t kFrameIntervalUs = 33333;
+constexpr int kConsumerQueueCapacity = 2;
+// BGR color of all frames
+constexpr uint8_t kBlue = 10;
+constexpr uint8_t kGreen = 20;
+constexpr uint8_t kRed = 30;
+
+/**
+ * Video source producing solid-color BGR frames, timestamped kFrameIntervalUs apart, up to a frame limit. A gated
+ * source produces each frame only once the test releases it, so that the test decides when the broadcaster captures;
+ * a free-running one produces a frame every millisecond.
+ */
+class FakeVideoSource : public vs::VideoSource {
+public:
+    explicit FakeVideoSource(bool gated, int64_t frame_limit = std::numeric_limits<int64_t>::max())
+        : gated(gated), frame_limit(frame_limit) {}
+
+    bool SupportsExactFrameTimestamp() const override {
+        return true;
+    }
+
+    int64_t GetFrameTimestamp() const override {
+        return this->frame_timestamp_us;
+    }
+
+    int GetWidth() override {
+        return kFrameWidth;
+    }
+
+    int GetHeight() override {
+        return kFrameHeight;
+    }
+
+    /** Let a gated source produce the given number of further frames. */
+    void ReleaseFrames(int64_t frame_count) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->released_frame_count += frame_count;
+        }
+        this->frames_released.notify_all();
+    }
+
+protected:
+    void ProducePreTransformFrame(cv::Mat& frame) override {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        if (this->produced_frame_count >= this->frame_limit) {
+            frame.release();
+            return;
+        }
+        if (this->gated) {
+            this->frames_released.wait(lock, [this] {
+                return this->released_frame_count > this->produced_frame_count;
+            });
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        frame = cv::Mat(kFrameHeight, kFrameWidth, CV_8UC3, cv::Scalar(kBlue, kGreen, kRed));
+        this->frame_timestamp_us = this->produced_frame_count * kFrameIntervalUs;
+        this->produced_frame_count++;
+    }
+
+private:
+    const bool gated;
+    const int64_t frame_limit;
+    std::mutex mutex;
+    std::condition_variable frames_released;
+    int64_t released_frame_count = 0;
+    int64_t produced_frame_count = 0;
+    int64_t frame_timestamp_us = 0;
+};
+
+/** Initialize the broadcaster with a fake source, which it takes ownership of. */
+FakeVideoSource& InitializeWithFakeSource(
+    vs::FrameBroadcaster& broadcaster,
+    bool gated,
+    int64_t frame_limit = std::numeric_limits<int64_t>::max()
+) {
+    auto source = std::make_unique<FakeVideoSource>(gated, frame_limit);
+    FakeVideoSource& source_reference = *source;
+    REQUIRE(broadcaster.Initialize(std::move(source), kConsumerQueueCapacity).ok());
+    return source_reference;
+}
+
+std::unique_ptr<vs::VideoSource> AddConsumer(vs::FrameBroadcaster& broadcaster) {
+    auto consumer = broadcaster.AddConsumer();
+    REQUIRE(consumer.ok());
+    return std::move(*consumer);
+}
+
+/** Read frames until the consumer's stream ends, returning how many there were. */
+int ReadRemainingFrames(vs::VideoSource& consumer) {
+    int frame_count = 0;
+    cv::Mat frame;
+    consumer >> frame;
+    while (!frame.empty()) {
+        frame_count++;
+        consumer >> frame;
+    }
+    return frame_count;
+}
+
+} // anonymous namespace
+
+TEST_CASE("FrameBroadcaster hands all consumers the same converted frame buffer") {
+    vs::FrameBroadcaster broadcaster;
+    FakeVideoSource& source = InitializeWithFakeSource(broadcaster, true, 1);
+    auto first_consumer = AddConsumer(broadcaster);
+    auto second_consumer = AddConsumer(broadcaster);
+    REQUIRE(first_consumer->GetOutputPixelFormat() == vs::PixelFormat::RGB);
+    REQUIRE(first_consumer->GetWidth() == kFrameWidth);
+    REQUIRE(first_consumer->GetHeight() == kFrameHeight);
+
+    source.ReleaseFrames(1);
+    cv::Mat first_frame, second_frame;
+    *first_consumer >> first_frame;
+    *second_consumer >> second_frame;
+    REQUIRE(!first_frame.empty());
+    REQUIRE(first_frame.data == second_frame.data);
+    REQUIRE(first_consumer->GetFrameTimestamp() == 0);
+    REQUIRE(second_consumer->GetFrameTimestamp() == 0);
+    // converted to RGB once, for everyone
+    REQUIRE(first_frame.data[0] == kRed);
+    REQUIRE(first_frame.data[1] == kGreen);
+    REQUIRE(first_frame.data[2] == kBlue);
+    REQUIRE(broadcaster.GetCapturedFrameCount() == 1);
+
+    // the source has run out
+    *first_consumer >> first_frame;
+    REQUIRE(first_frame.empty());
+}
+
+TEST_CASE("FrameBroadcaster drops frames only for consumers that fall behind") {
+    constexpr int kFrameCount = 20;
+    vs::FrameBroadcaster broadcaster;
+    FakeVideoSource& source = InitializeWithFakeSource(broadcaster, true, kFrameCount);
+    auto reading_consumer = AddConsumer(broadcaster);
+    auto stalled_consumer = AddConsumer(broadcaster);
+
+    // the reading consumer keeps up with capture, the stalled one doesn't read anything until capture is over
+    cv::Mat frame;
+    for (int i_frame = 0; i_frame < kFrameCount; i_frame++) {
+        source.ReleaseFrames(1);
+        *reading_consumer >> frame;
+        REQUIRE(!frame.empty());
+        REQUIRE(reading_consumer->GetFrameTimestamp() == i_frame * kFrameIntervalUs);
+    }
+    *reading_consumer >> frame;
+    REQUIRE(frame.empty());
+    REQUIRE(broadcaster.GetCapturedFrameCount() == kFrameCount);
+
+    // only the most recent frames are left for the stalled consumer
+    for (int i_frame = kFrameCount - kConsumerQueueCapacity; i_frame < kFrameCount; i_frame++) {
+        *stalled_consumer >> frame;
+        REQUIRE(!frame.empty());
+        REQUIRE(stalled_consumer->GetFrameTimestamp() == i_frame * kFrameIntervalUs);
+    }
+    *stalled_consumer >> frame;
+    REQUIRE(frame.empty());
+}
+
+TEST_CASE("FrameBroadcaster streams end after Stop") {
+    vs::FrameBroadcaster broadcaster;
+    InitializeWithFakeSource(broadcaster, false);
+    auto reading_consumer = AddConsumer(broadcaster);
+    auto idle_consumer = AddConsumer(broadcaster);
+
+    cv::Mat frame;
+    for (int i_frame = 0; i_frame < 3; i_frame++) {
+        *reading_consumer >> frame;
+        REQUIRE(!frame.empty());
+    }
+    broadcaster.Stop();
+    const int64_t captured_frame_count = broadcaster.GetCapturedFrameCount();
+    // whatever was captured already still comes through
+    REQUIRE(ReadRemainingFrames(*reading_consumer) <= kConsumerQueueCapacity);
+    REQUIRE(ReadRemainingFrames(*idle_consumer) <= kConsumerQueueCapacity);
+    REQUIRE(broadcaster.GetCapturedFrameCount() == captured_frame_count);
+
+    // consumers added after the fact get nothing, nor do they restart capture
+    auto late_consumer = AddConsumer(broadcaster);
+    *late_consumer >> frame;
+    REQUIRE(frame.empty());
+    REQUIRE(broadcaster.GetCapturedFrameCount() == captured_frame_count);
+}
+
+TEST_CASE("FrameBroadcaster unregisters consumers as they go away") {
+    vs::FrameBroadcaster broadcaster;
+    InitializeWithFakeSource(broadcaster, false);
+    auto remaining_consumer = AddConsumer(broadcaster);
+    auto departing_consumer = AddConsumer(broadcaster);
+    REQUIRE(broadcaster.GetConsumerCount() == 2);
+
+    cv::Mat frame;
+    *departing_consumer >> frame;
+    REQUIRE(!frame.empty());
+    departing_consumer.reset();
+    REQUIRE(broadcaster.GetConsumerCount() == 1);
+    // capture goes on for the others
+    for (int i_frame = 0; i_frame < 3; i_frame++) {
+        *remaining_consumer >> frame;
+        REQUIRE(!frame.empty());
+    }
+    remaining_consumer.reset();
+    REQUIRE(broadcaster.GetConsumerCount() == 0);
+}
+
+TEST_CASE("FrameBroadcaster can only be initialized again once its consumers are gone") {
+    vs::FrameBroadcaster broadcaster;
+    InitializeWithFakeSource(broadcaster, false);
+    auto consumer = AddConsumer(broadcaster);
+    cv::Mat frame;
+    *consumer >> frame;
+    REQUIRE(!frame.empty());
+
+    absl::Status status = broadcaster.Initialize(std::make_unique<FakeVideoSource>(false), kConsumerQueueCapacity);
+    REQUIRE(absl::IsFailedPrecondition(status));
+    // the existing consumer still gets frames
+    *consumer >> frame;
+    REQUIRE(!frame.empty());
+
+    consumer.reset();
+    FakeVideoSource& source = InitializeWithFakeSource(broadcaster, true, 1);
+    REQUIRE(broadcaster.GetCapturedFrameCount() == 0);
+    consumer = AddConsumer(broadcaster);
+    source.ReleaseFrames(1);
+    *consumer >> frame;
+    REQUIRE(!frame.empty());
+    REQUIRE(consumer->GetFrameTimestamp() == 0);
+}
@@ -0,0 +1,134 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include "test_data_paths.hpp"
+#include <smartspectra/video_source/camera/frame_timestamp_file.hpp>
+
+namespace capture = presage::smartspectra::video_source::capture;
+
+namespace {
+
+constexpr int64_t kInt64Min = std::numeric_limits<int64_t>::min();
+constexpr int64_t kInt64Max = std::numeric_limits<int64_t>::max();
+
+std::string ReadFileContents(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void RequireSidecarRoundTrip(const std::vector<int64_t>& timestamps) {
+    const std::filesystem::path path = std::filesystem::path(GENERATED_TEST_DATA_DIRECTORY) / "frame_timestamps.fts";
+    REQUIRE(capture::WriteFrameTimestampSidecar(path, timestamps).ok());
+    const std::string contents = ReadFileContents(path);
+    REQUIRE(capture::IsFrameTimestampSidecar(contents));
+
+    auto decoded_timestamps = capture::DecodeFrameTimestampSidecar(contents);
+    REQUIRE(decoded_timestamps.ok());
+    REQUIRE(*decoded_timestamps == timestamps);
+    // same through the (memory-mapped) file reader, which has to tell the sidecar from text
+    auto read_timestamps = capture::ReadFrameTimestampFile(path);
+    REQUIRE(read_timestamps.ok());
+    REQUIRE(*read_timestamps == timestamps);
+    std::filesystem::remove(path);
+}
+
+} // anonymous namespace
+
+TEST_CASE("ParseFrameTimestampText converts milliseconds per line to microseconds") {
+    REQUIRE(capture::ParseFrameTimestampText("").empty());
+    REQUIRE(capture::ParseFrameTimestampText("0\n33\n67\n") == std::vector<int64_t>{0, 33000, 67000});
+    // no line ending after the last line
+    REQUIRE(capture::ParseFrameTimestampText("100\n133") == std::vector<int64_t>{100000, 133000});
+    // CRLF line endings, surrounding whitespace & blank lines
+    REQUIRE(capture::ParseFrameTimestampText("1\r\n\r\n  2\r\n\t3 \n\n") == std::vector<int64_t>{1000, 2000, 3000});
+    // signs
+    REQUIRE(capture::ParseFrameTimestampText("-5\n+5\n") == std::vector<int64_t>{-5000, 5000});
+    // whatever follows the number on a line is ignored
+    REQUIRE(capture::ParseFrameTimestampText("42 ms\n43,frame_2\n") == std::vector<int64_t>{42000, 43000});
+}
+
+TEST_CASE("ParseFrameTimestampText skips lines that don't start with an integer") {
+    REQUIRE(capture::ParseFrameTimestampText("timestamp_ms\n10\nn/a\n20\n") == std::vector<int64_t>{10000, 20000});
+    REQUIRE(capture::ParseFrameTimestampText("- 5\n++5\n").empty());
+    // out of int64 range
+    REQUIRE(capture::ParseFrameTimestampText("99999999999999999999\n7\n") == std::vector<int64_t>{7000});
+}
+
+TEST_CASE("Frame timestamp sidecar round-trips timestamps") {
+    SECTION("empty") {
+        RequireSidecarRoundTrip({});
+    }
+    SECTION("increasing") {
+        std::vector<int64_t> timestamps;
+        for (int64_t i_frame = 0; i_frame < 1000; i_frame++) {
+            timestamps.push_back(1'700'000'000'000'000 + i_frame * 33'333 + (i_frame % 3));
+        }
+        RequireSidecarRoundTrip(timestamps);
+    }
+    SECTION("negative differences") {
+        RequireSidecarRoundTrip({1000, 500, -500, -501, 0, 0, 7});
+    }
+    SECTION("int64 limits") {
+        RequireSidecarRoundTrip({kInt64Max});
+        RequireSidecarRoundTrip({kInt64Min});
+        // differences that overflow int64
+        RequireSidecarRoundTrip({kInt64Min, kInt64Max, kInt64Min, 0, kInt64Max, -1, kInt64Min + 1});
+    }
+}
+
+TEST_CASE("Frame timestamp sidecar is compact for steady frame rates") {
+    const std::filesystem::path path = std::filesystem::path(GENERATED_TEST_DATA_DIRECTORY) / "frame_timestamps.fts";
+    std::vector<int64_t> timestamps;
+    for (int64_t i_frame = 0; i_frame < 900; i_frame++) {
+        timestamps.push_back(i_frame * 33'333);
+    }
+    REQUIRE(capture::WriteFrameTimestampSidecar(path, timestamps).ok());
+    // 3 bytes per difference, plus the header
+    REQUIRE(std::filesystem::file_size(path) <= 3 * timestamps.size() + 16);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("DecodeFrameTimestampSidecar rejects corrupt sidecars") {
+    const std::filesystem::path path = std::filesystem::path(GENERATED_TEST_DATA_DIRECTORY) / "frame_timestamps.fts";
+    REQUIRE(capture::WriteFrameTimestampSidecar(path, {0, 33333, 66667}).ok());
+    const std::string contents = ReadFileContents(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(absl::IsInvalidArgument(capture::DecodeFrameTimestampSidecar("0\n33\n").status()));
+    // truncated within the timestamps
+    REQUIRE(absl::IsDataLoss(capture::DecodeFrameTimestampSidecar(contents.substr(0, contents.size() - 1)).status()));
+    // truncated right after the header
+    const std::string header = contents.substr(0, 9);
+    REQUIRE(!capture::DecodeFrameTimestampSidecar(header).ok());
+    // unknown format version
+    std::string future_version = contents;
+    future_version[8] = 2;
+    REQUIRE(absl::IsUnimplemented(capture::DecodeFrameTimestampSidecar(future_version).status()));
+}
+
+TEST_CASE("ReadFrameTimestampFile reads text files") {
+    const std::filesystem::path path = std::filesystem::path(GENERATED_TEST_DATA_DIRECTORY) / "frame_timestamps.txt";
+    {
+        std::ofstream file(path);
+        file << "0\n33\n67\n";
+    }
+    auto timestamps = capture::ReadFrameTimestampFile(path);
+    REQUIRE(timestamps.ok());
+    REQUIRE(*timestamps == std::vector<int64_t>{0, 33000, 67000});
+    std::filesystem::remove(path);
+
+    REQUIRE(absl::IsNotFound(capture::ReadFrameTimestampFile(path).status()));
+}
@@ -0,0 +1,174 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <optional>
+#include <string>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/calculator.pb.h>
+#include <mediapipe/framework/port/parse_text_proto.h>
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/container/graph_input_scaling.hpp>
+
+namespace container = presage::smartspectra::container;
+
+namespace {
+
+constexpr char kInputVideo[] = "input_video";
+
+/** Graph config with a single ImageTransformationCalculator reading the input video, with the given options. */
+mediapipe::CalculatorGraphConfig MakeConfig(const std::string& options, const std::string& extra_input_streams = "") {
+    return mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig>(
+        R"(node { calculator: "ImageTransformationCalculator" input_stream: "IMAGE:input_video" )" +
+        extra_input_streams + R"( output_stream: "IMAGE:scaled_video" )" +
+        R"(options { [mediapipe.ImageTransformationCalculatorOptions.ext] { )" + options + " } } }"
+    );
+}
+
+void RequireScaling(
+    const std::optional<container::GraphInputScaling>& scaling,
+    const cv::Size& output_size,
+    container::GraphInputScaleMode scale_mode
+) {
+    REQUIRE(scaling.has_value());
+    REQUIRE(scaling->output_size == output_size);
+    REQUIRE(scaling->scale_mode == scale_mode);
+}
+
+void RequirePreScaledFrameSize(
+    const cv::Size& frame_size,
+    const container::GraphInputScaling& scaling,
+    const cv::Size& pre_scaled_frame_size
+) {
+    INFO("frame size " << frame_size.width << "x" << frame_size.height);
+    const std::optional<cv::Size> size = container::GetPreScaledFrameSize(frame_size, scaling);
+    REQUIRE(size.has_value());
+    REQUIRE(*size == pre_scaled_frame_size);
+}
+
+} // anonymous namespace
+
+TEST_CASE("FindGraphInputScaling reads the output size & scale mode of the input video's transformation") {
+    SECTION("scale modes") {
+        RequireScaling(
+            container::FindGraphInputScaling(MakeConfig("output_width: 256 output_height: 192"), kInputVideo),
+            {256, 192}, container::GraphInputScaleMode::Stretch
+        );
+        RequireScaling(
+            container::FindGraphInputScaling(
+                MakeConfig("output_width: 256 output_height: 192 scale_mode: STRETCH"), kInputVideo
+            ),
+            {256, 192}, container::GraphInputScaleMode::Stretch
+        );
+        RequireScaling(
+            container::FindGraphInputScaling(
+                MakeConfig("output_width: 256 output_height: 192 scale_mode: FIT"), kInputVideo
+            ),
+            {256, 192}, container::GraphInputScaleMode::Fit
+        );
+        RequireScaling(
+            container::FindGraphInputScaling(
+                MakeConfig("output_width: 256 output_height: 192 scale_mode: FILL_AND_CROP"), kInputVideo
+            ),
+            {256, 192}, container::GraphInputScaleMode::FillAndCrop
+        );
+    }
+    SECTION("no-op rotation") {
+        RequireScaling(
+            container::FindGraphInputScaling(
+                MakeConfig("output_width: 256 output_height: 192 rotation_mode: ROTATION_0"), kInputVideo
+            ),
+            {256, 192}, container::GraphInputScaleMode::Stretch
+        );
+    }
+    SECTION("options in node_options, stream with an index") {
+        auto config = mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig>(R"(
+            node { calculator: "FlowLimiterCalculator" input_stream: "input_video" output_stream: "limited_video" }
+            node {
+                calculator: "ImageTransformationCalculator"
+                input_stream: "IMAGE:0:input_video"
+                output_stream: "IMAGE:scaled_video"
+                node_options {
+                    [type.googleapis.com/mediapipe.ImageTransformationCalculatorOptions] {
+                        output_width: 320 output_height: 240 scale_mode: FIT
+                    }
+                }
+            }
+        )");
+        RequireScaling(
+            container::FindGraphInputScaling(config, kInputVideo), {320, 240}, container::GraphInputScaleMode::Fit
+        );
+    }
+}
+
+TEST_CASE("FindGraphInputScaling finds no scaling it can't anticipate") {
+    // a different stream
+    REQUIRE(!container::FindGraphInputScaling(MakeConfig("output_width: 256 output_height: 192"), "other_video"));
+    // input scaling off: no output size
+    REQUIRE(!container::FindGraphInputScaling(MakeConfig("output_width: 0 output_height: 0"), kInputVideo));
+    REQUIRE(!container::FindGraphInputScaling(MakeConfig("output_width: 256"), kInputVideo));
+    // rotation
+    REQUIRE(!container::FindGraphInputScaling(
+        MakeConfig("output_width: 256 output_height: 192 rotation_mode: ROTATION_90"), kInputVideo
+    ));
+    // size or rotation coming in per frame
+    REQUIRE(!container::FindGraphInputScaling(
+        MakeConfig("output_width: 256 output_height: 192", R"(input_stream: "OUTPUT_DIMENSIONS:dimensions")"),
+        kInputVideo
+    ));
+    REQUIRE(!container::FindGraphInputScaling(
+        MakeConfig("output_width: 256 output_height: 192", R"(input_stream: "ROTATION_DEGREES:rotation")"),
+        kInputVideo
+    ));
+    // no options at all
+    REQUIRE(!container::FindGraphInputScaling(
+        mediapipe::ParseTextProtoOrDie<mediapipe::CalculatorGraphConfig>(
+            R"(node { calculator: "ImageTransformationCalculator" input_stream: "IMAGE:input_video" })"
+        ),
+        kInputVideo
+    ));
+}
+
+TEST_CASE("GetPreScaledFrameSize matches the graph's own input scaling") {
+    SECTION("stretch") {
+        const container::GraphInputScaling scaling{{256, 256}, container::GraphInputScaleMode::Stretch};
+        RequirePreScaledFrameSize({1920, 1080}, scaling, {256, 256});
+        RequirePreScaledFrameSize({1080, 1920}, scaling, {256, 256});
+        // shrinks in one dimension, stays in the other
+        RequirePreScaledFrameSize({1920, 256}, scaling, {256, 256});
+    }
+    SECTION("fit") {
+        const container::GraphInputScaling scaling{{256, 256}, container::GraphInputScaleMode::Fit};
+        RequirePreScaledFrameSize({1920, 1080}, scaling, {256, 144});
+        RequirePreScaledFrameSize({1080, 1920}, scaling, {144, 256});
+        // odd sizes: rounded to the nearest pixel, as the graph would
+        RequirePreScaledFrameSize({1001, 751}, scaling, {256, 192});
+        RequirePreScaledFrameSize({1279, 719}, scaling, {256, 144});
+    }
+    SECTION("fill & crop") {
+        const container::GraphInputScaling scaling{{256, 256}, container::GraphInputScaleMode::FillAndCrop};
+        RequirePreScaledFrameSize({1920, 1080}, scaling, {455, 256});
+        RequirePreScaledFrameSize({1080, 1920}, scaling, {256, 455});
+        // odd sizes
+        RequirePreScaledFrameSize({1001, 751}, scaling, {341, 256});
+    }
+}
+
+TEST_CASE("GetPreScaledFrameSize leaves frames the graph wouldn't downscale alone") {
+    const container::GraphInputScaling stretch{{256, 256}, container::GraphInputScaleMode::Stretch};
+    const container::GraphInputScaling fit{{256, 256}, container::GraphInputScaleMode::Fit};
+    const container::GraphInputScaling fill_and_crop{{256, 256}, container::GraphInputScaleMode::FillAndCrop};
+    // already at the input size
+    REQUIRE(!container::GetPreScaledFrameSize({256, 256}, stretch));
+    REQUIRE(!container::GetPreScaledFrameSize({256, 144}, fit));
+    // would get upscaled in at least one dimension
+    REQUIRE(!container::GetPreScaledFrameSize({200, 1080}, stretch));
+    REQUIRE(!container::GetPreScaledFrameSize({128, 72}, fit));
+    REQUIRE(!container::GetPreScaledFrameSize({1920, 200}, fill_and_crop));
+    // empty
+    REQUIRE(!container::GetPreScaledFrameSize({0, 0}, fit));
+}
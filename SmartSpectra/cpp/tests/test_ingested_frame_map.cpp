@@ -0,0 +1,114 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <cstdint>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/container/ingested_frame_map.hpp>
+
+namespace container = presage::smartspectra::container;
+namespace physiology = presage::physiology;
+
+namespace {
+
+const cv::Rect kFullFrame(0, 0, 1920, 1080);
+const cv::Rect kCrop(800, 240, 300, 480);
+constexpr int64_t kFrameIntervalUs = 33333;
+
+/** Add a set of landmarks with a single point. */
+void AddLandmarks(physiology::Face& face, float x, float y, int64_t timestamp = 0) {
+    auto* landmarks = face.add_landmarks();
+    landmarks->set_timestamp(timestamp);
+    auto* point = landmarks->add_value();
+    point->set_x(x);
+    point->set_y(y);
+}
+
+void RequirePoint(const physiology::Face& face, int i_landmarks, float x, float y) {
+    INFO("landmarks " << i_landmarks);
+    REQUIRE(face.landmarks(i_landmarks).value(0).x() == x);
+    REQUIRE(face.landmarks(i_landmarks).value(0).y() == y);
+}
+
+} // anonymous namespace
+
+TEST_CASE("IngestedFrameMap maps landmarks of cropped & scaled frames onto the full frame") {
+    container::IngestedFrameMap frame_map;
+    SECTION("full frame") {
+        frame_map.RecordIngestedFrame(0, kFullFrame, kFullFrame.size());
+        physiology::Face face;
+        AddLandmarks(face, 900, 300);
+        REQUIRE(frame_map.MapLandmarks(face, 0));
+        RequirePoint(face, 0, 900, 300);
+    }
+    SECTION("crop") {
+        frame_map.RecordIngestedFrame(0, kCrop, kCrop.size());
+        physiology::Face face;
+        AddLandmarks(face, 100, 60);
+        REQUIRE(frame_map.MapLandmarks(face, 0));
+        RequirePoint(face, 0, 900, 300);
+    }
+    SECTION("pre-scaled crop") {
+        frame_map.RecordIngestedFrame(0, kCrop, {150, 240});
+        physiology::Face face;
+        AddLandmarks(face, 50, 30);
+        AddLandmarks(face, 150, 240);
+        REQUIRE(frame_map.MapLandmarks(face, 0));
+        RequirePoint(face, 0, 900, 300);
+        RequirePoint(face, 1, 1100, 720);
+    }
+    SECTION("pre-scaled full frame") {
+        frame_map.RecordIngestedFrame(0, kFullFrame, {480, 270});
+        physiology::Face face;
+        AddLandmarks(face, 240, 135);
+        REQUIRE(frame_map.MapLandmarks(face, 0));
+        RequirePoint(face, 0, 960, 540);
+    }
+}
+
+TEST_CASE("IngestedFrameMap places each set of landmarks by the frame it was detected in") {
+    container::IngestedFrameMap frame_map;
+    // (a landmark timestamp of 0 stands for "unset", so start past it)
+    constexpr int64_t kStartUs = 1'000'000;
+    // full frames first, then a crop, then full frames again (e.g. after the face was lost)
+    frame_map.RecordIngestedFrame(kStartUs, kFullFrame, kFullFrame.size());
+    frame_map.RecordIngestedFrame(kStartUs + kFrameIntervalUs, kFullFrame, kFullFrame.size());
+    frame_map.RecordIngestedFrame(kStartUs + 2 * kFrameIntervalUs, kCrop, kCrop.size());
+    frame_map.RecordIngestedFrame(kStartUs + 3 * kFrameIntervalUs, kCrop, kCrop.size());
+    frame_map.RecordIngestedFrame(kStartUs + 4 * kFrameIntervalUs, kFullFrame, kFullFrame.size());
+
+    // e.g. core metrics covering all of these frames
+    physiology::Face face;
+    for (int i_frame = 0; i_frame < 5; i_frame++) {
+        AddLandmarks(face, 10, 10, kStartUs + i_frame * kFrameIntervalUs);
+    }
+    // landmarks without a timestamp of their own go by that of the packet
+    AddLandmarks(face, 10, 10);
+    REQUIRE(frame_map.MapLandmarks(face, kStartUs + 3 * kFrameIntervalUs));
+    RequirePoint(face, 0, 10, 10);
+    RequirePoint(face, 1, 10, 10);
+    RequirePoint(face, 2, 810, 250);
+    RequirePoint(face, 3, 810, 250);
+    RequirePoint(face, 4, 10, 10);
+    RequirePoint(face, 5, 810, 250);
+}
+
+TEST_CASE("IngestedFrameMap leaves landmarks of unknown frames as they are") {
+    container::IngestedFrameMap frame_map;
+    physiology::Face face;
+    AddLandmarks(face, 10, 10, kFrameIntervalUs);
+    REQUIRE(!frame_map.MapLandmarks(face, kFrameIntervalUs));
+    RequirePoint(face, 0, 10, 10);
+
+    frame_map.RecordIngestedFrame(2 * kFrameIntervalUs, kCrop, kCrop.size());
+    AddLandmarks(face, 10, 10, 2 * kFrameIntervalUs);
+    // detected before the first frame on record
+    REQUIRE(!frame_map.MapLandmarks(face, 2 * kFrameIntervalUs));
+    RequirePoint(face, 0, 10, 10);
+    RequirePoint(face, 1, 810, 250);
+}
@@ -0,0 +1,91 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <string>
+#include <vector>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/opencv_imgproc_inc.h>
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/video_source/input_transformer.hpp>
+#include <smartspectra/video_source/input_transform_kernels.hpp>
+
+namespace vs = presage::smartspectra::video_source;
+
+namespace {
+
+const std::vector<vs::InputTransformMode> kInputTransformModes = {
+    vs::InputTransformMode::None,
+    vs::InputTransformMode::Clockwise90,
+    vs::InputTransformMode::Counterclockwise90,
+    vs::InputTransformMode::Rotate180,
+    vs::InputTransformMode::MirrorHorizontal,
+    vs::InputTransformMode::MirrorVertical
+};
+
+// odd and tiny sizes exercise the scalar tails of the vector kernels, larger ones span several rotation tiles
+const std::vector<cv::Size> kFrameSizes = {
+    {1, 1}, {7, 1}, {1, 7}, {5, 3}, {4, 4}, {8, 8}, {11, 8}, {16, 9}, {33, 17}, {64, 31}, {129, 65}, {67, 130}
+};
+
+cv::Mat MakeRandomFrame(const cv::Size& size) {
+    cv::Mat frame(size, CV_8UC3);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+    return frame;
+}
+
+} // anonymous namespace
+
+TEST_CASE("TransformAndSwizzleFrame matches cv::rotate/cv::flip + cv::cvtColor") {
+    for (const auto& frame_size: kFrameSizes) {
+        // exercise row strides that differ from the row width, on both ends
+        cv::Mat padded_source = MakeRandomFrame({frame_size.width + 5, frame_size.height});
+        cv::Mat source = padded_source(cv::Rect(2, 0, frame_size.width, frame_size.height));
+        for (vs::InputTransformMode mode: kInputTransformModes) {
+            cv::Mat expected = vs::InputTransformer{mode}.apply(source);
+            cv::Mat expected_swapped;
+            cv::cvtColor(expected, expected_swapped, cv::COLOR_BGR2RGB);
+            const cv::Size transformed_size = vs::GetTransformedFrameSize(frame_size, mode);
+            REQUIRE(transformed_size == expected.size());
+            for (vs::KernelInstructionSet instruction_set: vs::GetSupportedKernelInstructionSets()) {
+                for (bool swap_red_and_blue: {false, true}) {
+                    INFO("size: " << frame_size.width << "x" << frame_size.height
+                                  << ", mode: " << vs::AbslUnparseFlag(mode)
+                                  << ", instruction set: " << vs::AbslUnparseFlag(instruction_set)
+                                  << ", swap: " << swap_red_and_blue);
+                    cv::Mat padded_destination(transformed_size.height, transformed_size.width + 3, CV_8UC3,
+                                               cv::Scalar::all(0xAB));
+                    cv::Mat destination = padded_destination(cv::Rect(0, 0, transformed_size.width,
+                                                                      transformed_size.height));
+                    REQUIRE(vs::TransformAndSwizzleFrame(source, mode, swap_red_and_blue, destination,
+                                                         instruction_set).ok());
+                    const cv::Mat& reference = swap_red_and_blue ? expected_swapped : expected;
+                    REQUIRE(cv::countNonZero(destination.reshape(1) != reference.reshape(1)) == 0);
+                    // nothing gets written past the end of the destination rows
+                    cv::Mat padding = padded_destination(cv::Rect(transformed_size.width, 0, 3,
+                                                                  transformed_size.height));
+                    REQUIRE(cv::countNonZero(padding.reshape(1) != 0xAB) == 0);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("TransformAndSwizzleFrame rejects invalid frames") {
+    cv::Mat source = MakeRandomFrame({8, 4});
+    cv::Mat destination(4, 8, CV_8UC3);
+    CHECK(vs::TransformAndSwizzleFrame(source, vs::InputTransformMode::None, true, destination).ok());
+    // size of a 90-degree rotation doesn't match
+    CHECK_FALSE(vs::TransformAndSwizzleFrame(source, vs::InputTransformMode::Clockwise90, true, destination).ok());
+    // wrong type
+    cv::Mat grayscale(4, 8, CV_8UC1);
+    CHECK_FALSE(vs::TransformAndSwizzleFrame(grayscale, vs::InputTransformMode::None, true, destination).ok());
+    // empty source
+    CHECK_FALSE(vs::TransformAndSwizzleFrame(cv::Mat(), vs::InputTransformMode::None, true, destination).ok());
+    // in place
+    CHECK_FALSE(vs::TransformAndSwizzleFrame(source, vs::InputTransformMode::MirrorHorizontal, true, source).ok());
+}
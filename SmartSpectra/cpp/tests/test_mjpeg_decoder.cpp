@@ -0,0 +1,47 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/video_source/camera/mjpeg_decoder.hpp>
+
+namespace mjpeg = presage::smartspectra::video_source::mjpeg;
+
+TEST_CASE("SelectScaleDenominator decodes at full size without a target") {
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, -1, -1) == 1);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 0, 0) == 1);
+    // both target dimensions are needed
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 100, -1) == 1);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(-1, -1, 100, 100) == 1);
+}
+
+TEST_CASE("SelectScaleDenominator picks the smallest decoded size that covers the target") {
+    // a 256x256 graph input: 640x360 covers it, 320x180 doesn't
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 256, 256) == 2);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 320, 180) == 4);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 160, 90) == 4);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 640, 360) == 2);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 641, 360) == 1);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 1280, 720) == 1);
+    // a target larger than the capture size can't be covered at any scale
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1280, 720, 1920, 1080) == 1);
+    // orientation matters, i.e. a target for rotated frames needs to be rotated back to the capture orientation
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1920, 1080, 270, 480) == 2);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1920, 1080, 480, 270) == 4);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1920, 1080, 481, 270) == 2);
+}
+
+TEST_CASE("SelectScaleDenominator rounds decoded dimensions up") {
+    // 1/4 of 1281x721 decodes to 321x181
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1281, 721, 321, 181) == 4);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1281, 721, 322, 181) == 2);
+    // 1/2 of 1281x721 decodes to 641x361
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1281, 721, 641, 361) == 2);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(1281, 721, 641, 362) == 1);
+    REQUIRE(mjpeg::MjpegDecoder::SelectScaleDenominator(3, 3, 1, 1) == 4);
+}
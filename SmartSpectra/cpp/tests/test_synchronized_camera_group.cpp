@@ -0,0 +1,438 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <linux/videodev2.h>
+#include <sys/mman.h>
+// === third-party includes (if any) ===
+#include <mediapipe/framework/port/opencv_imgcodecs_inc.h>
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/video_source/camera/synchronized_camera_group.hpp>
+
+namespace vs = presage::smartspectra::video_source;
+namespace pcam = presage::camera;
+
+namespace {
+
+constexpr int kFrameWidth = 64;
+constexpr int kFrameHeight = 48;
+constexpr int kBufferCount = 3;
+constexpr int64_t kFirstTimestampUs = 1000000;
+constexpr int64_t kFrameIntervalUs = 33333;
+constexpr int64_t kSyncToleranceUs = 10000;
+constexpr uint8_t kJpegGrayLevel = 128;
+// spacing of buffer offsets, as handed out through QUERYBUF and back through Mmap
+constexpr off_t kBufferOffsetStride = 1 << 20;
+constexpr off_t kCameraOffsetStride = kBufferCount * kBufferOffsetStride;
+
+/**
+ * In-memory stand-in for several V4L2 capture devices (/dev/video0, /dev/video1, ...) that tick along on a shared
+ * clock. Each camera gets its frames at its own offset from the others; WaitForFrames flags the cameras whose next
+ * frame is due first, the way poll(2) would on physical cameras running at the same rate, and never flags a camera that
+ * has stalled (without erroring out) after a given number of frames. Cameras asked for UYVY
+ * deliver YUYV, cameras asked for MJPEG deliver the same uniformly gray JPEG image over and over.
+ */
+class FakeMultiCameraDevice : public vs::v4l2::V4l2DeviceInterface {
+public:
+    FakeMultiCameraDevice() {
+        cv::Mat gray_image(kFrameHeight, kFrameWidth, CV_8UC3, cv::Scalar::all(kJpegGrayLevel));
+        cv::imencode(".jpg", gray_image, this->jpeg_image);
+    }
+
+    int Open(const std::string& device_path, int) override {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        const int device_index = std::stoi(device_path.substr(std::string("/dev/video").size()));
+        if (this->device_indices_failing_to_open.count(device_index) > 0) {
+            errno = ENOENT;
+            return -1;
+        }
+        const int file_descriptor = this->next_file_descriptor++;
+        Camera& camera = this->cameras[file_descriptor];
+        camera.timestamp_us = kFirstTimestampUs + this->timestamp_offsets_us[device_index];
+        camera.frames_to_skip_every = this->frames_to_skip_every[device_index];
+        if (this->frames_before_stalling.count(device_index) > 0) {
+            camera.frames_before_stalling = this->frames_before_stalling[device_index];
+        }
+        return file_descriptor;
+    }
+
+    int Close(int) override {
+        return 0;
+    }
+
+    int Ioctl(int file_descriptor, unsigned long request, void* argument) override {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        Camera& camera = this->cameras[file_descriptor];
+        switch (request) {
+            case VIDIOC_QUERYCAP: {
+                auto* capability = static_cast<v4l2_capability*>(argument);
+                capability->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+                return 0;
+            }
+            case VIDIOC_S_FMT: {
+                auto* format = static_cast<v4l2_format*>(argument);
+                if (format->fmt.pix.pixelformat != V4L2_PIX_FMT_MJPEG) {
+                    format->fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+                }
+                format->fmt.pix.width = kFrameWidth;
+                format->fmt.pix.height = kFrameHeight;
+                format->fmt.pix.bytesperline = format->fmt.pix.pixelformat == V4L2_PIX_FMT_YUYV ? kFrameWidth * 2 : 0;
+                camera.pixel_format = format->fmt.pix.pixelformat;
+                return 0;
+            }
+            case VIDIOC_S_PARM:
+                return 0;
+            case VIDIOC_REQBUFS: {
+                auto* buffer_request = static_cast<v4l2_requestbuffers*>(argument);
+                if (buffer_request->count == 0) {
+                    camera.buffer_memory.clear();
+                    return 0;
+                }
+                buffer_request->count = kBufferCount;
+                camera.buffer_memory.assign(
+                    kBufferCount,
+                    std::vector<uint8_t>(std::max<size_t>(kFrameWidth * kFrameHeight * 2, this->jpeg_image.size()))
+                );
+                return 0;
+            }
+            case VIDIOC_QUERYBUF: {
+                auto* buffer = static_cast<v4l2_buffer*>(argument);
+                buffer->length = camera.buffer_memory[buffer->index].size();
+                buffer->m.offset = file_descriptor * kCameraOffsetStride + buffer->index * kBufferOffsetStride;
+                return 0;
+            }
+            case VIDIOC_QBUF: {
+                auto* buffer = static_cast<v4l2_buffer*>(argument);
+                camera.queued_buffers.push_back(buffer->index);
+                return 0;
+            }
+            case VIDIOC_STREAMON:
+            case VIDIOC_STREAMOFF:
+                return 0;
+            case VIDIOC_DQBUF: {
+                if (camera.queued_buffers.empty()) {
+                    errno = EAGAIN;
+                    return -1;
+                }
+                auto* buffer = static_cast<v4l2_buffer*>(argument);
+                buffer->index = camera.queued_buffers.front();
+                camera.queued_buffers.pop_front();
+                camera.sequence_number++;
+                camera.timestamp_us += kFrameIntervalUs;
+                if (camera.frames_to_skip_every > 0 && camera.sequence_number % camera.frames_to_skip_every == 0) {
+                    // the frame got lost before it made it into a buffer
+                    camera.sequence_number++;
+                    camera.timestamp_us += kFrameIntervalUs;
+                }
+                buffer->sequence = camera.sequence_number;
+                buffer->timestamp.tv_sec = camera.timestamp_us / 1000000;
+                buffer->timestamp.tv_usec = camera.timestamp_us % 1000000;
+                buffer->flags = 0;
+                std::vector<uint8_t>& memory = camera.buffer_memory[buffer->index];
+                if (camera.pixel_format == V4L2_PIX_FMT_MJPEG) {
+                    std::copy(this->jpeg_image.begin(), this->jpeg_image.end(), memory.begin());
+                    buffer->bytesused = this->jpeg_image.size();
+                } else {
+                    std::fill(memory.begin(), memory.end(), static_cast<uint8_t>(camera.sequence_number));
+                    buffer->bytesused = kFrameWidth * kFrameHeight * 2;
+                }
+                return 0;
+            }
+            default:
+                // no DMABUF export, no exposure controls
+                errno = ENOTTY;
+                return -1;
+        }
+    }
+
+    void* Mmap(size_t, int, int, int, off_t offset) override {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        Camera& camera = this->cameras[static_cast<int>(offset / kCameraOffsetStride)];
+        return camera.buffer_memory[(offset % kCameraOffsetStride) / kBufferOffsetStride].data();
+    }
+
+    int Munmap(void*, size_t) override {
+        return 0;
+    }
+
+    int WaitForFrame(int, int) override {
+        return 1;
+    }
+
+    int WaitForFrames(std::vector<struct pollfd>& poll_descriptors, int) override {
+        // don't let the capture thread spin flat out
+        std::this_thread::sleep_for(std::chrono::microseconds(300));
+        std::lock_guard<std::mutex> lock(this->mutex);
+        int64_t earliest_due_timestamp_us = std::numeric_limits<int64_t>::max();
+        for (const auto& poll_descriptor: poll_descriptors) {
+            const Camera& camera = this->cameras[poll_descriptor.fd];
+            if (camera.IsStalled()) {
+                continue;
+            }
+            earliest_due_timestamp_us = std::min(earliest_due_timestamp_us, camera.timestamp_us + kFrameIntervalUs);
+        }
+        int ready_count = 0;
+        for (auto& poll_descriptor: poll_descriptors) {
+            const Camera& camera = this->cameras[poll_descriptor.fd];
+            const bool ready = !camera.IsStalled() && !camera.queued_buffers.empty() &&
+                               camera.timestamp_us + kFrameIntervalUs <= earliest_due_timestamp_us + 1000;
+            poll_descriptor.revents = ready ? POLLIN : 0;
+            ready_count += ready;
+        }
+        return ready_count;
+    }
+
+    // set before the group gets initialized
+    std::map<int, int64_t> timestamp_offsets_us;
+    std::map<int, uint32_t> frames_to_skip_every;
+    std::set<int> device_indices_failing_to_open;
+    std::map<int, uint32_t> frames_before_stalling;
+
+private:
+    struct Camera {
+        std::vector<std::vector<uint8_t>> buffer_memory;
+        std::deque<uint32_t> queued_buffers;
+        uint32_t pixel_format = 0;
+        uint32_t sequence_number = 0;
+        int64_t timestamp_us = 0;
+        uint32_t frames_to_skip_every = 0;
+        uint32_t frames_before_stalling = std::numeric_limits<uint32_t>::max();
+
+        bool IsStalled() const {
+            return this->sequence_number >= this->frames_before_stalling;
+        }
+    };
+
+    std::mutex mutex;
+    std::vector<uint8_t> jpeg_image;
+    std::map<int, Camera> cameras;
+    int next_file_descriptor = 40;
+};
+
+vs::VideoSourceSettings MakeCameraSettings(int device_index, pcam::CaptureCodec codec = pcam::CaptureCodec::UYVY) {
+    vs::VideoSourceSettings settings;
+    settings.device_index = device_index;
+    settings.resolution_selection_mode = vs::ResolutionSelectionMode::Exact;
+    settings.capture_width_px = kFrameWidth;
+    settings.capture_height_px = kFrameHeight;
+    settings.codec = codec;
+    return settings;
+}
+
+vs::v4l2::SynchronizedCameraGroupSettings MakeGroupSettings(
+    int camera_count,
+    pcam::CaptureCodec codec = pcam::CaptureCodec::UYVY
+) {
+    vs::v4l2::SynchronizedCameraGroupSettings settings;
+    for (int i_camera = 0; i_camera < camera_count; i_camera++) {
+        settings.camera_settings.push_back(MakeCameraSettings(i_camera, codec));
+    }
+    settings.sync_tolerance_us = kSyncToleranceUs;
+    settings.stream_queue_capacity = 4;
+    return settings;
+}
+
+std::vector<std::unique_ptr<vs::VideoSource>> TakeAllStreams(vs::v4l2::SynchronizedCameraGroup& group) {
+    std::vector<std::unique_ptr<vs::VideoSource>> streams;
+    for (int i_camera = 0; i_camera < group.GetCameraCount(); i_camera++) {
+        auto stream = group.TakeStream(i_camera);
+        REQUIRE(stream.ok());
+        streams.push_back(std::move(stream).value());
+    }
+    return streams;
+}
+
+/** Read the given number of frames from each stream, each on its own thread, and return their timestamps. */
+std::vector<std::vector<int64_t>> ReadFrameTimestamps(
+    std::vector<std::unique_ptr<vs::VideoSource>>& streams,
+    int frame_count,
+    std::vector<cv::Mat>* last_frames = nullptr
+) {
+    std::vector<std::vector<int64_t>> timestamps(streams.size());
+    std::vector<cv::Mat> frames(streams.size());
+    std::vector<std::thread> consumers;
+    for (size_t i_stream = 0; i_stream < streams.size(); i_stream++) {
+        consumers.emplace_back([&, i_stream] {
+            for (int i_frame = 0; i_frame < frame_count; i_frame++) {
+                *streams[i_stream] >> frames[i_stream];
+                if (frames[i_stream].empty()) {
+                    return;
+                }
+                timestamps[i_stream].push_back(streams[i_stream]->GetFrameTimestamp());
+            }
+        });
+    }
+    for (auto& consumer: consumers) {
+        consumer.join();
+    }
+    if (last_frames != nullptr) {
+        *last_frames = frames;
+    }
+    return timestamps;
+}
+
+void RequireSynchronized(const std::vector<std::vector<int64_t>>& timestamps, int frame_count) {
+    for (size_t i_stream = 0; i_stream < timestamps.size(); i_stream++) {
+        INFO("stream " << i_stream);
+        REQUIRE(timestamps[i_stream].size() == static_cast<size_t>(frame_count));
+    }
+    for (int i_frame = 0; i_frame < frame_count; i_frame++) {
+        INFO("frame " << i_frame);
+        for (size_t i_stream = 1; i_stream < timestamps.size(); i_stream++) {
+            REQUIRE(std::llabs(timestamps[i_stream][i_frame] - timestamps[0][i_frame]) <= kSyncToleranceUs);
+        }
+        if (i_frame > 0) {
+            REQUIRE(timestamps[0][i_frame] > timestamps[0][i_frame - 1]);
+        }
+    }
+}
+
+} // anonymous namespace
+
+TEST_CASE("SynchronizedCameraGroup streams frames matched by timestamp across cameras") {
+    auto device = std::make_shared<FakeMultiCameraDevice>();
+    device->timestamp_offsets_us = {{0, 0}, {1, 3000}, {2, -2000}};
+    vs::v4l2::SynchronizedCameraGroup group(device);
+    REQUIRE(group.Initialize(MakeGroupSettings(3)).ok());
+    REQUIRE(group.GetCameraCount() == 3);
+    auto streams = TakeAllStreams(group);
+    REQUIRE(streams[0]->GetWidth() == kFrameWidth);
+    REQUIRE(streams[0]->GetHeight() == kFrameHeight);
+
+    // streams can only be taken once
+    REQUIRE(absl::IsFailedPrecondition(group.TakeStream(1).status()));
+    REQUIRE(absl::IsOutOfRange(group.TakeStream(3).status()));
+
+    RequireSynchronized(ReadFrameTimestamps(streams, 30), 30);
+    REQUIRE(group.GetUnmatchedFrameCount() == 0);
+    group.Stop();
+}
+
+TEST_CASE("SynchronizedCameraGroup drops frames without counterparts in the other cameras") {
+    auto device = std::make_shared<FakeMultiCameraDevice>();
+    // camera 1 loses every 5th frame
+    device->frames_to_skip_every = {{1, 5}};
+    vs::v4l2::SynchronizedCameraGroup group(device);
+    REQUIRE(group.Initialize(MakeGroupSettings(2)).ok());
+    auto streams = TakeAllStreams(group);
+
+    RequireSynchronized(ReadFrameTimestamps(streams, 30), 30);
+    REQUIRE(group.GetUnmatchedFrameCount() > 0);
+    group.Stop();
+}
+
+TEST_CASE("SynchronizedCameraGroup leaves MJPEG decoding to the consumers of the streams") {
+    auto device = std::make_shared<FakeMultiCameraDevice>();
+    device->timestamp_offsets_us = {{1, 2000}};
+    vs::v4l2::SynchronizedCameraGroupSettings settings = MakeGroupSettings(2, pcam::CaptureCodec::MJPG);
+    // decoded at half size
+    for (auto& camera_settings: settings.camera_settings) {
+        camera_settings.decode_target_width_px = kFrameWidth / 2;
+        camera_settings.decode_target_height_px = kFrameHeight / 2;
+    }
+    vs::v4l2::SynchronizedCameraGroup group(device);
+    REQUIRE(group.Initialize(settings).ok());
+    auto streams = TakeAllStreams(group);
+    REQUIRE(streams[0]->GetWidth() == kFrameWidth / 2);
+
+    std::vector<cv::Mat> last_frames;
+    RequireSynchronized(ReadFrameTimestamps(streams, 20, &last_frames), 20);
+    for (const cv::Mat& frame: last_frames) {
+        REQUIRE(frame.size() == cv::Size(kFrameWidth / 2, kFrameHeight / 2));
+        REQUIRE(frame.type() == CV_8UC3);
+        REQUIRE(std::abs(static_cast<int>(frame.ptr<uint8_t>(0)[0]) - kJpegGrayLevel) <= 2);
+    }
+
+    SECTION("in the output pixel format picked by the consumer") {
+        REQUIRE(streams[1]->SetOutputPixelFormat(vs::PixelFormat::RGB).ok());
+        RequireSynchronized(ReadFrameTimestamps(streams, 5, &last_frames), 5);
+        REQUIRE(last_frames[1].size() == cv::Size(kFrameWidth / 2, kFrameHeight / 2));
+    }
+    SECTION("without holding up the other streams while a consumer doesn't read") {
+        std::vector<std::unique_ptr<vs::VideoSource>> first_stream;
+        first_stream.push_back(std::move(streams[0]));
+        const std::vector<std::vector<int64_t>> timestamps = ReadFrameTimestamps(first_stream, 20);
+        REQUIRE(timestamps[0].size() == 20);
+    }
+    group.Stop();
+}
+
+TEST_CASE("SynchronizedCameraGroup can be initialized only once") {
+    auto device = std::make_shared<FakeMultiCameraDevice>();
+    vs::v4l2::SynchronizedCameraGroup group(device);
+
+    REQUIRE(absl::IsInvalidArgument(group.Initialize(vs::v4l2::SynchronizedCameraGroupSettings())));
+    vs::v4l2::SynchronizedCameraGroupSettings duplicate_camera_settings = MakeGroupSettings(2);
+    duplicate_camera_settings.camera_settings[1].device_index = 0;
+    REQUIRE(absl::IsInvalidArgument(group.Initialize(duplicate_camera_settings)));
+
+    // a camera failing to open leaves the group as it was, so initialization can be retried
+    device->device_indices_failing_to_open = {1};
+    REQUIRE(absl::IsNotFound(group.Initialize(MakeGroupSettings(2))));
+    REQUIRE(group.GetCameraCount() == 0);
+    device->device_indices_failing_to_open.clear();
+    REQUIRE(group.Initialize(MakeGroupSettings(2)).ok());
+    auto streams = TakeAllStreams(group);
+
+    // streams refer to the cameras of the first initialization, which have to stay
+    REQUIRE(absl::IsFailedPrecondition(group.Initialize(MakeGroupSettings(3))));
+    REQUIRE(group.GetCameraCount() == 2);
+    RequireSynchronized(ReadFrameTimestamps(streams, 5), 5);
+    group.Stop();
+}
+
+TEST_CASE("SynchronizedCameraGroup gives up once a single camera goes silent") {
+    auto device = std::make_shared<FakeMultiCameraDevice>();
+    // camera 1 stops delivering frames without erroring out, camera 0 keeps going
+    device->frames_before_stalling = {{1, 5}};
+    vs::v4l2::SynchronizedCameraGroup group(device);
+    REQUIRE(group.Initialize(MakeGroupSettings(2)).ok());
+    auto streams = TakeAllStreams(group);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const std::vector<std::vector<int64_t>> timestamps = ReadFrameTimestamps(streams, 100);
+    const auto elapsed_time = std::chrono::steady_clock::now() - start_time;
+    // the streams end after the frames matched before the stall, rather than waiting for camera 1 forever
+    REQUIRE(timestamps[0].size() == 5);
+    REQUIRE(timestamps[1].size() == 5);
+    REQUIRE(group.GetUnmatchedFrameCount() > 0);
+    REQUIRE(elapsed_time < std::chrono::seconds(30));
+    group.Stop();
+}
+
+TEST_CASE("SynchronizedCameraGroup streams end once capture stops") {
+    auto device = std::make_shared<FakeMultiCameraDevice>();
+    vs::v4l2::SynchronizedCameraGroup group(device);
+    REQUIRE(group.Initialize(MakeGroupSettings(2)).ok());
+    auto streams = TakeAllStreams(group);
+    RequireSynchronized(ReadFrameTimestamps(streams, 5), 5);
+
+    group.Stop();
+    // frames already synchronized still come through, then the streams end
+    cv::Mat frame;
+    for (int i_frame = 0; i_frame <= 4; i_frame++) {
+        *streams[0] >> frame;
+        if (frame.empty()) {
+            break;
+        }
+    }
+    REQUIRE(frame.empty());
+}
@@ -0,0 +1,309 @@
+//
+// Created by greg on 10/16/26.
+// Copyright (c) 2026 Presage Technologies
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// === standard library includes (if any) ===
+#include <cerrno>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <linux/videodev2.h>
+#include <sys/mman.h>
+// === third-party includes (if any) ===
+// === local includes (if any) ===
+#include "test_main.hpp"
+#include <smartspectra/video_source/camera/v4l2_streaming_source.hpp>
+
+namespace vs = presage::smartspectra::video_source;
+namespace pcam = presage::camera;
+
+namespace {
+
+constexpr int kFakeFileDescriptor = 42;
+constexpr int kFrameWidth = 8;
+constexpr int kFrameHeight = 4;
+constexpr int64_t kFirstTimestampUs = 1000000;
+constexpr int64_t kFrameIntervalUs = 33333;
+
+/**
+ * In-memory stand-in for a V4L2 capture device that always negotiates small YUYV frames. Every dequeued buffer gets
+ * filled with its sequence number, so that frames can be traced back to the buffer they came from.
+ */
+class FakeV4l2Device : public vs::v4l2::V4l2DeviceInterface {
+public:
+    int Open(const std::string&, int) override {
+        if (this->fail_open) {
+            errno = ENOENT;
+            return -1;
+        }
+        this->open_file_descriptor_count++;
+        return kFakeFileDescriptor;
+    }
+
+    int Close(int) override {
+        this->open_file_descriptor_count--;
+        return 0;
+    }
+
+    int Ioctl(int, unsigned long request, void* argument) override {
+        switch (request) {
+            case VIDIOC_QUERYCAP: {
+                auto* capability = static_cast<v4l2_capability*>(argument);
+                capability->capabilities = V4L2_CAP_VIDEO_CAPTURE | V4L2_CAP_STREAMING;
+                return 0;
+            }
+            case VIDIOC_S_FMT: {
+                auto* format = static_cast<v4l2_format*>(argument);
+                format->fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;
+                format->fmt.pix.width = kFrameWidth;
+                format->fmt.pix.height = kFrameHeight;
+                format->fmt.pix.bytesperline = kFrameWidth * 2;
+                return 0;
+            }
+            case VIDIOC_S_PARM:
+                return 0;
+            case VIDIOC_REQBUFS: {
+                auto* buffer_request = static_cast<v4l2_requestbuffers*>(argument);
+                if (buffer_request->memory != V4L2_MEMORY_MMAP) {
+                    errno = EINVAL;
+                    return -1;
+                }
+                if (buffer_request->count == 0) {
+                    this->buffer_memory.clear();
+                    return 0;
+                }
+                this->requested_buffer_count = static_cast<int>(buffer_request->count);
+                buffer_request->count = 3;
+                this->buffer_memory.assign(
+                    buffer_request->count, std::vector<uint8_t>(kFrameWidth * kFrameHeight * 2, 0)
+                );
+                return 0;
+            }
+            case VIDIOC_QUERYBUF: {
+                auto* buffer = static_cast<v4l2_buffer*>(argument);
+                buffer->length = this->buffer_memory[buffer->index].size();
+                buffer->m.offset = buffer->index * 4096;
+                return 0;
+            }
+            case VIDIOC_QBUF: {
+                auto* buffer = static_cast<v4l2_buffer*>(argument);
+                if (buffer->index >= this->buffer_memory.size()) {
+                    errno = EINVAL;
+                    return -1;
+                }
+                this->queued_buffers.push_back(buffer->index);
+                this->queued_buffer_count++;
+                return 0;
+            }
+            case VIDIOC_STREAMON:
+                this->streaming = true;
+                return 0;
+            case VIDIOC_STREAMOFF:
+                this->streaming = false;
+                return 0;
+            case VIDIOC_DQBUF: {
+                if (this->dequeue_errno != 0) {
+                    errno = this->dequeue_errno;
+                    return -1;
+                }
+                if (this->queued_buffers.empty()) {
+                    errno = EAGAIN;
+                    return -1;
+                }
+                auto* buffer = static_cast<v4l2_buffer*>(argument);
+                buffer->index = this->queued_buffers.front();
+                this->queued_buffers.pop_front();
+                this->sequence_number += 1 + this->sequence_numbers_to_skip;
+                this->sequence_numbers_to_skip = 0;
+                this->timestamp_us += kFrameIntervalUs;
+                buffer->sequence = this->sequence_number;
+                buffer->timestamp.tv_sec = this->timestamp_us / 1000000;
+                buffer->timestamp.tv_usec = this->timestamp_us % 1000000;
+                buffer->bytesused = this->buffer_memory[buffer->index].size();
+                buffer->flags = this->flag_next_frame_corrupted ? V4L2_BUF_FLAG_ERROR : 0;
+                this->flag_next_frame_corrupted = false;
+                std::fill(
+                    this->buffer_memory[buffer->index].begin(), this->buffer_memory[buffer->index].end(),
+                    static_cast<uint8_t>(this->sequence_number)
+                );
+                return 0;
+            }
+            default:
+                // no DMABUF export, no exposure controls
+                errno = ENOTTY;
+                return -1;
+        }
+    }
+
+    void* Mmap(size_t, int, int, int, off_t offset) override {
+        this->mapped_buffer_count++;
+        return this->buffer_memory[offset / 4096].data();
+    }
+
+    int Munmap(void*, size_t) override {
+        this->mapped_buffer_count--;
+        return 0;
+    }
+
+    int WaitForFrame(int, int) override {
+        if (this->stalled) {
+            // as poll(2) does when the timeout expires
+            return 0;
+        }
+        return this->queued_buffers.empty() ? 0 : 1;
+    }
+
+    int WaitForFrames(std::vector<struct pollfd>& poll_descriptors, int timeout_ms) override {
+        int ready_count = 0;
+        for (auto& poll_descriptor: poll_descriptors) {
+            poll_descriptor.revents = this->WaitForFrame(poll_descriptor.fd, timeout_ms) > 0 ? POLLIN : 0;
+            ready_count += poll_descriptor.revents != 0;
+        }
+        return ready_count;
+    }
+
+    std::vector<std::vector<uint8_t>> buffer_memory;
+    std::deque<uint32_t> queued_buffers;
+    int requested_buffer_count = 0;
+    int queued_buffer_count = 0;
+    int mapped_buffer_count = 0;
+    int open_file_descriptor_count = 0;
+    bool streaming = false;
+    uint32_t sequence_number = 0;
+    int64_t timestamp_us = kFirstTimestampUs;
+
+    // knobs for the failure paths
+    bool fail_open = false;
+    bool stalled = false;
+    int dequeue_errno = 0;
+    uint32_t sequence_numbers_to_skip = 0;
+    bool flag_next_frame_corrupted = false;
+};
+
+vs::VideoSourceSettings MakeSettings() {
+    vs::VideoSourceSettings settings;
+    settings.resolution_selection_mode = vs::ResolutionSelectionMode::Exact;
+    settings.capture_width_px = kFrameWidth;
+    settings.capture_height_px = kFrameHeight;
+    settings.codec = pcam::CaptureCodec::UYVY;
+    return settings;
+}
+
+} // anonymous namespace
+
+TEST_CASE("V4l2StreamingCameraSource cycles driver buffers through REQBUFS/QBUF/DQBUF") {
+    auto device = std::make_shared<FakeV4l2Device>();
+    {
+        vs::v4l2::V4l2StreamingCameraSource source(device);
+        REQUIRE(source.Initialize(MakeSettings()).ok());
+        REQUIRE(device->streaming);
+        REQUIRE(device->requested_buffer_count > 0);
+        // every buffer the driver granted is mapped & queued before streaming starts
+        REQUIRE(device->mapped_buffer_count == 3);
+        REQUIRE(device->queued_buffers.size() == 3);
+        REQUIRE(source.GetWidth() == kFrameWidth);
+        REQUIRE(source.GetHeight() == kFrameHeight);
+        REQUIRE(source.GetFrameDmaBufFileDescriptor() == -1);
+        // pass the raw YUYV data through, so that frame contents can be traced back to the buffer
+        REQUIRE(source.SetOutputPixelFormat(vs::PixelFormat::YUYV).ok());
+
+        cv::Mat frame;
+        // several times around the buffer ring
+        for (int i_frame = 0; i_frame < 10; i_frame++) {
+            INFO("frame " << i_frame);
+            source.ReadPreTransformFrame(frame);
+            REQUIRE(!frame.empty());
+            REQUIRE(frame.cols == kFrameWidth);
+            REQUIRE(frame.rows == kFrameHeight);
+            REQUIRE(frame.type() == CV_8UC2);
+            REQUIRE(frame.ptr<uint8_t>(kFrameHeight - 1)[2 * kFrameWidth - 1] == static_cast<uint8_t>(i_frame + 1));
+            // the frame is copied out, and the buffer goes straight back to the driver
+            REQUIRE(device->queued_buffers.size() == 3);
+        }
+        REQUIRE(device->queued_buffer_count == 13);
+    }
+    // all buffers released on destruction
+    REQUIRE(!device->streaming);
+    REQUIRE(device->mapped_buffer_count == 0);
+    REQUIRE(device->buffer_memory.empty());
+    REQUIRE(device->open_file_descriptor_count == 0);
+}
+
+TEST_CASE("V4l2StreamingCameraSource carries driver timestamps & sequence numbers over to frames") {
+    auto device = std::make_shared<FakeV4l2Device>();
+    vs::v4l2::V4l2StreamingCameraSource source(device);
+    REQUIRE(source.Initialize(MakeSettings()).ok());
+    REQUIRE(source.SupportsExactFrameTimestamp());
+
+    cv::Mat frame;
+    source.ReadPreTransformFrame(frame);
+    REQUIRE(!frame.empty());
+    REQUIRE(source.GetFrameSequenceNumber() == 1);
+    REQUIRE(source.GetFrameTimestamp() == kFirstTimestampUs + kFrameIntervalUs);
+    REQUIRE(source.GetDroppedFrameCount() == 0);
+
+    source.ReadPreTransformFrame(frame);
+    REQUIRE(source.GetFrameSequenceNumber() == 2);
+    REQUIRE(source.GetFrameTimestamp() == kFirstTimestampUs + 2 * kFrameIntervalUs);
+
+    // the driver skipping sequence numbers means it dropped frames
+    device->sequence_numbers_to_skip = 3;
+    source.ReadPreTransformFrame(frame);
+    REQUIRE(!frame.empty());
+    REQUIRE(source.GetFrameSequenceNumber() == 6);
+    REQUIRE(source.GetFrameTimestamp() == kFirstTimestampUs + 3 * kFrameIntervalUs);
+    REQUIRE(source.GetDroppedFrameCount() == 3);
+}
+
+TEST_CASE("V4l2StreamingCameraSource skips frames the driver flags as corrupted") {
+    auto device = std::make_shared<FakeV4l2Device>();
+    vs::v4l2::V4l2StreamingCameraSource source(device);
+    REQUIRE(source.Initialize(MakeSettings()).ok());
+
+    device->flag_next_frame_corrupted = true;
+    cv::Mat frame;
+    source.ReadPreTransformFrame(frame);
+    REQUIRE(!frame.empty());
+    REQUIRE(source.GetFrameSequenceNumber() == 2);
+    // the corrupted frame's buffer went back to the driver as well
+    REQUIRE(device->queued_buffers.size() == 3);
+}
+
+TEST_CASE("V4l2StreamingCameraSource ends the stream when the driver times out or fails") {
+    SECTION("timeout") {
+        auto device = std::make_shared<FakeV4l2Device>();
+        vs::v4l2::V4l2StreamingCameraSource source(device);
+        REQUIRE(source.Initialize(MakeSettings()).ok());
+        cv::Mat frame;
+        source.ReadPreTransformFrame(frame);
+        REQUIRE(!frame.empty());
+        device->stalled = true;
+        source.ReadPreTransformFrame(frame);
+        REQUIRE(frame.empty());
+    }
+    SECTION("dequeue error") {
+        auto device = std::make_shared<FakeV4l2Device>();
+        vs::v4l2::V4l2StreamingCameraSource source(device);
+        REQUIRE(source.Initialize(MakeSettings()).ok());
+        device->dequeue_errno = EIO;
+        cv::Mat frame;
+        source.ReadPreTransformFrame(frame);
+        REQUIRE(frame.empty());
+    }
+    SECTION("device missing") {
+        auto device = std::make_shared<FakeV4l2Device>();
+        device->fail_open = true;
+        vs::v4l2::V4l2StreamingCameraSource source(device);
+        absl::Status status = source.Initialize(MakeSettings());
+        REQUIRE(absl::IsNotFound(status));
+        REQUIRE(source.GetFileDescriptor() == -1);
+        cv::Mat frame;
+        source.ReadPreTransformFrame(frame);
+        REQUIRE(frame.empty());
+    }
+}